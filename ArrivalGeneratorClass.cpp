@@ -0,0 +1,370 @@
+#include "ArrivalGeneratorClass.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ARRIVAL_HAVE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+//Largest low counter word a vectorized refill can start from: the
+//kernels add the block number to the low word only, so a refill that
+//would carry into the high word is left to the scalar code
+const unsigned int ARRIVAL_MAX_VECTOR_COUNTER =
+                   0xFFFFFFFFu - ARRIVAL_NUM_PHILOX_BLOCKS;
+
+//Turns a standard normal value into an inter-arrival time exactly the way
+//RandomGeneratorClass::getPositiveNormal does.
+static inline int getPositiveInterval(const double meanVal,
+                                      const double stdDev, const double x) {
+    double newNormal = meanVal + stdDev * x;
+    if (newNormal < 0) {
+        newNormal *= - 1;
+    }
+    return ((int)newNormal);
+}
+
+//Fills words with the output of ARRIVAL_NUM_PHILOX_BLOCKS Philox blocks
+//starting at the given counter, word w of block b going to
+//words[w * ARRIVAL_NUM_PHILOX_BLOCKS + b].
+static void makeWordsScalar(const unsigned int key[],
+                            const unsigned int startCounter[],
+                            const unsigned int substreamId,
+                            unsigned int words[]) {
+    unsigned int counter[PHILOX_BLOCK_SIZE];
+    unsigned int block[PHILOX_BLOCK_SIZE];
+
+    counter[0] = startCounter[0];
+    counter[1] = startCounter[1];
+    counter[2] = substreamId;
+    counter[3] = 0;
+    for (int blockNum = 0; blockNum < ARRIVAL_NUM_PHILOX_BLOCKS; blockNum++) {
+        RandomGeneratorClass::computePhiloxBlock(counter, key, block);
+        for (int wordNum = 0; wordNum < PHILOX_BLOCK_SIZE; wordNum++) {
+            words[wordNum * ARRIVAL_NUM_PHILOX_BLOCKS + blockNum] =
+                                                            block[wordNum];
+        }
+        counter[0]++;
+        if (counter[0] == 0) {
+            counter[1]++;
+        }
+    }
+}
+
+#ifdef ARRIVAL_HAVE_X86_KERNELS
+
+//Multiplies each 32-bit lane of a by the same lane of multiplier, giving
+//the high and low words of the 64-bit products.
+__attribute__((target("sse2")))
+static inline void multiplyHighLowSse2(const __m128i a,
+                                       const __m128i multiplier,
+                                       __m128i &high, __m128i &low) {
+    const __m128i EVEN_LANES = _mm_set_epi32(0, -1, 0, -1);
+    __m128i evenProducts = _mm_mul_epu32(a, multiplier);
+    __m128i oddProducts = _mm_mul_epu32(_mm_srli_epi64(a, 32), multiplier);
+
+    low = _mm_or_si128(_mm_and_si128(evenProducts, EVEN_LANES),
+                       _mm_slli_epi64(oddProducts, 32));
+    high = _mm_or_si128(_mm_srli_epi64(evenProducts, 32),
+                        _mm_andnot_si128(EVEN_LANES, oddProducts));
+}
+
+//makeWordsScalar, running four Philox blocks at a time in SSE2 lanes.
+//The start counter's low word must be at most ARRIVAL_MAX_VECTOR_COUNTER.
+__attribute__((target("sse2")))
+static void makeWordsSse2(const unsigned int key[],
+                          const unsigned int startCounter[],
+                          const unsigned int substreamId,
+                          unsigned int words[]) {
+    const __m128i MULTIPLIER_0 = _mm_set1_epi32((int)PHILOX_MULTIPLIER_0);
+    const __m128i MULTIPLIER_1 = _mm_set1_epi32((int)PHILOX_MULTIPLIER_1);
+    const __m128i KEY_BUMP_0 = _mm_set1_epi32((int)PHILOX_KEY_BUMP_0);
+    const __m128i KEY_BUMP_1 = _mm_set1_epi32((int)PHILOX_KEY_BUMP_1);
+    const __m128i LANE_NUMS = _mm_set_epi32(3, 2, 1, 0);
+    const int NUM_LANES = 4;
+    __m128i high0, low0, high1, low1;
+
+    for (int blockNum = 0; blockNum < ARRIVAL_NUM_PHILOX_BLOCKS;
+         blockNum += NUM_LANES) {
+        __m128i counter0 = _mm_add_epi32(
+                    _mm_set1_epi32((int)(startCounter[0] + blockNum)),
+                    LANE_NUMS);
+        __m128i counter1 = _mm_set1_epi32((int)startCounter[1]);
+        __m128i counter2 = _mm_set1_epi32((int)substreamId);
+        __m128i counter3 = _mm_setzero_si128();
+        __m128i key0 = _mm_set1_epi32((int)key[0]);
+        __m128i key1 = _mm_set1_epi32((int)key[1]);
+
+        for (int round = 0; round < PHILOX_NUM_ROUNDS; round++) {
+            multiplyHighLowSse2(counter0, MULTIPLIER_0, high0, low0);
+            multiplyHighLowSse2(counter2, MULTIPLIER_1, high1, low1);
+            counter0 = _mm_xor_si128(_mm_xor_si128(high1, counter1), key0);
+            counter1 = low1;
+            counter2 = _mm_xor_si128(_mm_xor_si128(high0, counter3), key1);
+            counter3 = low0;
+            key0 = _mm_add_epi32(key0, KEY_BUMP_0);
+            key1 = _mm_add_epi32(key1, KEY_BUMP_1);
+        }
+        _mm_storeu_si128((__m128i *)&words[blockNum], counter0);
+        _mm_storeu_si128(
+              (__m128i *)&words[ARRIVAL_NUM_PHILOX_BLOCKS + blockNum],
+              counter1);
+        _mm_storeu_si128(
+              (__m128i *)&words[2 * ARRIVAL_NUM_PHILOX_BLOCKS + blockNum],
+              counter2);
+        _mm_storeu_si128(
+              (__m128i *)&words[3 * ARRIVAL_NUM_PHILOX_BLOCKS + blockNum],
+              counter3);
+    }
+}
+
+//multiplyHighLowSse2 on eight AVX2 lanes.
+__attribute__((target("avx2")))
+static inline void multiplyHighLowAvx2(const __m256i a,
+                                       const __m256i multiplier,
+                                       __m256i &high, __m256i &low) {
+    __m256i evenProducts = _mm256_mul_epu32(a, multiplier);
+    __m256i oddProducts = _mm256_mul_epu32(_mm256_srli_epi64(a, 32),
+                                           multiplier);
+
+    low = _mm256_blend_epi32(evenProducts, _mm256_slli_epi64(oddProducts, 32),
+                             0xAA);
+    high = _mm256_blend_epi32(_mm256_srli_epi64(evenProducts, 32),
+                              oddProducts, 0xAA);
+}
+
+//makeWordsScalar, running eight Philox blocks at a time in AVX2 lanes.
+//The start counter's low word must be at most ARRIVAL_MAX_VECTOR_COUNTER.
+__attribute__((target("avx2")))
+static void makeWordsAvx2(const unsigned int key[],
+                          const unsigned int startCounter[],
+                          const unsigned int substreamId,
+                          unsigned int words[]) {
+    const __m256i MULTIPLIER_0 = _mm256_set1_epi32((int)PHILOX_MULTIPLIER_0);
+    const __m256i MULTIPLIER_1 = _mm256_set1_epi32((int)PHILOX_MULTIPLIER_1);
+    const __m256i KEY_BUMP_0 = _mm256_set1_epi32((int)PHILOX_KEY_BUMP_0);
+    const __m256i KEY_BUMP_1 = _mm256_set1_epi32((int)PHILOX_KEY_BUMP_1);
+    const __m256i LANE_NUMS = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const int NUM_LANES = 8;
+    __m256i high0, low0, high1, low1;
+
+    for (int blockNum = 0; blockNum < ARRIVAL_NUM_PHILOX_BLOCKS;
+         blockNum += NUM_LANES) {
+        __m256i counter0 = _mm256_add_epi32(
+                    _mm256_set1_epi32((int)(startCounter[0] + blockNum)),
+                    LANE_NUMS);
+        __m256i counter1 = _mm256_set1_epi32((int)startCounter[1]);
+        __m256i counter2 = _mm256_set1_epi32((int)substreamId);
+        __m256i counter3 = _mm256_setzero_si256();
+        __m256i key0 = _mm256_set1_epi32((int)key[0]);
+        __m256i key1 = _mm256_set1_epi32((int)key[1]);
+
+        for (int round = 0; round < PHILOX_NUM_ROUNDS; round++) {
+            multiplyHighLowAvx2(counter0, MULTIPLIER_0, high0, low0);
+            multiplyHighLowAvx2(counter2, MULTIPLIER_1, high1, low1);
+            counter0 = _mm256_xor_si256(_mm256_xor_si256(high1, counter1),
+                                        key0);
+            counter1 = low1;
+            counter2 = _mm256_xor_si256(_mm256_xor_si256(high0, counter3),
+                                        key1);
+            counter3 = low0;
+            key0 = _mm256_add_epi32(key0, KEY_BUMP_0);
+            key1 = _mm256_add_epi32(key1, KEY_BUMP_1);
+        }
+        _mm256_storeu_si256((__m256i *)&words[blockNum], counter0);
+        _mm256_storeu_si256(
+              (__m256i *)&words[ARRIVAL_NUM_PHILOX_BLOCKS + blockNum],
+              counter1);
+        _mm256_storeu_si256(
+              (__m256i *)&words[2 * ARRIVAL_NUM_PHILOX_BLOCKS + blockNum],
+              counter2);
+        _mm256_storeu_si256(
+              (__m256i *)&words[3 * ARRIVAL_NUM_PHILOX_BLOCKS + blockNum],
+              counter3);
+    }
+}
+
+//Converts eight words at a time to inter-arrival times with the
+//ziggurat's quick test, and returns a bit mask of the words (lowest bit
+//first) of each group of eight that failed it.  The times of failed words
+//are left for the caller to fill in.
+__attribute__((target("avx2")))
+static void convertWordsAvx2(const unsigned int words[], const double meanVal,
+                             const double stdDev, int intervals[],
+                             unsigned char rejectMasks[]) {
+    const __m256i LAYER_MASK = _mm256_set1_epi32(ZIGGURAT_NUM_LAYERS - 1);
+    const __m256i POSITION_MASK = _mm256_set1_epi32(~(ZIGGURAT_NUM_LAYERS - 1));
+    const __m256i UNSIGNED_BIAS = _mm256_set1_epi32((int)0x80000000u);
+    const __m256d MEAN = _mm256_set1_pd(meanVal);
+    const __m256d STD_DEV = _mm256_set1_pd(stdDev);
+    const __m256d SIGN_BIT = _mm256_set1_pd(-0.0);
+    const __m256d ALL_LANES = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+    const int NUM_LANES = 8;
+
+    for (int wordIdx = 0; wordIdx < ARRIVAL_BUFFER_SIZE;
+         wordIdx += NUM_LANES) {
+        __m256i word = _mm256_loadu_si256((const __m256i *)&words[wordIdx]);
+        __m256i layerIdx = _mm256_and_si256(word, LAYER_MASK);
+        __m256i signedPos = _mm256_and_si256(word, POSITION_MASK);
+        __m256i absPos = _mm256_abs_epi32(signedPos);
+        __m256i limit = _mm256_i32gather_epi32(
+                            (const int *)ZIGGURAT_TABLES.limits, layerIdx, 4);
+        //The magnitudes are unsigned, so compare with the sign bit flipped
+        __m256i isAccepted = _mm256_cmpgt_epi32(
+                                 _mm256_xor_si256(limit, UNSIGNED_BIAS),
+                                 _mm256_xor_si256(absPos, UNSIGNED_BIAS));
+        rejectMasks[wordIdx / NUM_LANES] = (unsigned char)~_mm256_movemask_ps(
+                                         _mm256_castsi256_ps(isAccepted));
+
+        for (int half = 0; half < 2; half++) {
+            __m128i halfPos = half ? _mm256_extracti128_si256(signedPos, 1) :
+                                     _mm256_castsi256_si128(signedPos);
+            __m128i halfLayer = half ? _mm256_extracti128_si256(layerIdx, 1) :
+                                       _mm256_castsi256_si128(layerIdx);
+            //(The masked gather, with every lane enabled, avoids a
+            //spurious uninitialized-value warning from some compilers)
+            __m256d width = _mm256_mask_i32gather_pd(_mm256_setzero_pd(),
+                                ZIGGURAT_TABLES.widths, halfLayer,
+                                ALL_LANES, 8);
+            __m256d x = _mm256_mul_pd(_mm256_cvtepi32_pd(halfPos), width);
+            __m256d newNormal = _mm256_add_pd(MEAN, _mm256_mul_pd(STD_DEV, x));
+            newNormal = _mm256_andnot_pd(SIGN_BIT, newNormal);
+            _mm_storeu_si128((__m128i *)&intervals[wordIdx + 4 * half],
+                             _mm256_cvttpd_epi32(newNormal));
+        }
+    }
+}
+
+#endif // ARRIVAL_HAVE_X86_KERNELS
+
+ArrivalGeneratorClass::ArrivalGeneratorClass() {
+    kernelType = getBestKernel();
+    setup(1, 0, 0, 0, 0);
+}
+
+void ArrivalGeneratorClass::setup(const int seedVal,
+                                  const unsigned int streamId,
+                                  const unsigned int inSubstreamId,
+                                  const double inMeanVal,
+                                  const double inStdDev,
+                                  const bool isAntithetic) {
+    philoxKey[0] = (unsigned int)seedVal;
+    philoxKey[1] = streamId;
+    substreamId = inSubstreamId;
+    blockCounter[0] = 0;
+    blockCounter[1] = 0;
+    meanVal = inMeanVal;
+    //Every kernel turns a normal value x into meanVal + stdDev * x, so a
+    //negated standard deviation gives the time -x would have
+    stdDev = isAntithetic ? -inStdDev : inStdDev;
+    slowPathGenerator.setSeed(seedVal);
+    slowPathGenerator.setMode(RANDOM_MODE_PHILOX);
+    slowPathGenerator.setStream(streamId, substreamId + 1);
+    nextIdx = ARRIVAL_BUFFER_SIZE;
+}
+
+bool ArrivalGeneratorClass::setKernel(const int inKernelType) {
+    if (!getIsKernelSupported(inKernelType)) {
+        return false;
+    }
+    kernelType = inKernelType;
+    return true;
+}
+
+void ArrivalGeneratorClass::refill() {
+    unsigned int words[ARRIVAL_BUFFER_SIZE];
+    bool canVectorize = (blockCounter[0] <= ARRIVAL_MAX_VECTOR_COUNTER);
+    bool isConverted = false;
+
+#ifdef ARRIVAL_HAVE_X86_KERNELS
+    if (canVectorize && kernelType == ARRIVAL_KERNEL_AVX2) {
+        const int NUM_LANES = 8;
+        unsigned char rejectMasks[ARRIVAL_BUFFER_SIZE / NUM_LANES];
+
+        makeWordsAvx2(philoxKey, blockCounter, substreamId, words);
+        convertWordsAvx2(words, meanVal, stdDev, intervals, rejectMasks);
+        //Finish the rejected draws in order, so the slow path generator is
+        //used the same way the scalar code uses it
+        for (int groupIdx = 0; groupIdx < ARRIVAL_BUFFER_SIZE / NUM_LANES;
+             groupIdx++) {
+            for (int lane = 0; rejectMasks[groupIdx] >> lane; lane++) {
+                if ((rejectMasks[groupIdx] >> lane) & 1) {
+                    int wordIdx = groupIdx * NUM_LANES + lane;
+                    intervals[wordIdx] = getPositiveInterval(meanVal, stdDev,
+                        slowPathGenerator.getStandardNormalFrom(
+                                                        words[wordIdx]));
+                }
+            }
+        }
+        isConverted = true;
+    }
+    else if (canVectorize && kernelType == ARRIVAL_KERNEL_SSE2) {
+        makeWordsSse2(philoxKey, blockCounter, substreamId, words);
+    }
+    else {
+        makeWordsScalar(philoxKey, blockCounter, substreamId, words);
+    }
+#else
+    (void)canVectorize;
+    makeWordsScalar(philoxKey, blockCounter, substreamId, words);
+#endif
+
+    if (!isConverted) {
+        for (int wordIdx = 0; wordIdx < ARRIVAL_BUFFER_SIZE; wordIdx++) {
+            unsigned int word = words[wordIdx];
+            int layerIdx = (int)(word & (ZIGGURAT_NUM_LAYERS - 1));
+            int signedPos = (int)(word &
+                                  ~(unsigned int)(ZIGGURAT_NUM_LAYERS - 1));
+            unsigned int absPos = (signedPos < 0) ?
+                                  -(unsigned int)signedPos :
+                                  (unsigned int)signedPos;
+            double x;
+            if (absPos < ZIGGURAT_TABLES.limits[layerIdx]) {
+                x = signedPos * ZIGGURAT_TABLES.widths[layerIdx];
+            }
+            else {
+                x = slowPathGenerator.getStandardNormalFrom(word);
+            }
+            intervals[wordIdx] = getPositiveInterval(meanVal, stdDev, x);
+        }
+    }
+
+    blockCounter[0] += ARRIVAL_NUM_PHILOX_BLOCKS;
+    if (blockCounter[0] < ARRIVAL_NUM_PHILOX_BLOCKS) {
+        blockCounter[1]++;
+    }
+    nextIdx = 0;
+}
+
+bool ArrivalGeneratorClass::getIsKernelSupported(const int kernelType) {
+    if (kernelType == ARRIVAL_KERNEL_SCALAR) {
+        return true;
+    }
+#ifdef ARRIVAL_HAVE_X86_KERNELS
+    if (kernelType == ARRIVAL_KERNEL_SSE2) {
+        return __builtin_cpu_supports("sse2");
+    }
+    if (kernelType == ARRIVAL_KERNEL_AVX2) {
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+    return false;
+}
+
+int ArrivalGeneratorClass::getBestKernel() {
+    if (getIsKernelSupported(ARRIVAL_KERNEL_AVX2)) {
+        return ARRIVAL_KERNEL_AVX2;
+    }
+    if (getIsKernelSupported(ARRIVAL_KERNEL_SSE2)) {
+        return ARRIVAL_KERNEL_SSE2;
+    }
+    return ARRIVAL_KERNEL_SCALAR;
+}
+
+const char* ArrivalGeneratorClass::getKernelName(const int kernelType) {
+    if (kernelType == ARRIVAL_KERNEL_AVX2) {
+        return "avx2";
+    }
+    if (kernelType == ARRIVAL_KERNEL_SSE2) {
+        return "sse2";
+    }
+    return "scalar";
+}
@@ -0,0 +1,88 @@
+#ifndef _ARRIVALGENERATORCLASS_H_
+#define _ARRIVALGENERATORCLASS_H_
+
+#include "RandomGeneratorClass.h"
+
+//Number of Philox blocks, and so of inter-arrival times, made per refill
+const int ARRIVAL_NUM_PHILOX_BLOCKS = 64;
+const int ARRIVAL_BUFFER_SIZE = ARRIVAL_NUM_PHILOX_BLOCKS * PHILOX_BLOCK_SIZE;
+
+//Ways a buffer of inter-arrival times can be filled: plain C++, SSE2 (4
+//Philox blocks at a time) or AVX2 (8 Philox blocks and 8 ziggurat tests at
+//a time).  All give exactly the same values.
+const int ARRIVAL_KERNEL_SCALAR = 0;
+const int ARRIVAL_KERNEL_SSE2 = 1;
+const int ARRIVAL_KERNEL_AVX2 = 2;
+
+//Purpose: Hands out the inter-arrival times of one approach from a buffer
+//         that is refilled a block at a time, so the cost of generating
+//         them is spread over many cars and the work vectorizes.
+//
+//         The times are positive, truncated normal values (like
+//         RandomGeneratorClass::getPositiveNormal) drawn by a ziggurat
+//         from their own Philox substream.  A refill encrypts the next 64
+//         counter values and uses the resulting 256 words, word w of
+//         block b being the (w * 64 + b)th time of the refill.  The few
+//         words that fail the ziggurat's quick test are finished from a
+//         second substream, so every kernel produces the same times, in
+//         the same order, for a given seed.
+class ArrivalGeneratorClass {
+    private:
+        unsigned int philoxKey[2]; //Seed and stream of the generator
+        unsigned int substreamId;  //Substream the words come from
+        unsigned int blockCounter[2]; //Index of the next Philox block,
+                                      //low word first
+        RandomGeneratorClass slowPathGenerator; //Finishes rejected draws
+        double meanVal; //Mean of the normal distribution of times
+        double stdDev;  //Standard deviation of that distribution (negated
+                        //for the antithetic sequence)
+        int kernelType; //ARRIVAL_KERNEL_* value used to refill
+        int intervals[ARRIVAL_BUFFER_SIZE]; //The current block of times
+        int nextIdx; //Index of the next unused time in intervals
+
+        //Makes the next ARRIVAL_BUFFER_SIZE times and advances the block
+        //counter.
+        void refill();
+
+    public:
+        //Default ctor - set up before use.
+        ArrivalGeneratorClass();
+
+        //Starts the sequence of times with the given distribution for the
+        //given seed, stream and substream.  Substreams substreamId and
+        //substreamId + 1 are both used.  If isAntithetic, each time is
+        //made from the negation -x of the normal value x it would
+        //otherwise use, the antithetic variate of the plain sequence.
+        void setup(const int seedVal, const unsigned int streamId,
+                   const unsigned int inSubstreamId, const double inMeanVal,
+                   const double inStdDev, const bool isAntithetic = false);
+
+        //Selects the kernel used for refills from now on (the best the
+        //processor supports by default).  Returns false, leaving the
+        //kernel as it was, if the processor doesn't support it.
+        bool setKernel(const int inKernelType);
+
+        //Returns the kernel used for refills.
+        int getKernel() const {
+            return kernelType;
+        }
+
+        //Returns the next inter-arrival time.
+        int getNextInterval() {
+            if (nextIdx == ARRIVAL_BUFFER_SIZE) {
+                refill();
+            }
+            return intervals[nextIdx++];
+        }
+
+        //Returns whether this processor can run the given kernel.
+        static bool getIsKernelSupported(const int kernelType);
+
+        //Returns the fastest kernel this processor can run.
+        static int getBestKernel();
+
+        //Returns the name of a kernel, e.g. for reports.
+        static const char* getKernelName(const int kernelType);
+};
+
+#endif // _ARRIVALGENERATORCLASS_H_
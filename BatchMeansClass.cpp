@@ -0,0 +1,211 @@
+#include "BatchMeansClass.h"
+#include "SnapshotFileClass.h"
+
+//Number of observations the values first have room for
+const int BATCH_MEANS_INITIAL_CAPACITY = 256;
+
+BatchMeansClass::BatchMeansClass() {
+    values = 0;
+    numSeries = 0;
+    numObservations = 0;
+    capacity = 0;
+}
+
+BatchMeansClass::BatchMeansClass(const BatchMeansClass &rhs) {
+    values = 0;
+    numSeries = 0;
+    numObservations = 0;
+    capacity = 0;
+
+    *this = rhs;
+}
+
+BatchMeansClass::~BatchMeansClass() {
+    delete [] values;
+}
+
+BatchMeansClass& BatchMeansClass::operator=(const BatchMeansClass &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    //keep the values when they have room for rhs's
+    if (numSeries != rhs.numSeries) {
+        setup(rhs.numSeries);
+    }
+    numObservations = 0;
+    reserveObservations(rhs.numObservations);
+    for (int valIdx = 0; valIdx < rhs.numObservations * numSeries;
+         valIdx++) {
+        values[valIdx] = rhs.values[valIdx];
+    }
+    numObservations = rhs.numObservations;
+    return *this;
+}
+
+void BatchMeansClass::reserveObservations(const int minNumObservations) {
+    if (minNumObservations <= capacity) {
+        return;
+    }
+
+    int newCapacity = (capacity > 0) ? capacity :
+                                       BATCH_MEANS_INITIAL_CAPACITY;
+    while (newCapacity < minNumObservations) {
+        newCapacity *= 2;
+    }
+    double *newValues = new double[newCapacity * numSeries];
+    for (int valIdx = 0; valIdx < numObservations * numSeries; valIdx++) {
+        newValues[valIdx] = values[valIdx];
+    }
+    delete [] values;
+    values = newValues;
+    capacity = newCapacity;
+}
+
+void BatchMeansClass::setup(const int inNumSeries) {
+    delete [] values;
+    values = 0;
+    capacity = 0;
+    numObservations = 0;
+    numSeries = inNumSeries;
+}
+
+void BatchMeansClass::addObservation(const double *seriesValues) {
+    reserveObservations(numObservations + 1);
+    for (int seriesIdx = 0; seriesIdx < numSeries; seriesIdx++) {
+        values[numObservations * numSeries + seriesIdx] =
+                                            seriesValues[seriesIdx];
+    }
+    numObservations++;
+}
+
+int BatchMeansClass::getWarmupLength(const int firstSeries,
+                                     const int numSummed) const {
+    int numGroups = numObservations / BATCH_MEANS_MSER_BATCH_SIZE;
+
+    if (numGroups < 2) {
+        return -1;
+    }
+
+    //The group means, summed over the series
+    double *groupMeans = new double[numGroups];
+    for (int groupIdx = 0; groupIdx < numGroups; groupIdx++) {
+        int firstObsIdx = groupIdx * BATCH_MEANS_MSER_BATCH_SIZE;
+        double groupSum = 0;
+        for (int obsIdx = firstObsIdx;
+             obsIdx < firstObsIdx + BATCH_MEANS_MSER_BATCH_SIZE; obsIdx++) {
+            for (int seriesIdx = firstSeries;
+                 seriesIdx < firstSeries + numSummed; seriesIdx++) {
+                groupSum += getValue(obsIdx, seriesIdx);
+            }
+        }
+        groupMeans[groupIdx] = groupSum / BATCH_MEANS_MSER_BATCH_SIZE;
+    }
+
+    //Working back from the end, the sums of the groups kept give each
+    //number dropped its statistic in O(1); at least two groups are kept
+    int bestNumDropped = numGroups - 2;
+    double bestStatistic = 0;
+    double keptSum = 0;
+    double keptSumSq = 0;
+    for (int numDropped = numGroups - 1; numDropped >= 0; numDropped--) {
+        double numKept = numGroups - numDropped;
+        keptSum += groupMeans[numDropped];
+        keptSumSq += groupMeans[numDropped] * groupMeans[numDropped];
+        if (numKept >= 2) {
+            double sumSqDeviations = keptSumSq - keptSum * keptSum / numKept;
+            double statistic = sumSqDeviations / (numKept * numKept);
+            if (numDropped == numGroups - 2 || statistic <= bestStatistic) {
+                bestStatistic = statistic;
+                bestNumDropped = numDropped;
+            }
+        }
+    }
+    delete [] groupMeans;
+
+    if (bestNumDropped > numGroups / 2) {
+        return -1;
+    }
+    return bestNumDropped * BATCH_MEANS_MSER_BATCH_SIZE;
+}
+
+void BatchMeansClass::getBatchMeans(
+                     const int seriesIdx, const int numBatches,
+                     const int batchSize,
+                     StatAccumulatorClass &outBatchMeans) const {
+    int firstObsIdx = numObservations - numBatches * batchSize;
+
+    outBatchMeans.clear();
+    for (int batchIdx = 0; batchIdx < numBatches; batchIdx++) {
+        double batchSum = 0;
+        for (int obsIdx = firstObsIdx + batchIdx * batchSize;
+             obsIdx < firstObsIdx + (batchIdx + 1) * batchSize; obsIdx++) {
+            batchSum += getValue(obsIdx, seriesIdx);
+        }
+        outBatchMeans.addValue(batchSum / batchSize);
+    }
+}
+
+double BatchMeansClass::getBatchMeansCorrelation(
+                       const int seriesIdx, const int numBatches,
+                       const int batchSize) const {
+    StatAccumulatorClass batchMeans;
+    int firstObsIdx = numObservations - numBatches * batchSize;
+    double prevDeviation = 0;
+    double sumProducts = 0;
+    double sumSquares = 0;
+
+    getBatchMeans(seriesIdx, numBatches, batchSize, batchMeans);
+    for (int batchIdx = 0; batchIdx < numBatches; batchIdx++) {
+        double batchSum = 0;
+        for (int obsIdx = firstObsIdx + batchIdx * batchSize;
+             obsIdx < firstObsIdx + (batchIdx + 1) * batchSize; obsIdx++) {
+            batchSum += getValue(obsIdx, seriesIdx);
+        }
+        double deviation = batchSum / batchSize - batchMeans.getMean();
+        if (batchIdx > 0) {
+            sumProducts += prevDeviation * deviation;
+        }
+        sumSquares += deviation * deviation;
+        prevDeviation = deviation;
+    }
+    if (sumSquares == 0) {
+        return 0;
+    }
+    return sumProducts / sumSquares;
+}
+
+void BatchMeansClass::writeSnapshot(SnapshotFileClass &snapshotFile) const {
+    snapshotFile.writeValue(numSeries);
+    snapshotFile.writeValue(numObservations);
+    if (numObservations > 0) {
+        snapshotFile.writeBytes(values,
+                                numObservations * numSeries * sizeof(double));
+    }
+}
+
+void BatchMeansClass::readSnapshot(SnapshotFileClass &snapshotFile) {
+    int snapshotNumSeries = 0;
+    int newNumObservations = 0;
+
+    snapshotFile.readValue(snapshotNumSeries);
+    snapshotFile.readValue(newNumObservations);
+    if (snapshotNumSeries != numSeries || newNumObservations < 0 ||
+        (numSeries == 0 && newNumObservations > 0)) {
+        snapshotFile.markFailed();
+    }
+
+    //Read an observation at a time, so a damaged count only takes as
+    //much memory as the file has observations
+    numObservations = 0;
+    while (numObservations < newNumObservations &&
+           !snapshotFile.getIsFailed()) {
+        reserveObservations(numObservations + 1);
+        snapshotFile.readBytes(&values[numObservations * numSeries],
+                               numSeries * sizeof(double));
+        numObservations++;
+    }
+    if (snapshotFile.getIsFailed()) {
+        numObservations = 0;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef _BATCHMEANSCLASS_H_
+#define _BATCHMEANSCLASS_H_
+
+#include "StatAccumulatorClass.h"
+
+//Number of observations MSER averages together before looking for the
+//end of the warm-up (the "5" of MSER-5)
+const int BATCH_MEANS_MSER_BATCH_SIZE = 5;
+
+class SnapshotFileClass;
+
+//Purpose: Keeps a sequence of observations of several series (such as
+//         the cars advanced and mean queue length per approach in each
+//         light cycle) from one long run, for steady-state estimates.
+//         The start of a run is biased by its empty initial state, so
+//         the number of observations to drop is found with MSER-5; the
+//         rest are split into equal batches whose means are close enough
+//         to independent for a confidence interval.  Every observation is
+//         kept, as both depend on all of them.
+class BatchMeansClass {
+    private:
+        double *values;      //Observations, one after the other, each
+                             //with a value for every series
+        int numSeries;       //Values per observation
+        int numObservations; //Observations added
+        int capacity;        //Observations the values have room for
+
+        //Grows the values to room for at least the given number of
+        //observations.
+        void reserveObservations(const int minNumObservations);
+
+    public:
+        //Default ctor - no series and no observations.
+        BatchMeansClass();
+
+        //Copy ctor - makes a complete (deep) copy of the observations.
+        BatchMeansClass(const BatchMeansClass &rhs);
+
+        //Frees the observations.
+        ~BatchMeansClass();
+
+        //Makes this a complete (deep) copy of another.
+        BatchMeansClass& operator=(const BatchMeansClass &rhs);
+
+        //Forgets all observations and starts over with the given number
+        //of series.
+        void setup(const int inNumSeries);
+
+        //Adds an observation, with one value per series.
+        void addObservation(const double *seriesValues);
+
+        //Returns the number of observations added.
+        int getNumObservations() const {
+            return numObservations;
+        }
+
+        //Returns the value of the given series in the given observation.
+        double getValue(const int obsIdx, const int seriesIdx) const {
+            return values[obsIdx * numSeries + seriesIdx];
+        }
+
+        //Returns the number of observations at the start that are warm-up,
+        //found by MSER-5 on the sum of numSummed series starting at
+        //firstSeries: the observations are averaged in groups of five, and
+        //the number dropped is the one leaving the rest with the smallest
+        //squared standard error of their mean.  Returns -1 if that is more
+        //than half of them, when the run is too short (or not settled
+        //enough) for the warm-up to be told apart from the rest.
+        int getWarmupLength(const int firstSeries, const int numSummed) const;
+
+        //Splits the numBatches * batchSize observations ending with the
+        //last one into numBatches batches, and adds the mean of each
+        //batch's values of the given series to outBatchMeans (which is
+        //cleared first).
+        void getBatchMeans(const int seriesIdx, const int numBatches,
+                           const int batchSize,
+                           StatAccumulatorClass &outBatchMeans) const;
+
+        //Returns the lag-1 autocorrelation of the batch means getBatchMeans
+        //gives, or 0 if they don't vary.  Batches too short to be close to
+        //independent show up as a clearly positive correlation.
+        double getBatchMeansCorrelation(const int seriesIdx,
+                                        const int numBatches,
+                                        const int batchSize) const;
+
+        //Writes the series and observations to a snapshot file.
+        void writeSnapshot(SnapshotFileClass &snapshotFile) const;
+
+        //Replaces the observations with those written by writeSnapshot,
+        //which must have the same number of series as this.  Leaves no
+        //observations if the file fails.
+        void readSnapshot(SnapshotFileClass &snapshotFile);
+};
+
+#endif // _BATCHMEANSCLASS_H_
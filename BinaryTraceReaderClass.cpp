@@ -0,0 +1,188 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+#include "BinaryTraceReaderClass.h"
+#include "EventClass.h"
+#include "constants.h"
+
+//Approach names as they appear in the text trace, indexed by direction
+//code: lower case mid-sentence, capitalized at the start of a line
+static const string BOUND_NAMES[NUM_DIRECTIONS] = {
+    "east-bound", "west-bound", "north-bound", "south-bound"
+};
+static const string CAPITAL_BOUND_NAMES[NUM_DIRECTIONS] = {
+    "East-bound", "West-bound", "North-bound", "South-bound"
+};
+static const string UNKNOWN_BOUND_NAME = "unknown-bound";
+
+//Returns the approach name for a direction code, capitalized or not.
+static const string& getBoundName(const unsigned char dirCode,
+                                  const bool isCapitalized) {
+    if (dirCode >= NUM_DIRECTIONS) {
+        return UNKNOWN_BOUND_NAME;
+    }
+    return isCapitalized ? CAPITAL_BOUND_NAMES[dirCode] :
+                           BOUND_NAMES[dirCode];
+}
+
+BinaryTraceReaderClass::BinaryTraceReaderClass() {
+    fileDescriptor = -1;
+    mappedData = 0;
+    mappedSize = 0;
+    records = 0;
+    numRecords = 0;
+}
+
+BinaryTraceReaderClass::~BinaryTraceReaderClass() {
+    close();
+}
+
+bool BinaryTraceReaderClass::open(const string &traceFname) {
+    struct stat fileInfo;
+    TraceFileHeaderStruct fileHeader;
+
+    close();
+    fileDescriptor = ::open(traceFname.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        cout << "ERROR: Unable to open trace file: " << traceFname << endl;
+        return false;
+    }
+    if (fstat(fileDescriptor, &fileInfo) != 0 ||
+        (size_t)fileInfo.st_size < sizeof(TraceFileHeaderStruct)) {
+        cout << "ERROR: Trace file is too short: " << traceFname << endl;
+        close();
+        return false;
+    }
+
+    mappedSize = (size_t)fileInfo.st_size;
+    mappedData = mmap(0, mappedSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    if (mappedData == MAP_FAILED) {
+        mappedData = 0;
+        cout << "ERROR: Unable to map trace file: " << traceFname << endl;
+        close();
+        return false;
+    }
+
+    memcpy(&fileHeader, mappedData, sizeof(fileHeader));
+    if (memcmp(fileHeader.magic, BINARY_TRACE_MAGIC,
+               sizeof(fileHeader.magic)) != 0 ||
+        fileHeader.byteOrderMark != BINARY_TRACE_BYTE_ORDER_MARK ||
+        fileHeader.version != BINARY_TRACE_VERSION ||
+        fileHeader.recordSize != sizeof(TraceRecordStruct)) {
+        cout << "ERROR: Not a version " << BINARY_TRACE_VERSION <<
+                " binary trace written on this kind of machine: " <<
+                traceFname << endl;
+        close();
+        return false;
+    }
+
+    //Records are a multiple of 4 bytes long and the header is 16 bytes,
+    //so the records in the (page aligned) mapping are properly aligned
+    records = (const TraceRecordStruct *)((const char *)mappedData +
+                                          sizeof(TraceFileHeaderStruct));
+    numRecords = (long)((mappedSize - sizeof(TraceFileHeaderStruct)) /
+                        sizeof(TraceRecordStruct));
+    return true;
+}
+
+void BinaryTraceReaderClass::close() {
+    if (mappedData != 0) {
+        munmap(mappedData, mappedSize);
+        mappedData = 0;
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+    mappedSize = 0;
+    records = 0;
+    numRecords = 0;
+}
+
+long BinaryTraceReaderClass::findFirstRecordAtTick(const int tick) const {
+    long lowIdx = 0;
+    long highIdx = numRecords;
+
+    while (lowIdx < highIdx) {
+        long midIdx = lowIdx + (highIdx - lowIdx) / 2;
+        if (records[midIdx].tick < tick) {
+            lowIdx = midIdx + 1;
+        }
+        else {
+            highIdx = midIdx;
+        }
+    }
+    return lowIdx;
+}
+
+void writeTraceRecordText(TraceWriterClass &traceWriter,
+                          const TraceRecordStruct &record) {
+    const string &boundName = getBoundName(record.dirCode, false);
+
+    if (record.recordType == TRACE_REC_SCHEDULE) {
+        traceWriter << "Time: " << record.tick << " Scheduled " <<
+                       EventClass(record.value, record.eventType) << '\n';
+    }
+    else if (record.recordType == TRACE_REC_HANDLE) {
+        traceWriter << "\nHandling " <<
+                       EventClass(record.tick, record.eventType) << '\n';
+        if (record.eventType == EVENT_CHANGE_YELLOW_EW) {
+            traceWriter << "Advancing cars on east-west green\n";
+        }
+        else if (record.eventType == EVENT_CHANGE_GREEN_NS) {
+            traceWriter << "Advancing cars on east-west yellow\n";
+        }
+        else if (record.eventType == EVENT_CHANGE_YELLOW_NS) {
+            traceWriter << "Advancing cars on north-south green\n";
+        }
+        else if (record.eventType == EVENT_CHANGE_GREEN_EW) {
+            traceWriter << "Advancing cars on north-south yellow\n";
+        }
+    }
+    else if (record.recordType == TRACE_REC_ARRIVE) {
+        traceWriter << "Time: " << record.tick << " Car #" << record.carId <<
+                       " arrives " << boundName << " - queue length: " <<
+                       record.queueLength << '\n';
+    }
+    else if (record.recordType == TRACE_REC_ADVANCE_GREEN) {
+        traceWriter << "  Car #" << record.carId << " advances " <<
+                       boundName << '\n';
+    }
+    else if (record.recordType == TRACE_REC_NO_CARS_YELLOW) {
+        traceWriter << "  No " << boundName <<
+                       " cars waiting to advance on yellow\n";
+    }
+    else if (record.recordType == TRACE_REC_ADVANCE_YELLOW) {
+        traceWriter << "  Next " << boundName <<
+                       " car will advance on yellow\n" <<
+                       "  Car#" << record.carId << " advances " <<
+                       boundName << '\n';
+    }
+    else if (record.recordType == TRACE_REC_STOP_YELLOW) {
+        traceWriter << "  Next " << boundName <<
+                       " car will NOT advance on yellow\n";
+    }
+    else if (record.recordType == TRACE_REC_SUMMARY_GREEN ||
+             record.recordType == TRACE_REC_SUMMARY_YELLOW) {
+        traceWriter << getBoundName(record.dirCode, true) <<
+                       " cars advanced on ";
+        if (record.recordType == TRACE_REC_SUMMARY_GREEN) {
+            traceWriter << "green: ";
+        }
+        else {
+            traceWriter << "yellow: ";
+        }
+        traceWriter << record.value << " Remaining queue: " <<
+                       record.queueLength << '\n';
+    }
+    else if (record.recordType == TRACE_REC_END) {
+        traceWriter << "\nNext event occurs AFTER the simulation end time (" <<
+                       EventClass(record.value, record.eventType) << ")!\n";
+    }
+}
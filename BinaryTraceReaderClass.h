@@ -0,0 +1,62 @@
+#ifndef _BINARYTRACEREADERCLASS_H_
+#define _BINARYTRACEREADERCLASS_H_
+
+#include <cstddef>
+#include <string>
+#include "BinaryTraceWriterClass.h"
+#include "TraceWriterClass.h"
+
+//Purpose: Gives read access to a binary trace file written by
+//         BinaryTraceWriterClass.  The file is memory-mapped rather than
+//         read in, so even a trace of a very long run can be opened
+//         instantly and its records visited in any order.
+class BinaryTraceReaderClass {
+    private:
+        int fileDescriptor;     //Descriptor of the open file, or -1
+        void *mappedData;       //Start of the mapped file, or 0
+        size_t mappedSize;      //Number of bytes mapped
+        const TraceRecordStruct *records; //First record in the mapping
+        long numRecords;        //Number of records in the file
+
+        //A reader owns its mapping, so it can't be copied.
+        BinaryTraceReaderClass(const BinaryTraceReaderClass &rhs);
+        BinaryTraceReaderClass& operator=(const BinaryTraceReaderClass &rhs);
+
+    public:
+        //Default ctor - makes a reader with no file open.
+        BinaryTraceReaderClass();
+
+        //Unmaps and closes the file, if one is open.
+        ~BinaryTraceReaderClass();
+
+        //Opens and maps the named trace file, closing any file that was
+        //already open. Prints an error message and returns false if the
+        //file can't be opened or isn't a binary trace this reader
+        //understands.
+        bool open(const std::string &traceFname);
+
+        //Unmaps and closes the file.
+        void close();
+
+        //Returns the number of records in the open file.
+        long getNumRecords() const {
+            return numRecords;
+        }
+
+        //Returns the record at the given index (0 is the first).
+        const TraceRecordStruct& getRecord(const long recordIdx) const {
+            return records[recordIdx];
+        }
+
+        //Returns the index of the first record stamped at or after the
+        //given tick, or getNumRecords() if there is none. Records are
+        //written in time order, so this is a binary search.
+        long findFirstRecordAtTick(const int tick) const;
+};
+
+//Writes the text trace lines that a record stands for, exactly as the
+//simulation prints them in its trace.
+void writeTraceRecordText(TraceWriterClass &traceWriter,
+                          const TraceRecordStruct &record);
+
+#endif // _BINARYTRACEREADERCLASS_H_
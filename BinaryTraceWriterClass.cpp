@@ -0,0 +1,113 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+using namespace std;
+
+#include "BinaryTraceWriterClass.h"
+
+//Number of records collected before they are written to the file
+const int TRACE_RECORD_BUFFER_SIZE = 4096;
+
+BinaryTraceWriterClass::BinaryTraceWriterClass() {
+    traceFile = 0;
+    records = 0;
+    numBuffered = 0;
+    isFailed = false;
+}
+
+BinaryTraceWriterClass::BinaryTraceWriterClass(
+                        const BinaryTraceWriterClass &) {
+    traceFile = 0;
+    records = 0;
+    numBuffered = 0;
+    isFailed = false;
+}
+
+BinaryTraceWriterClass::~BinaryTraceWriterClass() {
+    close();
+    delete [] records;
+}
+
+BinaryTraceWriterClass& BinaryTraceWriterClass::operator=(
+                        const BinaryTraceWriterClass &rhs) {
+    if (this != &rhs) {
+        close();
+    }
+    return *this;
+}
+
+bool BinaryTraceWriterClass::open(const string &traceFname) {
+    TraceFileHeaderStruct fileHeader;
+
+    close();
+    traceFile = fopen(traceFname.c_str(), "wb");
+    if (traceFile == 0) {
+        return false;
+    }
+    isFailed = false;
+    if (records == 0) {
+        records = new TraceRecordStruct[TRACE_RECORD_BUFFER_SIZE];
+    }
+
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    memcpy(fileHeader.magic, BINARY_TRACE_MAGIC, sizeof(fileHeader.magic));
+    fileHeader.version = BINARY_TRACE_VERSION;
+    fileHeader.recordSize = sizeof(TraceRecordStruct);
+    fileHeader.byteOrderMark = BINARY_TRACE_BYTE_ORDER_MARK;
+    if (fwrite(&fileHeader, sizeof(fileHeader), 1, traceFile) != 1) {
+        isFailed = true;
+    }
+    return true;
+}
+
+void BinaryTraceWriterClass::flush() {
+    if (numBuffered > 0) {
+        if (fwrite(records, sizeof(TraceRecordStruct), numBuffered,
+                   traceFile) != (size_t)numBuffered) {
+            isFailed = true;
+        }
+        numBuffered = 0;
+    }
+}
+
+bool BinaryTraceWriterClass::close() {
+    bool success = true;
+
+    if (traceFile != 0) {
+        flush();
+        if (fclose(traceFile) != 0) {
+            isFailed = true;
+        }
+        success = !isFailed;
+        traceFile = 0;
+        isFailed = false;
+    }
+    return success;
+}
+
+void BinaryTraceWriterClass::writeRecord(const int tick,
+                                         const unsigned char recordType,
+                                         const int eventType,
+                                         const unsigned char dirCode,
+                                         const int lightState,
+                                         const int carId,
+                                         const int queueLength,
+                                         const int value) {
+    if (traceFile == 0) {
+        return;
+    }
+    if (numBuffered == TRACE_RECORD_BUFFER_SIZE) {
+        flush();
+    }
+
+    TraceRecordStruct &newRecord = records[numBuffered];
+    newRecord.tick = tick;
+    newRecord.carId = carId;
+    newRecord.queueLength = queueLength;
+    newRecord.value = value;
+    newRecord.recordType = recordType;
+    newRecord.eventType = (signed char)eventType;
+    newRecord.dirCode = dirCode;
+    newRecord.lightState = (unsigned char)lightState;
+    numBuffered++;
+}
@@ -0,0 +1,101 @@
+#ifndef _BINARYTRACEWRITERCLASS_H_
+#define _BINARYTRACEWRITERCLASS_H_
+
+#include <cstdio>
+#include <string>
+
+//Kinds of binary trace record.  Each one stands for one piece of the
+//text trace, so the text can be regenerated from the records alone.
+const unsigned char TRACE_REC_SCHEDULE = 0;      //An event was scheduled
+const unsigned char TRACE_REC_HANDLE = 1;        //An event is being handled
+const unsigned char TRACE_REC_ARRIVE = 2;        //A car joined a queue
+const unsigned char TRACE_REC_ADVANCE_GREEN = 3; //A car advanced on green
+const unsigned char TRACE_REC_NO_CARS_YELLOW = 4;//No cars waited on yellow
+const unsigned char TRACE_REC_ADVANCE_YELLOW = 5;//A car advanced on yellow
+const unsigned char TRACE_REC_STOP_YELLOW = 6;   //A car stopped for yellow
+const unsigned char TRACE_REC_SUMMARY_GREEN = 7; //Cars advanced on a green
+const unsigned char TRACE_REC_SUMMARY_YELLOW = 8;//Cars advanced on a yellow
+const unsigned char TRACE_REC_END = 9;           //Next event is past the end
+const int NUM_TRACE_REC_TYPES = 10;
+
+//Identifies a binary trace file, and the version of its layout
+const char BINARY_TRACE_MAGIC[4] = { 'I', 'T', 'R', 'C' };
+const unsigned int BINARY_TRACE_VERSION = 1;
+//Written in the machine's byte order, so a reader can tell whether the
+//file came from a machine with the same byte order as its own
+const unsigned int BINARY_TRACE_BYTE_ORDER_MARK = 0x01020304;
+
+//The header at the start of every binary trace file.
+struct TraceFileHeaderStruct {
+    char magic[4];              //BINARY_TRACE_MAGIC
+    unsigned int version;       //BINARY_TRACE_VERSION
+    unsigned int recordSize;    //sizeof(TraceRecordStruct)
+    unsigned int byteOrderMark; //BINARY_TRACE_BYTE_ORDER_MARK
+};
+
+//One fixed-size (20 byte) binary trace record.  Fields that don't apply
+//to a kind of record hold 0 (or DIR_CODE_NOT_SET for the direction).
+struct TraceRecordStruct {
+    int tick;        //Simulation time when the record was written
+    int carId;       //Car that arrived or advanced
+    int queueLength; //Length of the queue concerned, after the change
+    int value;       //SCHEDULE and END: time of the event;
+                     //SUMMARY_*: number of cars that advanced
+    unsigned char recordType; //One of the TRACE_REC_* constants
+    signed char eventType;    //EVENT_* type of the event concerned
+    unsigned char dirCode;    //DIR_CODE_* of the approach concerned
+    unsigned char lightState; //LIGHT_* state of the light at the time
+};
+
+//Purpose: Writes binary trace records to a file.  Records are collected
+//         in a buffer and written out in large blocks.  A writer that
+//         has no file open ignores the records it is given.
+class BinaryTraceWriterClass {
+    private:
+        FILE *traceFile;            //File being written, or 0 if none
+        TraceRecordStruct *records; //Records not yet written to the file
+        int numBuffered;            //Number of records in the buffer
+        bool isFailed;              //Whether a write to the file failed
+
+        //Writes the buffered records to the file.
+        void flush();
+
+    public:
+        //Default ctor - makes a writer with no file open.
+        BinaryTraceWriterClass();
+
+        //Copy ctor - the copy has no file open; a trace file only ever
+        //has one writer.
+        BinaryTraceWriterClass(const BinaryTraceWriterClass &rhs);
+
+        //Closes the file, if one is open.
+        ~BinaryTraceWriterClass();
+
+        //Closes this writer's file, if any. The file rhs is writing is not
+        //shared.
+        BinaryTraceWriterClass& operator=(const BinaryTraceWriterClass &rhs);
+
+        //Creates (or truncates) the named file and writes the file header
+        //to it, closing any file that was already open. Returns false if
+        //the file couldn't be opened for writing.
+        bool open(const std::string &traceFname);
+
+        //Writes out any buffered records and closes the file.  Returns
+        //false if any part of the trace couldn't be written, including
+        //while closing, so the file is incomplete (true if no file was
+        //open).
+        bool close();
+
+        //Returns true if a file is open for writing.
+        bool getIsOpen() const {
+            return traceFile != 0;
+        }
+
+        //Adds one record to the trace.
+        void writeRecord(const int tick, const unsigned char recordType,
+                         const int eventType, const unsigned char dirCode,
+                         const int lightState, const int carId,
+                         const int queueLength, const int value);
+};
+
+#endif // _BINARYTRACEWRITERCLASS_H_
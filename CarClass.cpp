@@ -1,16 +1,45 @@
 #include "CarClass.h"
 
 #include <iostream>
+#include <string>
 using namespace std;
 
-//Assign the static attribute used for auto-assigning unique ids
-int CarClass::nextIdVal = 0;
+//Direction names indexed by direction code
+static const string DIRECTION_NAMES[NUM_DIRECTIONS] = {
+    EAST_DIRECTION, WEST_DIRECTION, NORTH_DIRECTION, SOUTH_DIRECTION
+};
+static const string UNKNOWN_DIRECTION_NAME = "";
+
+unsigned char getDirectionCode(const string &dirName) {
+    for (int i = 0; i < NUM_DIRECTIONS; i++) {
+        if (dirName == DIRECTION_NAMES[i]) {
+            return (unsigned char)i;
+        }
+    }
+    return DIR_CODE_NOT_SET;
+}
+
+const string& getDirectionName(const unsigned char dirCode) {
+    if (dirCode < NUM_DIRECTIONS) {
+        return DIRECTION_NAMES[dirCode];
+    }
+    return UNKNOWN_DIRECTION_NAME;
+}
 
 ostream& operator<<(ostream& outStream,const CarClass &carToPrint) {
     outStream << "Car id: " << carToPrint.uniqueId <<
-              " traveling: " << carToPrint.travelDir <<
+              " traveling: " << getDirectionName(carToPrint.travelDirCode) <<
               " arrived: " << carToPrint.arrivalTime;
 
     return outStream;
 }
 
+TraceWriterClass& operator<<(TraceWriterClass &traceWriter,
+                             const CarClass &carToPrint) {
+    traceWriter << "Car id: " << carToPrint.uniqueId <<
+                   " traveling: " <<
+                   getDirectionName(carToPrint.travelDirCode) <<
+                   " arrived: " << carToPrint.arrivalTime;
+
+    return traceWriter;
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include "constants.h"
+#include "TraceWriterClass.h"
 
 //Programmer: Andrew Morgan
 //Date: November 2020
@@ -13,21 +14,24 @@
 
 class CarClass {
     private:
-        static int nextIdVal; //Static attribute used to auto-assign unique ids
-        int uniqueId; //A unique identifier auto-assigned to each car
-        std::string travelDir; //Direction this car object is traveling
+        int uniqueId; //A unique identifier for each car, assigned by the
+                      //simulation the car belongs to
         int arrivalTime; //The time at which the car arrived at the intersection
+        unsigned char travelDirCode; //Direction this car object is
+                                     //traveling, as one of the DIR_CODE_*
+                                     //constants
 
     public:
-        //The primary ctor to be used when creating a new car. Will auto-assign
-        //a unique identifier and store the car's travel direction.
-        CarClass(const std::string inTravelDir,
+        //The primary ctor to be used when creating a car. The id is given by
+        //the caller (each simulation numbers its own cars), and the travel
+        //direction is one of the DIR_CODE_* constants.
+        CarClass(const int inUniqueId,
+                 const unsigned char inTravelDirCode,
                  const int inArrivalTime) {
-            uniqueId = nextIdVal;
-            nextIdVal++;
-
-            travelDir = inTravelDir;
-            arrivalTime = inArrivalTime;}
+            uniqueId = inUniqueId;
+            travelDirCode = inTravelDirCode;
+            arrivalTime = inArrivalTime;
+        }
 
       //An explicit default ctor that allows an "empty" car to be
       //created so that one can be declared in order to be passed
@@ -35,6 +39,8 @@ class CarClass {
       //the FIFOQueueClass::dequeue method).
       CarClass() {
           uniqueId = CAR_ID_NOT_SET;
+          arrivalTime = 0;
+          travelDirCode = DIR_CODE_NOT_SET;
       }
 
       //Simple getter for the car's unique id value attribute
@@ -42,15 +48,37 @@ class CarClass {
           return uniqueId;
       }
 
-      //Since this insertion operator really ought to be a method, but 
+      //Simple getter for the time the car arrived at the intersection
+      int getArrivalTime() const {
+          return arrivalTime;
+      }
+
+      //Simple getter for the car's travel direction, as a DIR_CODE_* value
+      unsigned char getTravelDirCode() const {
+          return travelDirCode;
+      }
+
+      //Since this insertion operator really ought to be a method, but
       //can't be due to the way C++ manages operator overloading, we
       //make it an "honorary method" by declaring it as a friend.
       friend std::ostream& operator<<(
                   std::ostream& outStream,
                   const CarClass &carToPrint
                   );
+      friend TraceWriterClass& operator<<(
+                  TraceWriterClass &traceWriter,
+                  const CarClass &carToPrint
+                  );
 };
 
+//Converts a direction string (EAST_DIRECTION, etc.) to its DIR_CODE_*
+//value, or DIR_CODE_NOT_SET if the string isn't a known direction.
+unsigned char getDirectionCode(const std::string &dirName);
+
+//Converts a DIR_CODE_* value back to its direction string; an unknown
+//code gives the empty string.
+const std::string& getDirectionName(const unsigned char dirCode);
+
 //An overloaded insertion operator to allow a car object to be printed
 //in a standard way...
 std::ostream& operator<<(
@@ -58,4 +86,11 @@ std::ostream& operator<<(
      const CarClass &carToPrint
      );
 
+//Writes a car to a trace writer, exactly as the insertion operator above
+//would print it.
+TraceWriterClass& operator<<(
+     TraceWriterClass &traceWriter,
+     const CarClass &carToPrint
+     );
+
 #endif // _CARCLASS_H_
@@ -0,0 +1,311 @@
+#include <iostream>
+using namespace std;
+
+#include "CarQueueClass.h"
+
+//Number of cars the buffers hold when they are first allocated
+const int CAR_QUEUE_INITIAL_CAPACITY = 16;
+
+void CarQueueClass::reallocate(const int newCapacity) {
+    int *newCarIds = 0;
+    int *newArrivalTimes = 0;
+    unsigned char *newTravelDirCodes = 0;
+
+    if (newCapacity > 0) {
+        newCarIds = new int[newCapacity];
+        newArrivalTimes = new int[newCapacity];
+        newTravelDirCodes = new unsigned char[newCapacity];
+    }
+    for (int i = 0; i < numElems; i++) {
+        int oldIdx = (headIdx + i) & (capacity - 1);
+        newCarIds[i] = carIds[oldIdx];
+        newArrivalTimes[i] = arrivalTimes[oldIdx];
+        newTravelDirCodes[i] = travelDirCodes[oldIdx];
+    }
+
+    delete [] carIds;
+    delete [] arrivalTimes;
+    delete [] travelDirCodes;
+    carIds = newCarIds;
+    arrivalTimes = newArrivalTimes;
+    travelDirCodes = newTravelDirCodes;
+    capacity = newCapacity;
+    headIdx = 0;
+}
+
+//Lets go of one queue's reference to a shared segment, freeing it if that
+//was the last.
+static void releaseSegment(CarQueueSegmentStruct *segment) {
+    if (__sync_sub_and_fetch(&segment->numRefs, 1) == 0) {
+        delete [] segment->carIds;
+        delete [] segment->arrivalTimes;
+        delete [] segment->travelDirCodes;
+        delete segment;
+    }
+}
+
+void CarQueueClass::dequeueShared(CarClass &outCar) {
+    CarQueueSegmentStruct *segment = sharedSegments[0];
+    int segmentIdx = (segment->headIdx + sharedHeadIdx) &
+                     (segment->capacity - 1);
+
+    outCar = CarClass(segment->carIds[segmentIdx],
+                      segment->travelDirCodes[segmentIdx],
+                      segment->arrivalTimes[segmentIdx]);
+    sharedHeadIdx++;
+    numSharedElems--;
+    if (sharedHeadIdx == segment->numCars) {
+        releaseSegment(segment);
+        numSharedSegments--;
+        for (int segmentIdx = 0; segmentIdx < numSharedSegments;
+             segmentIdx++) {
+            sharedSegments[segmentIdx] = sharedSegments[segmentIdx + 1];
+        }
+        sharedHeadIdx = 0;
+    }
+}
+
+void CarQueueClass::reserveSharedSegments(const int minNumSegments) {
+    if (minNumSegments <= sharedSegmentCapacity) {
+        return;
+    }
+
+    int newSegmentCapacity = (sharedSegmentCapacity > 0) ?
+                             sharedSegmentCapacity : 4;
+    while (newSegmentCapacity < minNumSegments) {
+        newSegmentCapacity *= 2;
+    }
+    CarQueueSegmentStruct **newSharedSegments =
+                          new CarQueueSegmentStruct*[newSegmentCapacity];
+    for (int segmentIdx = 0; segmentIdx < numSharedSegments; segmentIdx++) {
+        newSharedSegments[segmentIdx] = sharedSegments[segmentIdx];
+    }
+    delete [] sharedSegments;
+    sharedSegments = newSharedSegments;
+    sharedSegmentCapacity = newSegmentCapacity;
+}
+
+void CarQueueClass::takeSharedCars() {
+    int numOwnElems = numElems;
+    int numCars = numSharedElems + numOwnElems;
+    int newCapacity = (capacity > 0) ? capacity : CAR_QUEUE_INITIAL_CAPACITY;
+    CarClass nextCar;
+
+    while (newCapacity < numCars) {
+        newCapacity *= 2;
+    }
+
+    //Move the queue's own cars to the back of new buffers, then fill in
+    //the shared cars ahead of them
+    reallocate(newCapacity);
+    for (int i = numOwnElems - 1; i >= 0; i--) {
+        carIds[numSharedElems + i] = carIds[i];
+        arrivalTimes[numSharedElems + i] = arrivalTimes[i];
+        travelDirCodes[numSharedElems + i] = travelDirCodes[i];
+    }
+    numElems = 0;
+    for (int i = 0; numSharedElems > 0; i++) {
+        dequeueShared(nextCar);
+        carIds[i] = nextCar.getId();
+        arrivalTimes[i] = nextCar.getArrivalTime();
+        travelDirCodes[i] = nextCar.getTravelDirCode();
+    }
+    headIdx = 0;
+    numElems = numCars;
+}
+
+void CarQueueClass::releaseSharedSegments() {
+    for (int segmentIdx = 0; segmentIdx < numSharedSegments; segmentIdx++) {
+        releaseSegment(sharedSegments[segmentIdx]);
+    }
+    numSharedSegments = 0;
+    sharedHeadIdx = 0;
+    numSharedElems = 0;
+}
+
+CarQueueClass::CarQueueClass() {
+    carIds = 0;
+    arrivalTimes = 0;
+    travelDirCodes = 0;
+    capacity = 0;
+    headIdx = 0;
+    numElems = 0;
+    sharedSegments = 0;
+    numSharedSegments = 0;
+    sharedSegmentCapacity = 0;
+    sharedHeadIdx = 0;
+    numSharedElems = 0;
+}
+
+CarQueueClass::CarQueueClass(const CarQueueClass &rhs) {
+    carIds = 0;
+    arrivalTimes = 0;
+    travelDirCodes = 0;
+    capacity = 0;
+    headIdx = 0;
+    numElems = 0;
+    sharedSegments = 0;
+    numSharedSegments = 0;
+    sharedSegmentCapacity = 0;
+    sharedHeadIdx = 0;
+    numSharedElems = 0;
+
+    *this = rhs;
+}
+
+CarQueueClass::~CarQueueClass() {
+    releaseSharedSegments();
+    delete [] sharedSegments;
+    delete [] carIds;
+    delete [] arrivalTimes;
+    delete [] travelDirCodes;
+}
+
+CarQueueClass& CarQueueClass::operator=(const CarQueueClass &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    //share rhs's segments, taking a reference to each before letting go
+    //of this queue's own in case they are the same
+    reserveSharedSegments(rhs.numSharedSegments);
+    for (int segmentIdx = 0; segmentIdx < rhs.numSharedSegments;
+         segmentIdx++) {
+        __sync_fetch_and_add(&rhs.sharedSegments[segmentIdx]->numRefs, 1);
+    }
+    releaseSharedSegments();
+    for (int segmentIdx = 0; segmentIdx < rhs.numSharedSegments;
+         segmentIdx++) {
+        sharedSegments[segmentIdx] = rhs.sharedSegments[segmentIdx];
+    }
+    numSharedSegments = rhs.numSharedSegments;
+    sharedHeadIdx = rhs.sharedHeadIdx;
+    numSharedElems = rhs.numSharedElems;
+
+    //drop the current contents, then take rhs's capacity (keeping the
+    //buffers when they are already that size) and cars
+    numElems = 0;
+    if (capacity != rhs.capacity) {
+        reallocate(rhs.capacity);
+    }
+    headIdx = 0;
+    for (int i = 0; i < rhs.numElems; i++) {
+        int rhsIdx = (rhs.headIdx + i) & (rhs.capacity - 1);
+        carIds[i] = rhs.carIds[rhsIdx];
+        arrivalTimes[i] = rhs.arrivalTimes[rhsIdx];
+        travelDirCodes[i] = rhs.travelDirCodes[rhsIdx];
+    }
+    numElems = rhs.numElems;
+
+    return *this;
+}
+
+void CarQueueClass::enqueue(const CarClass &newCar) {
+    if (numElems == capacity) {
+        if (capacity == 0) {
+            reallocate(CAR_QUEUE_INITIAL_CAPACITY);
+        }
+        else {
+            reallocate(capacity * 2);
+        }
+    }
+
+    int tailIdx = (headIdx + numElems) & (capacity - 1);
+    carIds[tailIdx] = newCar.getId();
+    arrivalTimes[tailIdx] = newCar.getArrivalTime();
+    travelDirCodes[tailIdx] = newCar.getTravelDirCode();
+    numElems++;
+}
+
+bool CarQueueClass::dequeue(CarClass &outCar) {
+    //the shared cars are the oldest
+    if (numSharedElems > 0) {
+        dequeueShared(outCar);
+        return true;
+    }
+    if (numElems == 0) {
+        return false;
+    }
+
+    outCar = CarClass(carIds[headIdx], travelDirCodes[headIdx],
+                      arrivalTimes[headIdx]);
+    headIdx = (headIdx + 1) & (capacity - 1);
+    numElems--;
+    return true;
+}
+
+void CarQueueClass::freezeContents() {
+    if (numElems == 0) {
+        return;
+    }
+
+    reserveSharedSegments(numSharedSegments + 1);
+
+    //the segment takes over the buffers as they are
+    CarQueueSegmentStruct *segment = new CarQueueSegmentStruct;
+    segment->numRefs = 1;
+    segment->carIds = carIds;
+    segment->arrivalTimes = arrivalTimes;
+    segment->travelDirCodes = travelDirCodes;
+    segment->capacity = capacity;
+    segment->headIdx = headIdx;
+    segment->numCars = numElems;
+    sharedSegments[numSharedSegments++] = segment;
+    numSharedElems += numElems;
+
+    carIds = 0;
+    arrivalTimes = 0;
+    travelDirCodes = 0;
+    capacity = 0;
+    headIdx = 0;
+    numElems = 0;
+}
+
+void CarQueueClass::shiftArrivalTimes(const int shiftTime) {
+    if (numSharedElems > 0) {
+        takeSharedCars();
+    }
+    for (int i = 0; i < numElems; i++) {
+        arrivalTimes[(headIdx + i) & (capacity - 1)] += shiftTime;
+    }
+}
+
+void CarQueueClass::print() const {
+    for (int segmentIdx = 0; segmentIdx < numSharedSegments; segmentIdx++) {
+        const CarQueueSegmentStruct *segment = sharedSegments[segmentIdx];
+        for (int i = (segmentIdx == 0) ? sharedHeadIdx : 0;
+             i < segment->numCars; i++) {
+            int idx = (segment->headIdx + i) & (segment->capacity - 1);
+            cout << " " << CarClass(segment->carIds[idx],
+                                    segment->travelDirCodes[idx],
+                                    segment->arrivalTimes[idx]);
+        }
+    }
+    for (int i = 0; i < numElems; i++) {
+        int idx = (headIdx + i) & (capacity - 1);
+        cout << " " << CarClass(carIds[idx], travelDirCodes[idx],
+                                arrivalTimes[idx]);
+    }
+    cout << endl;
+}
+
+long CarQueueClass::getNumBytesAllocated() const {
+    return (long)capacity * (sizeof(int) + sizeof(int) +
+                             sizeof(unsigned char));
+}
+
+long CarQueueClass::getNumBytesShared() const {
+    long numBytes = 0;
+
+    for (int segmentIdx = 0; segmentIdx < numSharedSegments; segmentIdx++) {
+        numBytes += (long)sharedSegments[segmentIdx]->capacity *
+                    (sizeof(int) + sizeof(int) + sizeof(unsigned char));
+    }
+    return numBytes;
+}
+
+void CarQueueClass::clear() {
+    releaseSharedSegments();
+    headIdx = 0;
+    numElems = 0;
+}
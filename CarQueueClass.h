@@ -0,0 +1,128 @@
+#ifndef _CARQUEUECLASS_H_
+#define _CARQUEUECLASS_H_
+
+#include "CarClass.h"
+
+//Cars taken out of a queue by CarQueueClass::freezeContents, in the ring
+//buffers they were queued in.  A segment is never changed once it is made,
+//so any number of queues (such as those of forked simulations) can read
+//its cars at the same time, each from its own position; it is freed when
+//the last of them lets go of it.
+struct CarQueueSegmentStruct {
+    int numRefs;                  //Number of queues holding the segment,
+                                  //changed atomically
+    int *carIds;                  //Unique id of each car
+    int *arrivalTimes;            //Arrival time of each car
+    unsigned char *travelDirCodes;//Travel direction of each car
+    int capacity; //Size of the buffers (a power of two)
+    int headIdx;  //Buffer index of the first car
+    int numCars;  //Number of cars in the segment
+};
+
+//Purpose: A FIFO queue of cars that stores them as a "struct of arrays":
+//         the ids, arrival times and travel directions of the queued cars
+//         each live in their own ring buffer, so a queued car costs 9
+//         bytes and no padding. It has the same interface as
+//         FIFOQueueClass<CarClass>; cars are rebuilt from the arrays as
+//         they are dequeued. The ring buffers grow by doubling and always
+//         have a power-of-two capacity.
+//
+//         The cars at the front can also be held in shared, immutable
+//         segments (see freezeContents), which copies of the queue share
+//         instead of duplicating; they are dequeued before the cars in the
+//         queue's own buffers.
+class CarQueueClass {
+    private:
+        int *carIds;                  //Unique id of each queued car
+        int *arrivalTimes;            //Arrival time of each queued car
+        unsigned char *travelDirCodes;//Travel direction of each queued car
+        int capacity; //Number of cars the buffers can hold (0 or a power
+                      //of two)
+        int headIdx;  //Buffer index of the next car to be dequeued
+        int numElems; //Number of cars in the buffers
+        CarQueueSegmentStruct **sharedSegments; //Segments holding the
+                      //cars ahead of those in the buffers, oldest first
+        int numSharedSegments; //Number of segments held
+        int sharedSegmentCapacity; //Number of segments there is room for
+        int sharedHeadIdx;  //Number of cars already dequeued from the
+                            //oldest segment
+        int numSharedElems; //Number of cars left in the segments
+
+        //Allocates buffers for the given capacity and moves the queued
+        //cars into them, so the next one to be dequeued is at index 0.
+        void reallocate(const int newCapacity);
+
+        //Grows the list of shared segments to hold at least the given
+        //number of them.
+        void reserveSharedSegments(const int minNumSegments);
+
+        //Dequeues the next car from the oldest shared segment, letting go
+        //of the segment once all its cars are taken.
+        void dequeueShared(CarClass &outCar);
+
+        //Copies the cars in the shared segments into the buffers, ahead of
+        //the cars already there, and lets go of the segments.
+        void takeSharedCars();
+
+        //Lets go of every shared segment.
+        void releaseSharedSegments();
+
+    public:
+        //Default ctor - starts out as an empty queue that has not
+        //allocated any storage yet.
+        CarQueueClass();
+
+        //Copy ctor - makes a copy of the queue that is independent of it.
+        //The cars in its buffers are copied; shared segments are shared.
+        CarQueueClass(const CarQueueClass &rhs);
+
+        //Frees the buffers.
+        ~CarQueueClass();
+
+        //Makes this queue a copy of another that is independent of it (see
+        //the copy ctor).
+        CarQueueClass& operator=(const CarQueueClass &rhs);
+
+        //Inserts a car at the back of the queue.
+        void enqueue(const CarClass &newCar);
+
+        //Takes the next car out of the queue. Returns false, leaving outCar
+        //unchanged, if the queue is empty; otherwise true is returned and
+        //outCar becomes the car that was removed.
+        bool dequeue(CarClass &outCar);
+
+        //Moves the cars in the buffers into a new shared segment, leaving
+        //the buffers empty, so that copies of the queue made from now on
+        //share those cars instead of copying them.  No car is copied, and
+        //the order of the cars is unchanged.  Copying a queue is then O(1)
+        //in its length.
+        void freezeContents();
+
+        //Moves the arrival time of every queued car shiftTime later.  Cars
+        //in shared segments are copied into the buffers first.
+        void shiftArrivalTimes(const int shiftTime);
+
+        //Prints out the queued cars on one line, each preceded by a single
+        //space, followed by a newline. The next car to be dequeued is
+        //printed first.
+        void print() const;
+
+        //Returns the number of cars in the queue.
+        int getNumElems() const {
+            return numSharedElems + numElems;
+        }
+
+        //Returns the number of bytes allocated for the queue's own
+        //buffers.
+        long getNumBytesAllocated() const;
+
+        //Returns the number of bytes of car data in the shared segments
+        //the queue holds (which other queues may hold too).
+        long getNumBytesShared() const;
+
+        //Clears the queue to an empty state, keeping its buffers and
+        //letting go of any shared segments.
+        void clear();
+};
+
+#endif // _CARQUEUECLASS_H_
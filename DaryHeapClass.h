@@ -0,0 +1,91 @@
+#ifndef _DARYHEAPCLASS_H
+#define _DARYHEAPCLASS_H
+
+using namespace std;
+
+// A priority queue stored as an implicit d-ary heap in one contiguous,
+// growable array. ARITY is the number of children per node, so ARITY 2
+// gives a classic binary heap and ARITY 4 a shallower 4-ary heap that
+// touches fewer cache lines per removal. It offers the same interface as
+// SortedListClass for the operations an event list needs, but inserts and
+// removes in O(log n) instead of O(n). Values are ordered with T's
+// operator<=, and values that are "equal to" each other come out in the
+// order they were inserted (FIFO), just like with SortedListClass.
+template <class T, int ARITY>
+class DaryHeapClass {
+    private:
+        // One slot of the heap array: the value along with the sequence
+        // number it was given on insertion, used to break ties.
+        struct HeapEntryStruct {
+            T value;
+            unsigned long seqNum;
+        };
+
+        HeapEntryStruct *entries; // Heap-ordered array of entries, or NULL
+                                  // if nothing has been allocated yet.
+        int numElems;             // Number of entries currently in the heap.
+        int capacity;             // Number of entries the array can hold.
+        unsigned long nextSeqNum; // Sequence number given to the next value
+                                  // inserted.
+
+        // Returns true if entry "lhs" has to come out of the heap before
+        // entry "rhs".
+        static bool entryPrecedes(const HeapEntryStruct &lhs,
+                                  const HeapEntryStruct &rhs);
+
+        // Makes sure the array can hold at least one more entry, doubling
+        // its capacity when it is full.
+        void growIfFull();
+
+        // Moves the entry at the given index up until its parent precedes
+        // it.
+        void siftUp(int index);
+
+        // Moves the entry at the given index down until it precedes all of
+        // its children.
+        void siftDown(int index);
+
+    public:
+        // Default Constructor. Will properly initialize a heap to
+        // be an empty heap, to which values can be added.
+        DaryHeapClass();
+
+        // Copy constructor. Will make a complete (deep) copy of the heap,
+        // such that one can be changed without affecting the other.
+        DaryHeapClass(const DaryHeapClass<T, ARITY> &rhs);
+
+        // Destructor. Responsible for making sure any dynamic memory
+        // associated with an object is freed up when the object is
+        // being destroyed.
+        ~DaryHeapClass();
+
+        // Assignment operator. Will assign one heap (on left hand side of
+        // operator) to be a duplicate of the other (on the right hand side
+        // of operator).
+        DaryHeapClass<T, ARITY>& operator=(const DaryHeapClass<T, ARITY> &rhs);
+
+        // Clears the heap to an empty state. The array is kept around so
+        // it can be reused by later insertions.
+        void clear();
+
+        // Inserts a value into the heap. If the value is found to be "equal
+        // to" one or more values already in the heap, it will be removed
+        // AFTER the previously inserted ones.
+        void insertValue(const T &valToInsert);
+
+        // Removes the front (smallest) item from the heap and returns it
+        // via the reference parameter. If the heap was empty, the function
+        // returns false and the reference parameter is left unchanged.
+        // Otherwise true is returned.
+        bool removeFront(T &theVal);
+
+        // Provides a copy of the front (smallest) item without removing
+        // it. Returns false, leaving outVal unchanged, if the heap is empty.
+        bool peekFront(T &outVal) const;
+
+        // Returns the number of values contained in the heap.
+        int getNumElems() const;
+};
+
+#include "DaryHeapClass.inl"
+#endif
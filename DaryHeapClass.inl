@@ -0,0 +1,209 @@
+// Initial number of entries allocated on the first insertion.
+const int DARY_HEAP_INITIAL_CAPACITY = 16;
+
+// Returns true if entry "lhs" has to come out of the heap before
+// entry "rhs".
+template <class T, int ARITY>
+bool DaryHeapClass<T, ARITY>::entryPrecedes(const HeapEntryStruct &lhs,
+                                            const HeapEntryStruct &rhs) {
+    // strictly smaller value goes first
+    if (!(rhs.value <= lhs.value)) {
+        return true;
+    }
+    // strictly greater value goes last
+    if (!(lhs.value <= rhs.value)) {
+        return false;
+    }
+    // equal values come out in insertion order
+    return lhs.seqNum < rhs.seqNum;
+}
+
+// Makes sure the array can hold at least one more entry, doubling
+// its capacity when it is full.
+template <class T, int ARITY>
+void DaryHeapClass<T, ARITY>::growIfFull() {
+    if (numElems < capacity) {
+        return;
+    }
+
+    int newCapacity = DARY_HEAP_INITIAL_CAPACITY;
+    if (capacity > 0) {
+        newCapacity = capacity * 2;
+    }
+    HeapEntryStruct *newEntries = new HeapEntryStruct[newCapacity];
+    for (int i = 0; i < numElems; i++) {
+        newEntries[i] = entries[i];
+    }
+    delete [] entries;
+    entries = newEntries;
+    capacity = newCapacity;
+}
+
+// Moves the entry at the given index up until its parent precedes
+// it.
+template <class T, int ARITY>
+void DaryHeapClass<T, ARITY>::siftUp(int index) {
+    HeapEntryStruct movingEntry = entries[index];
+
+    // shift parents down into the hole until the right spot is found
+    while (index > 0) {
+        int parentIdx = (index - 1) / ARITY;
+        if (!entryPrecedes(movingEntry, entries[parentIdx])) {
+            break;
+        }
+        entries[index] = entries[parentIdx];
+        index = parentIdx;
+    }
+    entries[index] = movingEntry;
+}
+
+// Moves the entry at the given index down until it precedes all of
+// its children.
+template <class T, int ARITY>
+void DaryHeapClass<T, ARITY>::siftDown(int index) {
+    HeapEntryStruct movingEntry = entries[index];
+
+    while (true) {
+        int firstChildIdx = index * ARITY + 1;
+        if (firstChildIdx >= numElems) {
+            break;
+        }
+
+        // find the child that has to come out first
+        int lastChildIdx = firstChildIdx + ARITY - 1;
+        if (lastChildIdx >= numElems) {
+            lastChildIdx = numElems - 1;
+        }
+        int bestChildIdx = firstChildIdx;
+        for (int i = firstChildIdx + 1; i <= lastChildIdx; i++) {
+            if (entryPrecedes(entries[i], entries[bestChildIdx])) {
+                bestChildIdx = i;
+            }
+        }
+
+        if (!entryPrecedes(entries[bestChildIdx], movingEntry)) {
+            break;
+        }
+        entries[index] = entries[bestChildIdx];
+        index = bestChildIdx;
+    }
+    entries[index] = movingEntry;
+}
+
+// Default Constructor. Will properly initialize a heap to
+// be an empty heap, to which values can be added.
+template <class T, int ARITY>
+DaryHeapClass<T, ARITY>::DaryHeapClass() {
+    entries = 0;
+    numElems = 0;
+    capacity = 0;
+    nextSeqNum = 0;
+}
+
+// Copy constructor. Will make a complete (deep) copy of the heap,
+// such that one can be changed without affecting the other.
+template <class T, int ARITY>
+DaryHeapClass<T, ARITY>::DaryHeapClass(const DaryHeapClass<T, ARITY> &rhs) {
+    entries = 0;
+    numElems = 0;
+    capacity = 0;
+    nextSeqNum = 0;
+
+    *this = rhs;
+}
+
+// Destructor. Responsible for making sure any dynamic memory
+// associated with an object is freed up when the object is
+// being destroyed.
+template <class T, int ARITY>
+DaryHeapClass<T, ARITY>::~DaryHeapClass() {
+    delete [] entries;
+}
+
+// Assignment operator. Will assign one heap (on left hand side of
+// operator) to be a duplicate of the other (on the right hand side
+// of operator).
+template <class T, int ARITY>
+DaryHeapClass<T, ARITY>& DaryHeapClass<T, ARITY>::operator=(
+    const DaryHeapClass<T, ARITY> &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    // the array is kept when it is already big enough
+    if (capacity < rhs.numElems) {
+        delete [] entries;
+        capacity = rhs.numElems;
+        entries = new HeapEntryStruct[capacity];
+    }
+
+    // the array is already heap-ordered, so a straight copy will do
+    for (int i = 0; i < rhs.numElems; i++) {
+        entries[i] = rhs.entries[i];
+    }
+    numElems = rhs.numElems;
+    nextSeqNum = rhs.nextSeqNum;
+
+    return *this;
+}
+
+// Clears the heap to an empty state. The array is kept around so
+// it can be reused by later insertions.
+template <class T, int ARITY>
+void DaryHeapClass<T, ARITY>::clear() {
+    numElems = 0;
+    nextSeqNum = 0;
+}
+
+// Inserts a value into the heap. If the value is found to be "equal
+// to" one or more values already in the heap, it will be removed
+// AFTER the previously inserted ones.
+template <class T, int ARITY>
+void DaryHeapClass<T, ARITY>::insertValue(const T &valToInsert) {
+    growIfFull();
+
+    entries[numElems].value = valToInsert;
+    entries[numElems].seqNum = nextSeqNum;
+    nextSeqNum++;
+    numElems++;
+
+    siftUp(numElems - 1);
+}
+
+// Removes the front (smallest) item from the heap and returns it
+// via the reference parameter. If the heap was empty, the function
+// returns false and the reference parameter is left unchanged.
+// Otherwise true is returned.
+template <class T, int ARITY>
+bool DaryHeapClass<T, ARITY>::removeFront(T &theVal) {
+    if (numElems == 0) {
+        return false;
+    }
+
+    theVal = entries[0].value;
+    numElems--;
+
+    // move the last entry into the root and let it find its place
+    if (numElems > 0) {
+        entries[0] = entries[numElems];
+        siftDown(0);
+    }
+    return true;
+}
+
+// Provides a copy of the front (smallest) item without removing
+// it. Returns false, leaving outVal unchanged, if the heap is empty.
+template <class T, int ARITY>
+bool DaryHeapClass<T, ARITY>::peekFront(T &outVal) const {
+    if (numElems == 0) {
+        return false;
+    }
+    outVal = entries[0].value;
+    return true;
+}
+
+// Returns the number of values contained in the heap.
+template <class T, int ARITY>
+int DaryHeapClass<T, ARITY>::getNumElems() const {
+    return numElems;
+}
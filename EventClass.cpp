@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 using namespace std;
 #include "EventClass.h"
 #include "constants.h"
@@ -8,36 +9,35 @@ bool EventClass::operator<=(const EventClass &rhs) const {
     return this->timeOccurs <= rhs.getTimeOccurs();
 }
 
-ostream& operator<<(ostream& outStream, const EventClass &eventToPrint) {
-    outStream << "Event Type: ";
-    if (eventToPrint.typeId == EVENT_ARRIVE_EAST) {
-        outStream << "East-Bound Arrival";
-    }
-    else if (eventToPrint.typeId == EVENT_ARRIVE_WEST) {
-        outStream << "West-Bound Arrival";
-    }
-    else if (eventToPrint.typeId == EVENT_ARRIVE_NORTH) {
-        outStream << "North-Bound Arrival";
-    }
-    else if (eventToPrint.typeId == EVENT_ARRIVE_SOUTH) {
-        outStream << "South-Bound Arrival";
-    }
-    else if (eventToPrint.typeId == EVENT_CHANGE_GREEN_EW) {
-        outStream << "Light Change to EW Green";
-    }
-    else if (eventToPrint.typeId == EVENT_CHANGE_YELLOW_EW) {
-        outStream << "Light Change to EW Yellow";
-    }
-    else if (eventToPrint.typeId == EVENT_CHANGE_GREEN_NS) {
-        outStream << "Light Change to NS Green";
-    }
-    else if (eventToPrint.typeId == EVENT_CHANGE_YELLOW_NS) {
-        outStream << "Light Change to NS Yellow";
-    }
-    else{
-        outStream << "UNKNOWN";
+//Names printed for each event type, indexed by the EVENT_* constants
+//(which run from 0 to NUM_EVENT_TYPES - 1)
+const int NUM_EVENT_TYPES = 12;
+static const string EVENT_TYPE_NAMES[NUM_EVENT_TYPES] = {
+    "East-Bound Arrival", "West-Bound Arrival", "North-Bound Arrival",
+    "South-Bound Arrival", "Light Change to EW Green",
+    "Light Change to EW Yellow", "Light Change to NS Green",
+    "Light Change to NS Yellow", "East-Bound Entry", "West-Bound Entry",
+    "North-Bound Entry", "South-Bound Entry"
+};
+static const string UNKNOWN_EVENT_TYPE_NAME = "UNKNOWN";
+
+//Returns the name printed for the given event type.
+static const string& getEventTypeName(const int typeId) {
+    if (typeId >= 0 && typeId < NUM_EVENT_TYPES) {
+        return EVENT_TYPE_NAMES[typeId];
     }
-    outStream << " Time: " << eventToPrint.timeOccurs;
+    return UNKNOWN_EVENT_TYPE_NAME;
+}
+
+ostream& operator<<(ostream& outStream, const EventClass &eventToPrint) {
+    outStream << "Event Type: " << getEventTypeName(eventToPrint.typeId) <<
+                 " Time: " << eventToPrint.timeOccurs;
     return outStream;
 }
 
+TraceWriterClass& operator<<(TraceWriterClass &traceWriter,
+                             const EventClass &eventToPrint) {
+    traceWriter << "Event Type: " << getEventTypeName(eventToPrint.typeId) <<
+                   " Time: " << eventToPrint.timeOccurs;
+    return traceWriter;
+}
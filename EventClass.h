@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include "constants.h"
+#include "TraceWriterClass.h"
 
 //Programmer: Andrew Morgan
 //Date: November 2020
@@ -59,6 +60,8 @@ class EventClass {
         //make it an "honorary method" by declaring it as a friend.
         friend std::ostream& operator<<(std::ostream& outStream,
                                         const EventClass &eventToPrint);
+        friend TraceWriterClass& operator<<(TraceWriterClass &traceWriter,
+                                            const EventClass &eventToPrint);
 }; 
 
   //  An overloaded insertion operator to allow an event object to be printed
@@ -66,4 +69,9 @@ class EventClass {
 std::ostream& operator<<(std::ostream& outStream,
                          const EventClass &eventToPrint);
 
+//Writes an event to a trace writer, exactly as the insertion operator
+//above would print it.
+TraceWriterClass& operator<<(TraceWriterClass &traceWriter,
+                             const EventClass &eventToPrint);
+
 #endif // _EVENTCLASS_H_
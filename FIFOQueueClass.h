@@ -2,30 +2,44 @@
 #define _FIFOQUEUECLASS_H
 
 using namespace std;
-#include "LinkedNodeClass.h"
 
+// The queue stores its values in one contiguous ring buffer whose
+// capacity is always a power of two, so wrapping an index around is a
+// single mask. The buffer doubles when it fills up, and the number of
+// values is kept up to date so its size can be queried in constant time.
 template <class T>
 class FIFOQueueClass {
     private:
-        LinkedNodeClass<T> *head;// Points to the first node in a queue, or NULL
-                                 // if queue is empty.
-        LinkedNodeClass<T> *tail;// Points to the last node in a queue, or NULL
-                                 // if queue is empty.
+        T *elements;  // Ring buffer holding the queued values, or NULL if
+                      // nothing has been allocated yet.
+        int capacity; // Number of values the buffer can hold (0 or a power
+                      // of two).
+        int headIdx;  // Buffer index of the next value to be dequeued.
+        int numElems; // Number of values currently in the queue.
+
+        // Doubles the capacity of the ring buffer, moving the values so
+        // the next one to be dequeued ends up at index 0.
+        void grow();
+
     public:
         // Default Constructor. Will properly initialize a queue to
         // be an empty queue, to which values can be added.
         FIFOQueueClass();
 
-        // NOTE: This class does NOT have a copy ctor or an overloaded
-        // assignment operator – therefore, using either of those
-        // things will result in a shallow copy. Users should not
-        // attempt to copy a FIFOQueueClass object using either of
-        // these approaches!
+        // Copy constructor. Will make a complete (deep) copy of the queue,
+        // such that one can be changed without affecting the other.
+        FIFOQueueClass(const FIFOQueueClass<T> &rhs);
+
         // Destructor. Responsible for making sure any dynamic memory
         // associated with an object is freed up when the object is
         // being destroyed.
         ~FIFOQueueClass();
 
+        // Assignment operator. Will assign one queue (on left hand side of
+        // operator) to be a duplicate of the other (on the right hand side
+        // of operator).
+        FIFOQueueClass<T>& operator=(const FIFOQueueClass<T> &rhs);
+
         // Inserts the value provided (newItem) into the queue.
         void enqueue(const T &newItem);
 
@@ -44,13 +58,13 @@ class FIFOQueueClass {
         // is printed first.
         void print() const;
 
-        // Returns the number of nodes contained in the queue.
+        // Returns the number of values contained in the queue.
         int getNumElems() const;
 
-        // Clears the queue to an empty state without resulting in any
-        // memory leaks.
+        // Clears the queue to an empty state. The buffer is kept so it
+        // can be reused by later enqueues.
         void clear();
 };
 
 #include "FIFOQueueClass.inl"
-#endif
\ No newline at end of file
+#endif
@@ -1,42 +1,90 @@
+// Number of values the ring buffer holds when it is first allocated.
+const int FIFO_QUEUE_INITIAL_CAPACITY = 16;
+
+// Doubles the capacity of the ring buffer, moving the values so
+// the next one to be dequeued ends up at index 0.
+template <class T>
+void FIFOQueueClass<T>::grow() {
+    int newCapacity = FIFO_QUEUE_INITIAL_CAPACITY;
+    if (capacity > 0) {
+        newCapacity = capacity * 2;
+    }
+
+    T *newElements = new T[newCapacity];
+    for (int i = 0; i < numElems; i++) {
+        newElements[i] = elements[(headIdx + i) & (capacity - 1)];
+    }
+    delete [] elements;
+    elements = newElements;
+    capacity = newCapacity;
+    headIdx = 0;
+}
+
 // Default Constructor. Will properly initialize a queue to
 // be an empty queue, to which values can be added.
 template <class T>
 FIFOQueueClass<T>::FIFOQueueClass() {
-    head = 0;
-    tail = 0;
+    elements = 0;
+    capacity = 0;
+    headIdx = 0;
+    numElems = 0;
+}
+
+// Copy constructor. Will make a complete (deep) copy of the queue,
+// such that one can be changed without affecting the other.
+template <class T>
+FIFOQueueClass<T>::FIFOQueueClass(const FIFOQueueClass<T> &rhs) {
+    elements = 0;
+    capacity = 0;
+    headIdx = 0;
+    numElems = 0;
+
+    *this = rhs;
 }
 
-// NOTE: This class does NOT have a copy ctor or an overloaded
-// assignment operator – therefore, using either of those
-// things will result in a shallow copy. Users should not
-// attempt to copy a FIFOQueueClass object using either of
-// these approaches!
 // Destructor. Responsible for making sure any dynamic memory
 // associated with an object is freed up when the object is
 // being destroyed.
 template <class T>
 FIFOQueueClass<T>::~FIFOQueueClass() {
-    clear();
+    delete [] elements;
+}
+
+// Assignment operator. Will assign one queue (on left hand side of
+// operator) to be a duplicate of the other (on the right hand side
+// of operator).
+template <class T>
+FIFOQueueClass<T>& FIFOQueueClass<T>::operator=(
+    const FIFOQueueClass<T> &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    delete [] elements;
+    elements = 0;
+    capacity = rhs.capacity;
+    if (capacity > 0) {
+        elements = new T[capacity];
+    }
+
+    // copy the values so the next one to be dequeued is at index 0
+    for (int i = 0; i < rhs.numElems; i++) {
+        elements[i] = rhs.elements[(rhs.headIdx + i) & (rhs.capacity - 1)];
+    }
+    headIdx = 0;
+    numElems = rhs.numElems;
+
+    return *this;
 }
 
 // Inserts the value provided (newItem) into the queue.
 template <class T>
 void FIFOQueueClass<T>::enqueue(const T &newItem) {
-    // add a node if empty
-    if (head == 0) {
-        LinkedNodeClass<T> *nodeToInsert = new LinkedNodeClass<T>(0, 
-                                                                  newItem, 
-                                                                  0);
-        head = nodeToInsert;
-        tail = nodeToInsert;
-        return;
+    if (numElems == capacity) {
+        grow();
     }
-    // if not empty
-    LinkedNodeClass<T> *nodeToInsert = new LinkedNodeClass<T>(tail,
-                                                              newItem, 
-                                                              0);
-    nodeToInsert->setBeforeAndAfterPointers();
-    tail = nodeToInsert;
+    elements[(headIdx + numElems) & (capacity - 1)] = newItem;
+    numElems++;
 }
 
 // Attempts to take the next item out of the queue. If the
@@ -48,26 +96,15 @@ void FIFOQueueClass<T>::enqueue(const T &newItem) {
 template <class T>
 bool FIFOQueueClass<T>::dequeue(T &outItem) {
     // empty queue
-    if (head == 0) {
+    if (numElems == 0) {
         return false;
     }
+
     // deque from front
-    else {
-        LinkedNodeClass<T> *currNode = head;
-        outItem = currNode->getValue();
-        // if there is only one element
-        if (currNode->getNext() == 0) {
-            head = 0;
-            tail = 0;
-        }
-        else {
-            head = currNode->getNext();
-            head->setPreviousPointerToNull();
-        }
-
-        delete currNode;
-        return true;
-    }
+    outItem = elements[headIdx];
+    headIdx = (headIdx + 1) & (capacity - 1);
+    numElems--;
+    return true;
 }
 
 // Prints out the contents of the queue. All printing is done
@@ -77,37 +114,22 @@ bool FIFOQueueClass<T>::dequeue(T &outItem) {
 // is printed first.
 template <class T>
 void FIFOQueueClass<T>::print() const {
-    LinkedNodeClass<T> *currNode = head;
-    while (currNode != 0) {
-        cout << " " << currNode->getValue();
-        currNode = currNode->getNext();
+    for (int i = 0; i < numElems; i++) {
+        cout << " " << elements[(headIdx + i) & (capacity - 1)];
     }
     cout << endl;
 }
 
-// Returns the number of nodes contained in the queue.
+// Returns the number of values contained in the queue.
 template <class T>
 int FIFOQueueClass<T>::getNumElems() const {
-    int num = 0;
-    LinkedNodeClass<T> *currNode = head;
-    while (currNode != 0) {
-        num++;
-        currNode = currNode->getNext();
-    }
-    return num;
+    return numElems;
 }
 
-// Clears the queue to an empty state without resulting in any
-// memory leaks.
+// Clears the queue to an empty state. The buffer is kept so it
+// can be reused by later enqueues.
 template <class T>
 void FIFOQueueClass<T>::clear() {
-    // delete node if head is not null
-    while (head != 0) {
-        LinkedNodeClass<T> *currNode = head;
-        head = head->getNext();
-        delete currNode;
-    }
-
-    // set tail back to default
-    tail = 0;
-}
\ No newline at end of file
+    headIdx = 0;
+    numElems = 0;
+}
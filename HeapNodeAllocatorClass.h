@@ -0,0 +1,50 @@
+#ifndef _HEAPNODEALLOCATORCLASS_H
+#define _HEAPNODEALLOCATORCLASS_H
+
+using namespace std;
+
+// The default node allocator for the linked containers: every node gets
+// its own trip to the heap via operator new, just like a plain "new
+// NodeT". It hands out raw storage, which the container constructs the
+// node in with placement new. It keeps the same counters as
+// PoolNodeAllocatorClass so the two can be compared.
+template <class NodeT>
+class HeapNodeAllocatorClass {
+    private:
+        long numHeapAllocs;      // Number of allocations made from the heap.
+        long numNodesAllocated;  // Number of nodes ever handed out.
+        long numNodesInUse;      // Number of nodes handed out and not yet
+                                 // given back.
+
+    public:
+        // Default Constructor. Starts with all counters at zero.
+        HeapNodeAllocatorClass();
+
+        // Copy constructor. Allocators are never shared or copied along
+        // with a container, so the copy starts out fresh.
+        HeapNodeAllocatorClass(const HeapNodeAllocatorClass<NodeT> &rhs);
+
+        // Assignment operator. Leaves this allocator (and its counters)
+        // untouched, for the same reason as the copy constructor.
+        HeapNodeAllocatorClass<NodeT>& operator=(
+            const HeapNodeAllocatorClass<NodeT> &rhs);
+
+        // Returns uninitialized storage big enough for one NodeT.
+        void* allocate();
+
+        // Gives back storage obtained from allocate. The node that lived
+        // there must already have been destroyed.
+        void deallocate(void *nodeStorage);
+
+        // Returns the number of allocations made from the heap.
+        long getNumHeapAllocs() const;
+
+        // Returns the number of nodes ever handed out.
+        long getNumNodesAllocated() const;
+
+        // Returns the number of nodes currently handed out.
+        long getNumNodesInUse() const;
+};
+
+#include "HeapNodeAllocatorClass.inl"
+#endif
@@ -0,0 +1,62 @@
+#include <new>
+
+// Default Constructor. Starts with all counters at zero.
+template <class NodeT>
+HeapNodeAllocatorClass<NodeT>::HeapNodeAllocatorClass() {
+    numHeapAllocs = 0;
+    numNodesAllocated = 0;
+    numNodesInUse = 0;
+}
+
+// Copy constructor. Allocators are never shared or copied along
+// with a container, so the copy starts out fresh.
+template <class NodeT>
+HeapNodeAllocatorClass<NodeT>::HeapNodeAllocatorClass(
+    const HeapNodeAllocatorClass<NodeT> &) {
+    numHeapAllocs = 0;
+    numNodesAllocated = 0;
+    numNodesInUse = 0;
+}
+
+// Assignment operator. Leaves this allocator (and its counters)
+// untouched, for the same reason as the copy constructor.
+template <class NodeT>
+HeapNodeAllocatorClass<NodeT>& HeapNodeAllocatorClass<NodeT>::operator=(
+    const HeapNodeAllocatorClass<NodeT> &) {
+    return *this;
+}
+
+// Returns uninitialized storage big enough for one NodeT.
+template <class NodeT>
+void* HeapNodeAllocatorClass<NodeT>::allocate() {
+    numHeapAllocs++;
+    numNodesAllocated++;
+    numNodesInUse++;
+    return ::operator new(sizeof(NodeT));
+}
+
+// Gives back storage obtained from allocate. The node that lived
+// there must already have been destroyed.
+template <class NodeT>
+void HeapNodeAllocatorClass<NodeT>::deallocate(void *nodeStorage) {
+    numNodesInUse--;
+    ::operator delete(nodeStorage);
+}
+
+// Returns the number of allocations made from the heap.
+template <class NodeT>
+long HeapNodeAllocatorClass<NodeT>::getNumHeapAllocs() const {
+    return numHeapAllocs;
+}
+
+// Returns the number of nodes ever handed out.
+template <class NodeT>
+long HeapNodeAllocatorClass<NodeT>::getNumNodesAllocated() const {
+    return numNodesAllocated;
+}
+
+// Returns the number of nodes currently handed out.
+template <class NodeT>
+long HeapNodeAllocatorClass<NodeT>::getNumNodesInUse() const {
+    return numNodesInUse;
+}
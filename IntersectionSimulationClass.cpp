@@ -1,17 +1,59 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <cstring>
+#include <cmath>
 using namespace std;
 
 #include "IntersectionSimulationClass.h"
-#include "random.h"
 #include "constants.h"
 
+//Approach names used when printing the statistics, by direction code
+static const string STATS_BOUND_NAMES[NUM_DIRECTIONS] = {
+    "east-bound", "west-bound", "north-bound", "south-bound"
+};
+
+//Writes per-event trace output, through the buffered trace writer, when
+//the simulation is at the trace verbosity level.  Building with
+//SIM_NO_TRACE defined removes the trace statements (and all of their
+//formatting) from the event handling code.
+#ifdef SIM_NO_TRACE
+#define SIM_TRACE(traceItems)
+#else
+#define SIM_TRACE(traceItems) \
+    do { \
+        if (verbosityLevel >= VERBOSITY_TRACE) { \
+            traceWriter << traceItems; \
+        } \
+    } while (0)
+#endif
+
+//Adds a record to the binary trace, if one is being written, stamped
+//with the current time and light state.  Like SIM_TRACE, this compiles
+//to nothing when SIM_NO_TRACE is defined (the unevaluated sizeof just
+//keeps variables set only for the trace from being reported as unused).
+#ifdef SIM_NO_TRACE
+#define SIM_RECORD(recordType, eventType, dirCode, carId, queueLength, value) \
+    do { \
+        (void)sizeof(dirCode); \
+    } while (0)
+#else
+#define SIM_RECORD(recordType, eventType, dirCode, carId, queueLength, value) \
+    do { \
+        if (binaryTraceWriter.getIsOpen()) { \
+            binaryTraceWriter.writeRecord(currentTime, recordType, \
+                                          eventType, dirCode, currentLight, \
+                                          carId, queueLength, value); \
+        } \
+    } while (0)
+#endif
+
 void IntersectionSimulationClass::readParametersFromFile(
                                   const string &paramFname) {
     bool success = true;
     ifstream paramF;
-  
+
+    traceWriter.flush();
     paramF.open(paramFname.c_str());
   
     //Check that the file was able to be opened...
@@ -109,8 +151,12 @@ void IntersectionSimulationClass::readParametersFromFile(
                 << endl;
             }
 
-            //Use the specified seed to seed the random number generator
-            setSeed(randomSeedVal);
+            //Use the specified seed to seed the random number generators
+            randomGenerator.setSeed(randomSeedVal);
+            setupApproachGenerators();
+            signalPlan.setLightTimes(eastWestGreenTime, eastWestYellowTime,
+                                     northSouthGreenTime,
+                                     northSouthYellowTime);
         }
 
         paramF.close();
@@ -123,13 +169,16 @@ void IntersectionSimulationClass::readParametersFromFile(
         isSetupProperly = false;
     }
     else{
-        cout << "Parameters read in successfully - simulation is ready!" 
-        << endl;
+        if (verbosityLevel >= VERBOSITY_TRACE) {
+            cout << "Parameters read in successfully - simulation is ready!" 
+            << endl;
+        }
         isSetupProperly = true;
     }
 }
 
 void IntersectionSimulationClass::printParameters() const {
+    traceWriter.flush();
     cout << "===== Begin Simulation Parameters =====" << endl;
     if (!isSetupProperly) {
         cout << "  Simulation is not yet properly setup!" << endl;
@@ -164,11 +213,380 @@ void IntersectionSimulationClass::printParameters() const {
     cout << "===== End Simulation Parameters =====" << endl;
 }
 
+void IntersectionSimulationClass::setupApproachGenerators() {
+    const double ARRIVAL_MEANS[NUM_DIRECTIONS] = {
+        eastArrivalMean, westArrivalMean, northArrivalMean, southArrivalMean
+    };
+    const double ARRIVAL_STD_DEVS[NUM_DIRECTIONS] = {
+        eastArrivalStdDev, westArrivalStdDev, northArrivalStdDev,
+        southArrivalStdDev
+    };
+
+    //Substream 0 is the main generator's; each approach's arrival
+    //generator uses the next two, and its yellow-light generator one
+    //after all of those
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        arrivalGenerators[dirIdx].setup(randomSeedVal, randomStreamId,
+                                        1 + 2 * dirIdx, ARRIVAL_MEANS[dirIdx],
+                                        ARRIVAL_STD_DEVS[dirIdx],
+                                        isAntithetic);
+        yellowGenerators[dirIdx].setSeed(randomSeedVal);
+        yellowGenerators[dirIdx].setMode(RANDOM_MODE_PHILOX);
+        yellowGenerators[dirIdx].setStream(randomStreamId,
+                                           1 + 2 * NUM_DIRECTIONS + dirIdx);
+    }
+}
+
+void IntersectionSimulationClass::scheduleLazyArrivals() {
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        pendingArrivalTimes[dirIdx] =
+                     currentTime + arrivalGenerators[dirIdx].getNextInterval();
+        pendingParentTimes[dirIdx] = -1;
+        isPendingParentFirst[dirIdx] = true;
+    }
+}
+
+void IntersectionSimulationClass::materializeArrivals(
+                                  const int upToTime,
+                                  const bool isLightChangeAtTime) {
+    CarQueueClass *queues[NUM_DIRECTIONS] = {
+        &eastQueue, &westQueue, &northQueue, &southQueue
+    };
+    int *maxQueueLengths[NUM_DIRECTIONS] = {
+        &maxEastQueueLength, &maxWestQueueLength, &maxNorthQueueLength,
+        &maxSouthQueueLength
+    };
+    //Direction codes of the cars arriving on each approach, as the
+    //per-event engine gives them
+    const unsigned char CAR_DIR_CODES[NUM_DIRECTIONS] = {
+        DIR_CODE_WEST, DIR_CODE_EAST, DIR_CODE_NORTH, DIR_CODE_SOUTH
+    };
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        while (pendingArrivalTimes[dirIdx] <= upToTime) {
+            int arrivalTime = pendingArrivalTimes[dirIdx];
+            bool isFirst = false;
+
+            if (isLightChangeAtTime && arrivalTime == upToTime) {
+                if (pendingParentTimes[dirIdx] != lastLightChangeTime) {
+                    isFirst = pendingParentTimes[dirIdx] < lastLightChangeTime;
+                }
+                else {
+                    isFirst = isPendingParentFirst[dirIdx];
+                }
+                if (!isFirst) {
+                    break;
+                }
+            }
+
+            queues[dirIdx]->enqueue(CarClass(nextCarId, CAR_DIR_CODES[dirIdx],
+                                             arrivalTime));
+            nextCarId++;
+            if (queues[dirIdx]->getNumElems() > *maxQueueLengths[dirIdx]) {
+                *maxQueueLengths[dirIdx] = queues[dirIdx]->getNumElems();
+            }
+            //The queue grew when the car arrived, not when it was added
+            queueLengthStats[dirIdx].setValue(arrivalTime,
+                                              queues[dirIdx]->getNumElems());
+
+            pendingParentTimes[dirIdx] = arrivalTime;
+            isPendingParentFirst[dirIdx] = isFirst;
+            pendingArrivalTimes[dirIdx] = arrivalTime +
+                                    arrivalGenerators[dirIdx].getNextInterval();
+        }
+    }
+}
+
+EventClass IntersectionSimulationClass::getNextLightChange() {
+    int changeTime = signalPlan.getNextChangeTime(currentTime);
+
+    if (eastQueue.getNumElems() == 0 && westQueue.getNumElems() == 0 &&
+        northQueue.getNumElems() == 0 && southQueue.getNumElems() == 0) {
+        int firstArrivalTime = pendingArrivalTimes[0];
+        for (int dirIdx = 1; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            if (pendingArrivalTimes[dirIdx] < firstArrivalTime) {
+                firstArrivalTime = pendingArrivalTimes[dirIdx];
+            }
+        }
+
+        //The first light change at or after the arrival still has to be
+        //handled, as the car may get there before it
+        int busyChangeTime = signalPlan.getNextChangeTime(firstArrivalTime - 1);
+        if (busyChangeTime > changeTime) {
+            SIM_TRACE("\nSkipping idle light changes from time " <<
+                      changeTime << " to time " << busyChangeTime << '\n');
+            changeTime = busyChangeTime;
+        }
+    }
+
+    lastLightChangeTime = signalPlan.getPreviousChangeTime(changeTime);
+    return EventClass(changeTime, signalPlan.getChangeTypeAt(changeTime));
+}
+
+bool IntersectionSimulationClass::getIsDeterministic() const {
+    return eastArrivalStdDev == 0 && westArrivalStdDev == 0 &&
+           northArrivalStdDev == 0 && southArrivalStdDev == 0 &&
+           percentCarsAdvanceOnYellow <= UNIF_LOWER_BOUND;
+}
+
+void IntersectionSimulationClass::getCycleState(
+                                  CycleStateStruct &cycleState) {
+    const CarQueueClass *queues[NUM_DIRECTIONS] = {
+        &eastQueue, &westQueue, &northQueue, &southQueue
+    };
+    const int numAdvanced[NUM_DIRECTIONS] = {
+        numTotalAdvancedEast, numTotalAdvancedWest, numTotalAdvancedNorth,
+        numTotalAdvancedSouth
+    };
+    int numKeyVals = 0;
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        cycleState.keyVals[numKeyVals++] = queues[dirIdx]->getNumElems();
+        cycleState.numAdvanced[dirIdx] = numAdvanced[dirIdx];
+    }
+
+    if (engineMode == ENGINE_LAZY_ARRIVALS) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            cycleState.keyVals[numKeyVals++] =
+                       pendingArrivalTimes[dirIdx] - currentTime;
+            cycleState.keyVals[numKeyVals++] =
+                       pendingParentTimes[dirIdx] - currentTime;
+            cycleState.keyVals[numKeyVals++] = isPendingParentFirst[dirIdx];
+        }
+    }
+    else {
+        //Take the events out in the order they'll be handled and put them
+        //back in that order, which keeps the order of those at equal times
+        EventClass pendingEvents[CYCLE_STATE_MAX_EVENTS];
+        int numEvents = 0;
+        while (numEvents < CYCLE_STATE_MAX_EVENTS &&
+               eventList.removeFront(pendingEvents[numEvents])) {
+            numEvents++;
+        }
+        for (int eventIdx = 0; eventIdx < numEvents; eventIdx++) {
+            cycleState.keyVals[numKeyVals++] =
+                       pendingEvents[eventIdx].getType();
+            cycleState.keyVals[numKeyVals++] =
+                       pendingEvents[eventIdx].getTimeOccurs() - currentTime;
+            eventList.insertValue(pendingEvents[eventIdx]);
+        }
+    }
+
+    //FNV-1a over the key values
+    cycleState.keyHash = 2166136261u;
+    for (int valIdx = 0; valIdx < numKeyVals; valIdx++) {
+        cycleState.keyHash ^= (unsigned int)cycleState.keyVals[valIdx];
+        cycleState.keyHash *= 16777619u;
+    }
+    cycleState.numKeyVals = numKeyVals;
+    cycleState.cycleStartTime = currentTime;
+}
+
+void IntersectionSimulationClass::shiftPendingEvents(const int shiftTime) {
+    if (engineMode == ENGINE_LAZY_ARRIVALS) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            pendingArrivalTimes[dirIdx] += shiftTime;
+            pendingParentTimes[dirIdx] += shiftTime;
+        }
+    }
+    else {
+        EventClass pendingEvents[CYCLE_STATE_MAX_EVENTS];
+        int numEvents = 0;
+        while (numEvents < CYCLE_STATE_MAX_EVENTS &&
+               eventList.removeFront(pendingEvents[numEvents])) {
+            numEvents++;
+        }
+        for (int eventIdx = 0; eventIdx < numEvents; eventIdx++) {
+            eventList.insertValue(EventClass(
+                      pendingEvents[eventIdx].getTimeOccurs() + shiftTime,
+                      pendingEvents[eventIdx].getType()));
+        }
+    }
+}
+
+void IntersectionSimulationClass::checkForSteadyState() {
+    CycleStateStruct cycleState;
+
+    if (isFastForwardDone || !getIsDeterministic()) {
+        return;
+    }
+    getCycleState(cycleState);
+
+    bool isRepeat = hasSavedCycleState &&
+                    cycleState.keyHash == savedCycleState.keyHash &&
+                    cycleState.numKeyVals == savedCycleState.numKeyVals;
+    for (int valIdx = 0; isRepeat && valIdx < cycleState.numKeyVals;
+         valIdx++) {
+        isRepeat = cycleState.keyVals[valIdx] ==
+                   savedCycleState.keyVals[valIdx];
+    }
+
+    if (!isRepeat) {
+        //Brent's method: replace the saved state after 1, 2, 4, ...
+        //cycles, so a repeat is found within a few times the length of the
+        //warm-up plus the repeating pattern, comparing one state per cycle
+        numCyclesSinceSave++;
+        if (!hasSavedCycleState || numCyclesSinceSave == numCyclesBeforeSave) {
+            savedCycleState = cycleState;
+            hasSavedCycleState = true;
+            for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                savedQueueLengthStats[dirIdx] = queueLengthStats[dirIdx];
+                if (isDelayTrackingEnabled) {
+                    savedDelayHistograms[dirIdx] = delayHistograms[dirIdx];
+                }
+            }
+            savedEventListSizeStat = eventListSizeStat;
+            numCyclesSinceSave = 0;
+            numCyclesBeforeSave *= 2;
+        }
+        return;
+    }
+
+    int *numTotalAdvanced[NUM_DIRECTIONS] = {
+        &numTotalAdvancedEast, &numTotalAdvancedWest, &numTotalAdvancedNorth,
+        &numTotalAdvancedSouth
+    };
+    CarQueueClass *queues[NUM_DIRECTIONS] = {
+        &eastQueue, &westQueue, &northQueue, &southQueue
+    };
+    int repeatTime = currentTime - savedCycleState.cycleStartTime;
+    int numRepeats = (timeToStopSim - currentTime) / repeatTime;
+
+    isFastForwardDone = true;
+    if (numRepeats > 0) {
+        int shiftTime = numRepeats * repeatTime;
+
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            *numTotalAdvanced[dirIdx] += numRepeats *
+                         (cycleState.numAdvanced[dirIdx] -
+                          savedCycleState.numAdvanced[dirIdx]);
+            if (isDelayTrackingEnabled) {
+                delayHistograms[dirIdx].repeatGrowthSince(
+                                        savedDelayHistograms[dirIdx],
+                                        numRepeats);
+            }
+            queueLengthStats[dirIdx].repeatGrowthSince(
+                                     savedQueueLengthStats[dirIdx],
+                                     numRepeats, shiftTime);
+            //The cars still waiting arrived as long before the new time as
+            //before the old one
+            queues[dirIdx]->shiftArrivalTimes(shiftTime);
+        }
+        eventListSizeStat.repeatGrowthSince(savedEventListSizeStat,
+                                            numRepeats, shiftTime);
+        SIM_TRACE("\nSteady state found: the " << repeatTime <<
+                  " time units from time " << savedCycleState.cycleStartTime <<
+                  " repeat; fast-forwarding from time " << currentTime <<
+                  " to time " << currentTime + shiftTime << '\n');
+        currentTime += shiftTime;
+        shiftPendingEvents(shiftTime);
+    }
+}
+
+void IntersectionSimulationClass::observeLightCycle(const int cycleEndTime) {
+    double seriesValues[CYCLE_NUM_SERIES];
+    int cycleLength = cycleEndTime - cycleStartTime;
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        int numAdvanced = getNumTotalAdvanced((unsigned char)dirIdx);
+        long queueIntegral = queueLengthStats[dirIdx].getIntegral(
+                                                      cycleEndTime);
+        long cycleQueueIntegral = queueIntegral -
+                                  cycleStartQueueIntegrals[dirIdx];
+        seriesValues[CYCLE_SERIES_ADVANCED + dirIdx] =
+                     numAdvanced - cycleStartNumAdvanced[dirIdx];
+        seriesValues[CYCLE_SERIES_QUEUE_LENGTH + dirIdx] =
+                     (double)cycleQueueIntegral / cycleLength;
+        cycleStartNumAdvanced[dirIdx] = numAdvanced;
+        cycleStartQueueIntegrals[dirIdx] = queueIntegral;
+    }
+    cycleStartTime = cycleEndTime;
+    cycleObservations.addObservation(seriesValues);
+
+    //Checking takes time in proportion to the cycles so far, so checking
+    //every 10% more keeps the cost per cycle constant
+    int numCycles = cycleObservations.getNumObservations();
+    if (numCycles < numCyclesAtNextCheck) {
+        return;
+    }
+    numCyclesAtNextCheck = numCycles + numCycles / 10 + 1;
+
+    SteadyStateEstimateStruct estimate;
+    if (getSteadyStateEstimate(estimate) &&
+        estimate.maxRelativeHalfWidth <= targetPrecision &&
+        estimate.maxBatchCorrelation <= STEADY_STATE_MAX_CORRELATION) {
+        isTargetPrecisionReached = true;
+        targetReachedTime = cycleEndTime;
+        SIM_TRACE("\nTarget precision reached after " << numCycles <<
+                  " light cycles (" << estimate.numWarmupCycles <<
+                  " of them warm-up); stopping at time " << cycleEndTime <<
+                  '\n');
+    }
+}
+
+void IntersectionSimulationClass::observeSkippedCycles(
+                                  const int nextChangeTime) {
+    int cycleLength = signalPlan.getCycleLength();
+
+    //Cycles start at whole multiples of the cycle length
+    for (int cycleEndTime = (currentTime / cycleLength + 1) * cycleLength;
+         cycleEndTime < nextChangeTime && cycleEndTime <= timeToStopSim &&
+         !isTargetPrecisionReached; cycleEndTime += cycleLength) {
+        observeLightCycle(cycleEndTime);
+    }
+}
+
+bool IntersectionSimulationClass::getSteadyStateEstimate(
+                           SteadyStateEstimateStruct &outEstimate) const {
+    //The warm-up shows most in the total of the queue lengths
+    int numWarmupCycles = cycleObservations.getWarmupLength(
+                                            CYCLE_SERIES_QUEUE_LENGTH,
+                                            NUM_DIRECTIONS);
+    if (numWarmupCycles < 0 ||
+        cycleObservations.getNumObservations() - numWarmupCycles <
+        STEADY_STATE_MIN_CYCLES) {
+        return false;
+    }
+
+    //The batches end with the last cycle, so a few more at the start of
+    //the steady state may be dropped to make them equal
+    StatAccumulatorClass batchMeans;
+    outEstimate.numWarmupCycles = numWarmupCycles;
+    outEstimate.batchSize = (cycleObservations.getNumObservations() -
+                             numWarmupCycles) / STEADY_STATE_NUM_BATCHES;
+    outEstimate.maxRelativeHalfWidth = 0;
+    outEstimate.maxBatchCorrelation = -1;
+    for (int seriesIdx = 0; seriesIdx < CYCLE_NUM_SERIES; seriesIdx++) {
+        cycleObservations.getBatchMeans(seriesIdx, STEADY_STATE_NUM_BATCHES,
+                                        outEstimate.batchSize, batchMeans);
+        outEstimate.means[seriesIdx] = batchMeans.getMean();
+        outEstimate.halfWidths[seriesIdx] =
+                    batchMeans.getConfidenceHalfWidth();
+        double correlation = cycleObservations.getBatchMeansCorrelation(
+                                               seriesIdx,
+                                               STEADY_STATE_NUM_BATCHES,
+                                               outEstimate.batchSize);
+        if (correlation > outEstimate.maxBatchCorrelation) {
+            outEstimate.maxBatchCorrelation = correlation;
+        }
+        if (outEstimate.means[seriesIdx] != 0) {
+            double relativeHalfWidth = outEstimate.halfWidths[seriesIdx] /
+                                       fabs(outEstimate.means[seriesIdx]);
+            if (relativeHalfWidth > outEstimate.maxRelativeHalfWidth) {
+                outEstimate.maxRelativeHalfWidth = relativeHalfWidth;
+            }
+        }
+    }
+    return true;
+}
+
 void IntersectionSimulationClass::scheduleArrival(const string &travelDir) {
     int arrivalIntervalTime; // time a car will arrive in this dir from now
     int arrivalType; // containing dir info
+    unsigned char approachDirCode; // approach the car will arrive on
 
     if (!isSetupProperly) {
+        traceWriter.flush();
         cout << "  Simulation is not yet properly setup!" << endl;
         return;
     }
@@ -176,51 +594,59 @@ void IntersectionSimulationClass::scheduleArrival(const string &travelDir) {
         // check valid direction
         if (travelDir == EAST_DIRECTION) {
             arrivalType = EVENT_ARRIVE_EAST;
-            arrivalIntervalTime = getPositiveNormal(eastArrivalMean, 
-                                                    eastArrivalStdDev);
-            cout << "Time: " << this->currentTime << " Scheduled Event Type: " 
-                 << "East-Bound ";
+            approachDirCode = DIR_CODE_EAST;
+            arrivalIntervalTime = getArrivalInterval(DIR_CODE_EAST,
+                                      eastArrivalMean, eastArrivalStdDev);
+            SIM_TRACE("Time: " << this->currentTime << " Scheduled Event Type: "
+                   << "East-Bound ");
         }
         else if (travelDir == WEST_DIRECTION) {
             arrivalType = EVENT_ARRIVE_WEST;
-            arrivalIntervalTime = getPositiveNormal(westArrivalMean, 
-                                                    westArrivalStdDev);
-            cout << "Time: " << this->currentTime << " Scheduled Event Type: " 
-                 << "West-Bound ";
+            approachDirCode = DIR_CODE_WEST;
+            arrivalIntervalTime = getArrivalInterval(DIR_CODE_WEST,
+                                      westArrivalMean, westArrivalStdDev);
+            SIM_TRACE("Time: " << this->currentTime << " Scheduled Event Type: "
+                   << "West-Bound ");
         }
         else if (travelDir == NORTH_DIRECTION) {
             arrivalType = EVENT_ARRIVE_NORTH;
-            arrivalIntervalTime = getPositiveNormal(northArrivalMean, 
-                                                    northArrivalStdDev);
-            cout << "Time: " << this->currentTime << " Scheduled Event Type: " 
-                 << "North-Bound ";
+            approachDirCode = DIR_CODE_NORTH;
+            arrivalIntervalTime = getArrivalInterval(DIR_CODE_NORTH,
+                                      northArrivalMean, northArrivalStdDev);
+            SIM_TRACE("Time: " << this->currentTime << " Scheduled Event Type: "
+                   << "North-Bound ");
         }
         else if (travelDir == SOUTH_DIRECTION) {
             arrivalType = EVENT_ARRIVE_SOUTH;
-            arrivalIntervalTime = getPositiveNormal(southArrivalMean, 
-                                                    southArrivalStdDev);
-            cout << "Time: " << this->currentTime << " Scheduled Event Type: " 
-                 << "South-Bound ";
+            approachDirCode = DIR_CODE_SOUTH;
+            arrivalIntervalTime = getArrivalInterval(DIR_CODE_SOUTH,
+                                      southArrivalMean, southArrivalStdDev);
+            SIM_TRACE("Time: " << this->currentTime << " Scheduled Event Type: "
+                   << "South-Bound ");
         }
         // check invalid dir
         else {
+            traceWriter.flush();
             cout << "Invalid direction input!" << endl;
             return;
         }
 
         // create an event and add to the LinkedListClass
         int arrivalTime = currentTime + arrivalIntervalTime;
-        cout << "Arrival Time: " << arrivalTime << endl;
+        SIM_TRACE("Arrival Time: " << arrivalTime << '\n');
+        SIM_RECORD(TRACE_REC_SCHEDULE, arrivalType, approachDirCode, 0, 0,
+                   arrivalTime);
         EventClass newArrival(arrivalTime, arrivalType);
         eventList.insertValue(newArrival);
     }
 }
 
 void IntersectionSimulationClass::scheduleLightChange() {
-    int nextLightType;
-    int lightChangeTime;
+    int nextLightType = EVENT_UNKNOWN;
+    int lightChangeTime = currentTime;
 
     if (!isSetupProperly) {
+        traceWriter.flush();
         cout << "  Simulation is not yet properly setup!" << endl;
         return;
     }
@@ -230,420 +656,585 @@ void IntersectionSimulationClass::scheduleLightChange() {
             lightChangeTime = currentTime + eastWestGreenTime;
             
             // print info
-            cout << "Time: " << currentTime << " Scheduled Event Type: "
-                 << "Light Change to EW Yellow Time: " << lightChangeTime 
-                 << endl; 
+            SIM_TRACE("Time: " << currentTime << " Scheduled Event Type: "
+                   << "Light Change to EW Yellow Time: " << lightChangeTime
+                   << '\n');
         }
         else if (currentLight == LIGHT_YELLOW_EW) {
             nextLightType = EVENT_CHANGE_GREEN_NS;
             lightChangeTime = currentTime + eastWestYellowTime;
             
             // print info
-            cout << "Time: " << currentTime << " Scheduled Event Type: "
-                 << "Light Change to NS Green Time: " << lightChangeTime 
-                 << endl; 
+            SIM_TRACE("Time: " << currentTime << " Scheduled Event Type: "
+                   << "Light Change to NS Green Time: " << lightChangeTime
+                   << '\n');
         }
         else if (currentLight == LIGHT_GREEN_NS) {
             nextLightType = EVENT_CHANGE_YELLOW_NS;
             lightChangeTime = currentTime + northSouthGreenTime;
             
             // print info
-            cout << "Time: " << currentTime << " Scheduled Event Type: "
-                 << "Light Change to NS Yellow Time: " << lightChangeTime 
-                 << endl;
+            SIM_TRACE("Time: " << currentTime << " Scheduled Event Type: "
+                   << "Light Change to NS Yellow Time: " << lightChangeTime
+                   << '\n');
         }
         else if (currentLight == LIGHT_YELLOW_NS) {
             nextLightType = EVENT_CHANGE_GREEN_EW;
             lightChangeTime = currentTime + northSouthYellowTime;
             
             // print info
-            cout << "Time: " << currentTime << " Scheduled Event Type: "
-                 << "Light Change to EW Green Time: " << lightChangeTime 
-                 << endl;
+            SIM_TRACE("Time: " << currentTime << " Scheduled Event Type: "
+                   << "Light Change to EW Green Time: " << lightChangeTime
+                   << '\n');
         }
 
-        // create an event and add to the LinkedListClass
-        EventClass lightChange(lightChangeTime, nextLightType);
-        eventList.insertValue(lightChange);
+        SIM_RECORD(TRACE_REC_SCHEDULE, nextLightType, DIR_CODE_NOT_SET, 0, 0,
+                   lightChangeTime);
+
+        // create an event and add to the LinkedListClass (the lazy
+        // arrival engine gets its light changes from the signal plan)
+        if (engineMode != ENGINE_LAZY_ARRIVALS) {
+            EventClass lightChange(lightChangeTime, nextLightType);
+            eventList.insertValue(lightChange);
+        }
     }
 }
 
 bool IntersectionSimulationClass::handleNextEvent() {
     EventClass eventToHandle;
     bool doHandleNext = true;
+    bool isEventFound = true;
 
-    if (eventList.removeFront(eventToHandle)) {
+    if (isTargetPrecisionReached) {
+        traceWriter.flush();
+        doHandleNext = false;
+        return doHandleNext;
+    }
+
+    if (engineMode == ENGINE_LAZY_ARRIVALS) {
+        eventToHandle = getNextLightChange();
+        //The per-event engine would have observed the skipped cycles
+        if (targetPrecision > 0) {
+            observeSkippedCycles(eventToHandle.getTimeOccurs());
+            if (isTargetPrecisionReached) {
+                traceWriter.flush();
+                doHandleNext = false;
+                return doHandleNext;
+            }
+        }
+    }
+    else {
+        isEventFound = eventList.removeFront(eventToHandle);
+    }
+
+    if (isEventFound) {
         // check time of event in range
         if (eventToHandle.getTimeOccurs() > this->timeToStopSim) {
-            cout << "\nNext event occurs AFTER the simulation end time ("
-                 << eventToHandle << ")!" << endl;
+            SIM_TRACE("\nNext event occurs AFTER the simulation end time ("
+                   << eventToHandle << ")!" << '\n');
+            SIM_RECORD(TRACE_REC_END, eventToHandle.getType(),
+                       DIR_CODE_NOT_SET, 0, 0, eventToHandle.getTimeOccurs());
+            traceWriter.flush();
+            if (engineMode == ENGINE_LAZY_ARRIVALS) {
+                materializeArrivals(timeToStopSim, false);
+            }
             doHandleNext = false;
             return doHandleNext;
         }
     }
     else {
         // error when nothing found in eventlist
+        traceWriter.flush();
         cout << "Error: No event scheduled!" << endl;
         doHandleNext = false;
         return doHandleNext;
     }
 
     if (doHandleNext) {
-        int handleType = eventToHandle.getType();
-        this->currentTime = eventToHandle.getTimeOccurs();
-
-        // create car for specific direction and enqueue
-        if (handleType == EVENT_ARRIVE_EAST) {
-            CarClass arrivingCar(WEST_DIRECTION,
-                                 eventToHandle.getTimeOccurs());
-            eastQueue.enqueue(arrivingCar);
-
-            // update max len
-            if (eastQueue.getNumElems() > maxEastQueueLength) {
-                maxEastQueueLength = eastQueue.getNumElems();
-            }
+        handleEvent(eventToHandle);
+    }
+    return doHandleNext;
+}
 
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Time: " << this->currentTime << " Car #" 
-                 << arrivingCar.getId() << " arrives east-bound" 
-                 << " - queue length: " << eastQueue.getNumElems() << endl;
-            
-            // schedule new arrival
-            scheduleArrival(EAST_DIRECTION); 
+void IntersectionSimulationClass::handleEvent(
+                                  const EventClass &eventToHandle) {
+    int handleType = eventToHandle.getType();
+    this->currentTime = eventToHandle.getTimeOccurs();
+
+    if (engineMode == ENGINE_LAZY_ARRIVALS) {
+        materializeArrivals(currentTime, true);
+    }
+
+    //A car entering from a linked intersection is handled like an
+    //arrival, except that it doesn't lead to another one
+    bool isLinkEntry = false;
+    if (handleType >= EVENT_ENTER_EAST && handleType <= EVENT_ENTER_SOUTH) {
+        isLinkEntry = true;
+        handleType += EVENT_ARRIVE_EAST - EVENT_ENTER_EAST;
+    }
+
+    // create car for specific direction and enqueue
+    if (handleType == EVENT_ARRIVE_EAST) {
+        CarClass arrivingCar(nextCarId, DIR_CODE_WEST,
+                             eventToHandle.getTimeOccurs());
+        nextCarId++;
+        eastQueue.enqueue(arrivingCar);
+
+        // update max len
+        if (eastQueue.getNumElems() > maxEastQueueLength) {
+            maxEastQueueLength = eastQueue.getNumElems();
         }
-        else if (handleType == EVENT_ARRIVE_WEST) {
-            CarClass arrivingCar(EAST_DIRECTION,
-                                 eventToHandle.getTimeOccurs());
-            westQueue.enqueue(arrivingCar);
 
-            // update max len
-            if (westQueue.getNumElems() > maxWestQueueLength) {
-                maxWestQueueLength = westQueue.getNumElems();
-            }
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Time: " << this->currentTime << " Car #"
+               << arrivingCar.getId() << " arrives east-bound"
+               << " - queue length: " << eastQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_EAST, 0, 0, 0);
+        SIM_RECORD(TRACE_REC_ARRIVE, handleType, DIR_CODE_EAST,
+                   arrivingCar.getId(), eastQueue.getNumElems(), 0);
+        
+        // schedule new arrival
+        if (!isLinkEntry) {
+            scheduleArrival(EAST_DIRECTION);
+        }
+    }
+    else if (handleType == EVENT_ARRIVE_WEST) {
+        CarClass arrivingCar(nextCarId, DIR_CODE_EAST,
+                             eventToHandle.getTimeOccurs());
+        nextCarId++;
+        westQueue.enqueue(arrivingCar);
 
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Time: " << this->currentTime << " Car #" 
-                 << arrivingCar.getId() << " arrives west-bound" 
-                 << " - queue length: " << westQueue.getNumElems() << endl;
-            
-            // schedule new arrival
-            scheduleArrival(WEST_DIRECTION); 
+        // update max len
+        if (westQueue.getNumElems() > maxWestQueueLength) {
+            maxWestQueueLength = westQueue.getNumElems();
         }
-        else if (handleType == EVENT_ARRIVE_NORTH) {
-            CarClass arrivingCar(NORTH_DIRECTION,
-                                 eventToHandle.getTimeOccurs());
-            northQueue.enqueue(arrivingCar);
 
-            // update max len
-            if (northQueue.getNumElems() > maxNorthQueueLength) {
-                maxNorthQueueLength = northQueue.getNumElems();
-            }
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Time: " << this->currentTime << " Car #"
+               << arrivingCar.getId() << " arrives west-bound"
+               << " - queue length: " << westQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_WEST, 0, 0, 0);
+        SIM_RECORD(TRACE_REC_ARRIVE, handleType, DIR_CODE_WEST,
+                   arrivingCar.getId(), westQueue.getNumElems(), 0);
+        
+        // schedule new arrival
+        if (!isLinkEntry) {
+            scheduleArrival(WEST_DIRECTION);
+        }
+    }
+    else if (handleType == EVENT_ARRIVE_NORTH) {
+        CarClass arrivingCar(nextCarId, DIR_CODE_NORTH,
+                             eventToHandle.getTimeOccurs());
+        nextCarId++;
+        northQueue.enqueue(arrivingCar);
 
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Time: " << this->currentTime << " Car #" 
-                 << arrivingCar.getId() << " arrives north-bound" 
-                 << " - queue length: " << northQueue.getNumElems() << endl;
-            
-            // schedule new arrival
-            scheduleArrival(NORTH_DIRECTION); 
+        // update max len
+        if (northQueue.getNumElems() > maxNorthQueueLength) {
+            maxNorthQueueLength = northQueue.getNumElems();
         }
-        else if (handleType == EVENT_ARRIVE_SOUTH) {
-            CarClass arrivingCar(SOUTH_DIRECTION,
-                                 eventToHandle.getTimeOccurs());
-            southQueue.enqueue(arrivingCar);
 
-            // update max len
-            if (southQueue.getNumElems() > maxSouthQueueLength) {
-                maxSouthQueueLength = southQueue.getNumElems();
-            }
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Time: " << this->currentTime << " Car #"
+               << arrivingCar.getId() << " arrives north-bound"
+               << " - queue length: " << northQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_NORTH, 0, 0, 0);
+        SIM_RECORD(TRACE_REC_ARRIVE, handleType, DIR_CODE_NORTH,
+                   arrivingCar.getId(), northQueue.getNumElems(), 0);
+        
+        // schedule new arrival
+        if (!isLinkEntry) {
+            scheduleArrival(NORTH_DIRECTION);
+        }
+    }
+    else if (handleType == EVENT_ARRIVE_SOUTH) {
+        CarClass arrivingCar(nextCarId, DIR_CODE_SOUTH,
+                             eventToHandle.getTimeOccurs());
+        nextCarId++;
+        southQueue.enqueue(arrivingCar);
 
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Time: " << this->currentTime << " Car #" 
-                 << arrivingCar.getId() << " arrives south-bound" 
-                 << " - queue length: " << southQueue.getNumElems() << endl;
-            
-            // schedule new arrival
-            scheduleArrival(SOUTH_DIRECTION); 
-        }
-        else if (handleType == EVENT_CHANGE_YELLOW_EW) {
-            int totalCanPass = eastWestGreenTime;
-            int numGoneEast = 0;
-            int numGoneWest = 0;
-            CarClass passingCar;
-
-            // change light 
-            currentLight = LIGHT_YELLOW_EW;
-
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Advancing cars on east-west green" << endl;
-
-            // Car passig during green
-            while (numGoneEast < totalCanPass && 
-                   eastQueue.dequeue(passingCar)) {
-                numGoneEast++;
-                numTotalAdvancedEast++;
-                cout << "  Car #" << passingCar.getId() 
-                     << " advances east-bound" << endl;
-            }
-            while (numGoneWest < totalCanPass && 
-                   westQueue.dequeue(passingCar)) {
-                numGoneWest++;
-                numTotalAdvancedWest++;
-                cout << "  Car #" << passingCar.getId() 
-                     << " advances west-bound" << endl;
+        // update max len
+        if (southQueue.getNumElems() > maxSouthQueueLength) {
+            maxSouthQueueLength = southQueue.getNumElems();
+        }
+
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Time: " << this->currentTime << " Car #"
+               << arrivingCar.getId() << " arrives south-bound"
+               << " - queue length: " << southQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_SOUTH, 0, 0, 0);
+        SIM_RECORD(TRACE_REC_ARRIVE, handleType, DIR_CODE_SOUTH,
+                   arrivingCar.getId(), southQueue.getNumElems(), 0);
+        
+        // schedule new arrival
+        if (!isLinkEntry) {
+            scheduleArrival(SOUTH_DIRECTION);
+        }
+    }
+    else if (handleType == EVENT_CHANGE_YELLOW_EW) {
+        int totalCanPass = eastWestGreenTime;
+        int numGoneEast = 0;
+        int numGoneWest = 0;
+        CarClass passingCar;
+
+        // change light 
+        currentLight = LIGHT_YELLOW_EW;
+
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Advancing cars on east-west green" << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_NOT_SET, 0, 0, 0);
+
+        // Car passig during green
+        while (numGoneEast < totalCanPass && 
+               eastQueue.dequeue(passingCar)) {
+            numGoneEast++;
+            numTotalAdvancedEast++;
+            recordDeparture(DIR_CODE_EAST, passingCar);
+            SIM_TRACE("  Car #" << passingCar.getId()
+                   << " advances east-bound" << '\n');
+            SIM_RECORD(TRACE_REC_ADVANCE_GREEN, handleType, DIR_CODE_EAST,
+                       passingCar.getId(), eastQueue.getNumElems(), 0);
+        }
+        while (numGoneWest < totalCanPass && 
+               westQueue.dequeue(passingCar)) {
+            numGoneWest++;
+            numTotalAdvancedWest++;
+            recordDeparture(DIR_CODE_WEST, passingCar);
+            SIM_TRACE("  Car #" << passingCar.getId()
+                   << " advances west-bound" << '\n');
+            SIM_RECORD(TRACE_REC_ADVANCE_GREEN, handleType, DIR_CODE_WEST,
+                       passingCar.getId(), westQueue.getNumElems(), 0);
+        }
+
+        SIM_TRACE("East-bound cars advanced on green: " << numGoneEast
+               << " Remaining queue: " << eastQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_GREEN, handleType, DIR_CODE_EAST, 0,
+                   eastQueue.getNumElems(), numGoneEast);
+        SIM_TRACE("West-bound cars advanced on green: " << numGoneWest
+               << " Remaining queue: " << westQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_GREEN, handleType, DIR_CODE_WEST, 0,
+                   westQueue.getNumElems(), numGoneWest);
+        
+        scheduleLightChange();
+    }
+    else if (handleType == EVENT_CHANGE_GREEN_NS) {
+        int totalCouldPass = eastWestYellowTime;
+        bool keepAdv = true;
+        bool doNextAdv;
+        int numGoneEast = 0;
+        int numGoneWest = 0;
+        CarClass passingCar;
+
+        // change light 
+        currentLight = LIGHT_GREEN_NS;
+
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Advancing cars on east-west yellow" << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_NOT_SET, 0, 0, 0);
+
+        // east
+        while (keepAdv) {
+            if (!eastQueue.getNumElems()) {
+                SIM_TRACE("  No east-bound cars waiting to advance "
+                       << "on yellow" << '\n');
+                SIM_RECORD(TRACE_REC_NO_CARS_YELLOW, handleType,
+                           DIR_CODE_EAST, 0, 0, 0);
+                keepAdv = false;
             }
+            else {
+                if (numGoneEast < totalCouldPass) {
+                    // generate random number
+                    int random = getYellowDraw(DIR_CODE_EAST);
+                    doNextAdv = random < percentCarsAdvanceOnYellow;
 
-            cout << "East-bound cars advanced on green: " << numGoneEast
-                 << " Remaining queue: " << eastQueue.getNumElems() << endl;
-            cout << "West-bound cars advanced on green: " << numGoneWest
-                 << " Remaining queue: " << westQueue.getNumElems() << endl;
-            
-            scheduleLightChange();
-        }
-        else if (handleType == EVENT_CHANGE_GREEN_NS) {
-            int totalCouldPass = eastWestYellowTime;
-            bool keepAdv = true;
-            bool doNextAdv;
-            int numGoneEast = 0;
-            int numGoneWest = 0;
-            CarClass passingCar;
-
-            // change light 
-            currentLight = LIGHT_GREEN_NS;
-
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Advancing cars on east-west yellow" << endl;
-
-            // east
-            while (keepAdv) {
-                if (!eastQueue.getNumElems()) {
-                    cout << "  No east-bound cars waiting to advance "
-                         << "on yellow" << endl;
-                    keepAdv = false;
-                }
-                else {
-                    if (numGoneEast < totalCouldPass) {
-                        // generate random number
-                        int random = getUniform(UNIF_LOWER_BOUND, 
-                                                UNIF_UPPER_BOUND);
-                        doNextAdv = random < percentCarsAdvanceOnYellow;
-
-                        if (doNextAdv) {
-                            eastQueue.dequeue(passingCar);
-                            numGoneEast++;
-                            numTotalAdvancedEast++;
-
-                            // print info
-                            cout << "  Next east-bound car will advance "
-                                 << "on yellow" << endl;
-                            cout << "  Car#" << passingCar.getId() 
-                                 << " advances east-bound" << endl;
-                        }
-                        else {
-                            cout << "  Next east-bound car will NOT advance "
-                                 << "on yellow" << endl;
-                            keepAdv = false;
-                        }
+                    if (doNextAdv) {
+                        eastQueue.dequeue(passingCar);
+                        numGoneEast++;
+                        numTotalAdvancedEast++;
+                        recordDeparture(DIR_CODE_EAST, passingCar);
+
+                        // print info
+                        SIM_TRACE("  Next east-bound car will advance "
+                               << "on yellow" << '\n');
+                        SIM_TRACE("  Car#" << passingCar.getId()
+                               << " advances east-bound" << '\n');
+                        SIM_RECORD(TRACE_REC_ADVANCE_YELLOW, handleType,
+                                   DIR_CODE_EAST, passingCar.getId(),
+                                   eastQueue.getNumElems(), 0);
                     }
                     else {
+                        SIM_TRACE("  Next east-bound car will NOT advance "
+                               << "on yellow" << '\n');
+                        SIM_RECORD(TRACE_REC_STOP_YELLOW, handleType,
+                                   DIR_CODE_EAST, 0,
+                                   eastQueue.getNumElems(), 0);
                         keepAdv = false;
                     }
                 }
-            }
-
-            // west
-            keepAdv = true;
-            while (keepAdv) {
-                if (!westQueue.getNumElems()) {
-                    cout << "  No west-bound cars waiting to advance "
-                         << "on yellow" << endl;
+                else {
                     keepAdv = false;
                 }
-                else {
-                    if (numGoneWest < totalCouldPass) {
-                        // generate random number
-                        int random = getUniform(UNIF_LOWER_BOUND, 
-                                                UNIF_UPPER_BOUND);
-                        doNextAdv = random < percentCarsAdvanceOnYellow;
-                        
-                        if (doNextAdv) {
-                            westQueue.dequeue(passingCar);
-                            numGoneWest++;
-                            numTotalAdvancedWest++;
-
-                            // print info
-                            cout << "  Next west-bound car will advance "
-                                 << "on yellow" << endl;
-                            cout << "  Car#" << passingCar.getId() 
-                                 << " advances west-bound" << endl;
-                        }
-                        else {
-                            cout << "  Next west-bound car will NOT advance "
-                                 << "on yellow"
-                                 << endl;
-                            keepAdv = false;
-                        }
+            }
+        }
+
+        // west
+        keepAdv = true;
+        while (keepAdv) {
+            if (!westQueue.getNumElems()) {
+                SIM_TRACE("  No west-bound cars waiting to advance "
+                       << "on yellow" << '\n');
+                SIM_RECORD(TRACE_REC_NO_CARS_YELLOW, handleType,
+                           DIR_CODE_WEST, 0, 0, 0);
+                keepAdv = false;
+            }
+            else {
+                if (numGoneWest < totalCouldPass) {
+                    // generate random number
+                    int random = getYellowDraw(DIR_CODE_WEST);
+                    doNextAdv = random < percentCarsAdvanceOnYellow;
+                    
+                    if (doNextAdv) {
+                        westQueue.dequeue(passingCar);
+                        numGoneWest++;
+                        numTotalAdvancedWest++;
+                        recordDeparture(DIR_CODE_WEST, passingCar);
+
+                        // print info
+                        SIM_TRACE("  Next west-bound car will advance "
+                               << "on yellow" << '\n');
+                        SIM_TRACE("  Car#" << passingCar.getId()
+                               << " advances west-bound" << '\n');
+                        SIM_RECORD(TRACE_REC_ADVANCE_YELLOW, handleType,
+                                   DIR_CODE_WEST, passingCar.getId(),
+                                   westQueue.getNumElems(), 0);
                     }
                     else {
+                        SIM_TRACE("  Next west-bound car will NOT advance "
+                               << "on yellow"
+                               << '\n');
+                        SIM_RECORD(TRACE_REC_STOP_YELLOW, handleType,
+                                   DIR_CODE_WEST, 0,
+                                   westQueue.getNumElems(), 0);
                         keepAdv = false;
                     }
                 }
+                else {
+                    keepAdv = false;
+                }
             }
+        }
 
-            // print info
-            cout << "East-bound cars advanced on yellow: " << numGoneEast
-                 << " Remaining queue: " << eastQueue.getNumElems() << endl;
-            cout << "West-bound cars advanced on yellow: " << numGoneWest
-                 << " Remaining queue: " << westQueue.getNumElems() << endl;
-
-            scheduleLightChange();
-        }
-        else if (handleType == EVENT_CHANGE_YELLOW_NS) {
-            int totalCanPass = northSouthGreenTime;
-            int numGoneNorth = 0;
-            int numGoneSouth = 0;
-            CarClass passingCar;
-
-            // change light 
-            currentLight = LIGHT_YELLOW_NS;
-
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Advancing cars on north-south green" << endl;
-
-            // Car passig during green
-            while (numGoneNorth < totalCanPass && 
-                   northQueue.dequeue(passingCar)) {
-                numGoneNorth++;
-                numTotalAdvancedNorth++;
-                cout << "  Car #" << passingCar.getId() 
-                     << " advances north-bound" << endl;
-            }
-            while (numGoneSouth < totalCanPass && 
-                   southQueue.dequeue(passingCar)) {
-                numGoneSouth++;
-                numTotalAdvancedSouth++;
-                cout << "  Car #" << passingCar.getId() 
-                     << " advances south-bound" << endl;
+        // print info
+        SIM_TRACE("East-bound cars advanced on yellow: " << numGoneEast
+               << " Remaining queue: " << eastQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_YELLOW, handleType, DIR_CODE_EAST, 0,
+                   eastQueue.getNumElems(), numGoneEast);
+        SIM_TRACE("West-bound cars advanced on yellow: " << numGoneWest
+               << " Remaining queue: " << westQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_YELLOW, handleType, DIR_CODE_WEST, 0,
+                   westQueue.getNumElems(), numGoneWest);
+
+        scheduleLightChange();
+    }
+    else if (handleType == EVENT_CHANGE_YELLOW_NS) {
+        int totalCanPass = northSouthGreenTime;
+        int numGoneNorth = 0;
+        int numGoneSouth = 0;
+        CarClass passingCar;
+
+        // change light 
+        currentLight = LIGHT_YELLOW_NS;
+
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Advancing cars on north-south green" << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_NOT_SET, 0, 0, 0);
+
+        // Car passig during green
+        while (numGoneNorth < totalCanPass && 
+               northQueue.dequeue(passingCar)) {
+            numGoneNorth++;
+            numTotalAdvancedNorth++;
+            recordDeparture(DIR_CODE_NORTH, passingCar);
+            SIM_TRACE("  Car #" << passingCar.getId()
+                   << " advances north-bound" << '\n');
+            SIM_RECORD(TRACE_REC_ADVANCE_GREEN, handleType, DIR_CODE_NORTH,
+                       passingCar.getId(), northQueue.getNumElems(), 0);
+        }
+        while (numGoneSouth < totalCanPass && 
+               southQueue.dequeue(passingCar)) {
+            numGoneSouth++;
+            numTotalAdvancedSouth++;
+            recordDeparture(DIR_CODE_SOUTH, passingCar);
+            SIM_TRACE("  Car #" << passingCar.getId()
+                   << " advances south-bound" << '\n');
+            SIM_RECORD(TRACE_REC_ADVANCE_GREEN, handleType, DIR_CODE_SOUTH,
+                       passingCar.getId(), southQueue.getNumElems(), 0);
+        }
+        SIM_TRACE("North-bound cars advanced on green: " << numGoneNorth
+               << " Remaining queue: " << northQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_GREEN, handleType, DIR_CODE_NORTH, 0,
+                   northQueue.getNumElems(), numGoneNorth);
+        SIM_TRACE("South-bound cars advanced on green: " << numGoneSouth
+               << " Remaining queue: " << southQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_GREEN, handleType, DIR_CODE_SOUTH, 0,
+                   southQueue.getNumElems(), numGoneSouth);
+        
+        scheduleLightChange();
+    }
+    else if (handleType == EVENT_CHANGE_GREEN_EW) {
+        int totalCouldPass = northSouthYellowTime;
+        bool keepAdv = true;
+        bool doNextAdv;
+        int numGoneNorth = 0;
+        int numGoneSouth = 0;
+        CarClass passingCar;
+
+        // change light 
+        currentLight = LIGHT_GREEN_EW;
+
+        // print
+        SIM_TRACE("\nHandling " << eventToHandle << '\n');
+        SIM_TRACE("Advancing cars on north-south yellow" << '\n');
+        SIM_RECORD(TRACE_REC_HANDLE, handleType, DIR_CODE_NOT_SET, 0, 0, 0);
+
+        // north
+        while (keepAdv) {
+            if (!northQueue.getNumElems()) {
+                SIM_TRACE("  No north-bound cars waiting to advance "
+                       << "on yellow" << '\n');
+                SIM_RECORD(TRACE_REC_NO_CARS_YELLOW, handleType,
+                           DIR_CODE_NORTH, 0, 0, 0);
+                keepAdv = false;
             }
-            cout << "North-bound cars advanced on green: " << numGoneNorth
-                 << " Remaining queue: " << northQueue.getNumElems() << endl;
-            cout << "South-bound cars advanced on green: " << numGoneSouth
-                 << " Remaining queue: " << southQueue.getNumElems() << endl;
-            
-            scheduleLightChange();
-        }
-        else if (handleType == EVENT_CHANGE_GREEN_EW) {
-            int totalCouldPass = northSouthYellowTime;
-            bool keepAdv = true;
-            bool doNextAdv;
-            int numGoneNorth = 0;
-            int numGoneSouth = 0;
-            CarClass passingCar;
-
-            // change light 
-            currentLight = LIGHT_GREEN_EW;
-
-            // print
-            cout << "\nHandling " << eventToHandle << endl;
-            cout << "Advancing cars on north-south yellow" << endl;
-
-            // north
-            while (keepAdv) {
-                if (!northQueue.getNumElems()) {
-                    cout << "  No north-bound cars waiting to advance "
-                         << "on yellow" << endl;
-                    keepAdv = false;
-                }
-                else {
-                    if (numGoneNorth < totalCouldPass) {
-                        // generate random number
-                        int random = getUniform(UNIF_LOWER_BOUND, 
-                                                UNIF_UPPER_BOUND);
-                        doNextAdv = random < percentCarsAdvanceOnYellow;
-
-                        if (doNextAdv) {
-                            northQueue.dequeue(passingCar);
-                            numGoneNorth++;
-                            numTotalAdvancedNorth++;
-
-                            // print info
-                            cout << "  Next north-bound car will advance "
-                                 << "on yellow" << endl;
-                            cout << "  Car#" << passingCar.getId() 
-                                 << " advances north-bound" << endl;
-                        }
-                        else {
-                            cout << "  Next north-bound car will NOT advance "
-                                 << "on yellow" 
-                                 << endl;
-                            keepAdv = false;
-                        }
+            else {
+                if (numGoneNorth < totalCouldPass) {
+                    // generate random number
+                    int random = getYellowDraw(DIR_CODE_NORTH);
+                    doNextAdv = random < percentCarsAdvanceOnYellow;
+
+                    if (doNextAdv) {
+                        northQueue.dequeue(passingCar);
+                        numGoneNorth++;
+                        numTotalAdvancedNorth++;
+                        recordDeparture(DIR_CODE_NORTH, passingCar);
+
+                        // print info
+                        SIM_TRACE("  Next north-bound car will advance "
+                               << "on yellow" << '\n');
+                        SIM_TRACE("  Car#" << passingCar.getId()
+                               << " advances north-bound" << '\n');
+                        SIM_RECORD(TRACE_REC_ADVANCE_YELLOW, handleType,
+                                   DIR_CODE_NORTH, passingCar.getId(),
+                                   northQueue.getNumElems(), 0);
                     }
                     else {
+                        SIM_TRACE("  Next north-bound car will NOT advance "
+                               << "on yellow"
+                               << '\n');
+                        SIM_RECORD(TRACE_REC_STOP_YELLOW, handleType,
+                                   DIR_CODE_NORTH, 0,
+                                   northQueue.getNumElems(), 0);
                         keepAdv = false;
                     }
                 }
-            }
-
-            // south
-            keepAdv = true;
-            while (keepAdv) {
-                if (!southQueue.getNumElems()) {
-                    cout << "  No south-bound cars waiting to advance "
-                         << "on yellow" << endl;
+                else {
                     keepAdv = false;
                 }
-                else {
-                    if (numGoneSouth < totalCouldPass) {
-                        // generate random number
-                        int random = getUniform(UNIF_LOWER_BOUND, 
-                                                UNIF_UPPER_BOUND);
-                        doNextAdv = random < percentCarsAdvanceOnYellow;
-
-                        if (doNextAdv) {
-                            southQueue.dequeue(passingCar);
-                            numGoneSouth++;
-                            numTotalAdvancedSouth++;
-
-                            // print info
-                            cout << "  Next south-bound car will advance "
-                                 << "on yellow" << endl;
-                            cout << "  Car#" << passingCar.getId() 
-                                 << " advances south-bound" << endl;
-                        }
-                        else {
-                            cout << "  Next south-bound car will NOT advance "
-                                 << "on yellow" 
-                                 << endl;
-                            keepAdv = false;
-                        }
+            }
+        }
+
+        // south
+        keepAdv = true;
+        while (keepAdv) {
+            if (!southQueue.getNumElems()) {
+                SIM_TRACE("  No south-bound cars waiting to advance "
+                       << "on yellow" << '\n');
+                SIM_RECORD(TRACE_REC_NO_CARS_YELLOW, handleType,
+                           DIR_CODE_SOUTH, 0, 0, 0);
+                keepAdv = false;
+            }
+            else {
+                if (numGoneSouth < totalCouldPass) {
+                    // generate random number
+                    int random = getYellowDraw(DIR_CODE_SOUTH);
+                    doNextAdv = random < percentCarsAdvanceOnYellow;
+
+                    if (doNextAdv) {
+                        southQueue.dequeue(passingCar);
+                        numGoneSouth++;
+                        numTotalAdvancedSouth++;
+                        recordDeparture(DIR_CODE_SOUTH, passingCar);
+
+                        // print info
+                        SIM_TRACE("  Next south-bound car will advance "
+                               << "on yellow" << '\n');
+                        SIM_TRACE("  Car#" << passingCar.getId()
+                               << " advances south-bound" << '\n');
+                        SIM_RECORD(TRACE_REC_ADVANCE_YELLOW, handleType,
+                                   DIR_CODE_SOUTH, passingCar.getId(),
+                                   southQueue.getNumElems(), 0);
                     }
                     else {
+                        SIM_TRACE("  Next south-bound car will NOT advance "
+                               << "on yellow"
+                               << '\n');
+                        SIM_RECORD(TRACE_REC_STOP_YELLOW, handleType,
+                                   DIR_CODE_SOUTH, 0,
+                                   southQueue.getNumElems(), 0);
                         keepAdv = false;
                     }
                 }
+                else {
+                    keepAdv = false;
+                }
             }
+        }
 
-            // print info
-            cout << "North-bound cars advanced on yellow: " << numGoneNorth
-                 << " Remaining queue: " << northQueue.getNumElems() << endl;
-            cout << "South-bound cars advanced on yellow: " << numGoneSouth
-                 << " Remaining queue: " << southQueue.getNumElems() << endl;
+        // print info
+        SIM_TRACE("North-bound cars advanced on yellow: " << numGoneNorth
+               << " Remaining queue: " << northQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_YELLOW, handleType, DIR_CODE_NORTH, 0,
+                   northQueue.getNumElems(), numGoneNorth);
+        SIM_TRACE("South-bound cars advanced on yellow: " << numGoneSouth
+               << " Remaining queue: " << southQueue.getNumElems() << '\n');
+        SIM_RECORD(TRACE_REC_SUMMARY_YELLOW, handleType, DIR_CODE_SOUTH, 0,
+                   southQueue.getNumElems(), numGoneSouth);
 
-            scheduleLightChange();
+        scheduleLightChange();
+    }
+
+    updateTimeWeightedStats();
+    //A new light cycle starts when east-west turns green
+    if (handleType == EVENT_CHANGE_GREEN_EW) {
+        if (targetPrecision > 0) {
+            observeLightCycle(currentTime);
+        }
+        else if (isFastForwardEnabled) {
+            checkForSteadyState();
         }
     }
-    return doHandleNext;
+}
+
+void IntersectionSimulationClass::updateTimeWeightedStats() {
+    const CarQueueClass *queues[NUM_DIRECTIONS] = {
+        &eastQueue, &westQueue, &northQueue, &southQueue
+    };
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        queueLengthStats[dirIdx].setValue(currentTime,
+                                          queues[dirIdx]->getNumElems());
+    }
+    eventListSizeStat.setValue(currentTime, eventList.getNumElems());
 }
 
 void IntersectionSimulationClass::printStatistics() const {
+    traceWriter.flush();
     cout << "===== Begin Simulation Statistics =====" << endl;
     cout << "  Longest east-bound queue: " << maxEastQueueLength << endl;
     cout << "  Longest west-bound queue: " << maxWestQueueLength << endl;
@@ -657,5 +1248,567 @@ void IntersectionSimulationClass::printStatistics() const {
             numTotalAdvancedNorth << endl;
     cout << "  Total cars advanced south-bound: " << 
             numTotalAdvancedSouth << endl;
+    if (isDelayTrackingEnabled) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            cout << "  Delay of " << STATS_BOUND_NAMES[dirIdx] << " cars - ";
+            delayHistograms[dirIdx].printSummary();
+        }
+    }
+    if (isQueueStatsPrinted) {
+        //Nothing changes after the last event, so the statistics run to
+        //the end of the run
+        int runEndTime = getRunEndTime();
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            const TimeWeightedStatClass &queueStat = queueLengthStats[dirIdx];
+            cout << "  Time-weighted " << STATS_BOUND_NAMES[dirIdx] <<
+                    " queue - Mean: " << queueStat.getMean(runEndTime) <<
+                    " StdDev: " << queueStat.getStdDev(runEndTime) <<
+                    " Busy: " << queueStat.getFractionNonZero(runEndTime) <<
+                    endl;
+        }
+        if (engineMode != ENGINE_LAZY_ARRIVALS) {
+            cout << "  Time-weighted pending events - Mean: " <<
+                    eventListSizeStat.getMean(runEndTime) << " StdDev: " <<
+                    eventListSizeStat.getStdDev(runEndTime) << endl;
+        }
+    }
+    if (targetPrecision > 0) {
+        printSteadyStateEstimate();
+    }
     cout << "===== End Simulation Statistics =====" << endl;
+}
+
+void IntersectionSimulationClass::printSteadyStateEstimate() const {
+    SteadyStateEstimateStruct estimate;
+
+    if (!getSteadyStateEstimate(estimate)) {
+        cout << "  Steady state: not found in the " <<
+                cycleObservations.getNumObservations() <<
+                " light cycles observed" << endl;
+        cout << "  Target precision of " << targetPrecision * 100 <<
+                "% not reached by the end time" << endl;
+        return;
+    }
+
+    cout << "  Steady state: " << estimate.numWarmupCycles <<
+            " warm-up light cycles dropped, " <<
+            STEADY_STATE_NUM_BATCHES << " batches of " <<
+            estimate.batchSize << " cycles" << endl;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        cout << "  Steady-state " << STATS_BOUND_NAMES[dirIdx] <<
+                " cars advanced per cycle: " <<
+                estimate.means[CYCLE_SERIES_ADVANCED + dirIdx] << " +/- " <<
+                estimate.halfWidths[CYCLE_SERIES_ADVANCED + dirIdx] << endl;
+        cout << "  Steady-state " << STATS_BOUND_NAMES[dirIdx] <<
+                " mean queue: " <<
+                estimate.means[CYCLE_SERIES_QUEUE_LENGTH + dirIdx] <<
+                " +/- " <<
+                estimate.halfWidths[CYCLE_SERIES_QUEUE_LENGTH + dirIdx] <<
+                endl;
+    }
+    if (isTargetPrecisionReached) {
+        cout << "  Target precision of " << targetPrecision * 100 <<
+                "% reached at time " << targetReachedTime <<
+                " (achieved: " << estimate.maxRelativeHalfWidth * 100 <<
+                "%)" << endl;
+    }
+    else {
+        cout << "  Target precision of " << targetPrecision * 100 <<
+                "% not reached by the end time (achieved: " <<
+                estimate.maxRelativeHalfWidth * 100 << "%)" << endl;
+    }
+}
+
+int IntersectionSimulationClass::getMaxQueueLength(
+                                 const unsigned char dirCode) const {
+    if (dirCode == DIR_CODE_EAST) {
+        return maxEastQueueLength;
+    }
+    else if (dirCode == DIR_CODE_WEST) {
+        return maxWestQueueLength;
+    }
+    else if (dirCode == DIR_CODE_NORTH) {
+        return maxNorthQueueLength;
+    }
+    else if (dirCode == DIR_CODE_SOUTH) {
+        return maxSouthQueueLength;
+    }
+    return 0;
+}
+
+int IntersectionSimulationClass::getNumTotalAdvanced(
+                                 const unsigned char dirCode) const {
+    if (dirCode == DIR_CODE_EAST) {
+        return numTotalAdvancedEast;
+    }
+    else if (dirCode == DIR_CODE_WEST) {
+        return numTotalAdvancedWest;
+    }
+    else if (dirCode == DIR_CODE_NORTH) {
+        return numTotalAdvancedNorth;
+    }
+    else if (dirCode == DIR_CODE_SOUTH) {
+        return numTotalAdvancedSouth;
+    }
+    return 0;
+}
+
+void IntersectionSimulationClass::getResults(
+                                  SimulationResultStruct &results) const {
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        unsigned char dirCode = (unsigned char)dirIdx;
+        results.maxQueueLengths[dirIdx] = getMaxQueueLength(dirCode);
+        results.numAdvanced[dirIdx] = getNumTotalAdvanced(dirCode);
+        results.meanQueueLengths[dirIdx] =
+                queueLengthStats[dirIdx].getMean(getRunEndTime());
+        results.meanDelays[dirIdx] = isDelayTrackingEnabled ?
+                                     delayHistograms[dirIdx].getMean() : 0;
+    }
+}
+
+void IntersectionSimulationClass::copyRunState(
+                                  const IntersectionSimulationClass &source) {
+    currentTime = source.currentTime;
+    currentLight = source.currentLight;
+    randomGenerator = source.randomGenerator;
+    nextCarId = source.nextCarId;
+    //The arrival generators are only used with the Philox generator, and
+    //are most of the object's size
+    if (randomGenerator.getMode() == RANDOM_MODE_PHILOX) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            arrivalGenerators[dirIdx] = source.arrivalGenerators[dirIdx];
+            yellowGenerators[dirIdx] = source.yellowGenerators[dirIdx];
+        }
+    }
+    lastLightChangeTime = source.lastLightChangeTime;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        pendingArrivalTimes[dirIdx] = source.pendingArrivalTimes[dirIdx];
+        pendingParentTimes[dirIdx] = source.pendingParentTimes[dirIdx];
+        isPendingParentFirst[dirIdx] = source.isPendingParentFirst[dirIdx];
+        departedCars[dirIdx] = source.departedCars[dirIdx];
+    }
+    isFastForwardDone = source.isFastForwardDone;
+    hasSavedCycleState = source.hasSavedCycleState;
+    savedCycleState = source.savedCycleState;
+    numCyclesSinceSave = source.numCyclesSinceSave;
+    numCyclesBeforeSave = source.numCyclesBeforeSave;
+    eventList = source.eventList;
+    eastQueue = source.eastQueue;
+    westQueue = source.westQueue;
+    northQueue = source.northQueue;
+    southQueue = source.southQueue;
+
+    maxEastQueueLength = source.maxEastQueueLength;
+    maxWestQueueLength = source.maxWestQueueLength;
+    maxNorthQueueLength = source.maxNorthQueueLength;
+    maxSouthQueueLength = source.maxSouthQueueLength;
+    numTotalAdvancedEast = source.numTotalAdvancedEast;
+    numTotalAdvancedWest = source.numTotalAdvancedWest;
+    numTotalAdvancedNorth = source.numTotalAdvancedNorth;
+    numTotalAdvancedSouth = source.numTotalAdvancedSouth;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        queueLengthStats[dirIdx] = source.queueLengthStats[dirIdx];
+        savedQueueLengthStats[dirIdx] = source.savedQueueLengthStats[dirIdx];
+    }
+    eventListSizeStat = source.eventListSizeStat;
+    savedEventListSizeStat = source.savedEventListSizeStat;
+    if (isDelayTrackingEnabled) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            delayHistograms[dirIdx] = source.delayHistograms[dirIdx];
+            savedDelayHistograms[dirIdx] = source.savedDelayHistograms[dirIdx];
+        }
+    }
+    cycleObservations = source.cycleObservations;
+    cycleStartTime = source.cycleStartTime;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        cycleStartNumAdvanced[dirIdx] = source.cycleStartNumAdvanced[dirIdx];
+        cycleStartQueueIntegrals[dirIdx] =
+                                 source.cycleStartQueueIntegrals[dirIdx];
+    }
+    numCyclesAtNextCheck = source.numCyclesAtNextCheck;
+    isTargetPrecisionReached = source.isTargetPrecisionReached;
+    targetReachedTime = source.targetReachedTime;
+}
+
+void IntersectionSimulationClass::forkInto(
+                                  IntersectionSimulationClass &outBranch) {
+    traceWriter.flush();
+    eastQueue.freezeContents();
+    westQueue.freezeContents();
+    northQueue.freezeContents();
+    southQueue.freezeContents();
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        departedCars[dirIdx].freezeContents();
+    }
+
+    //Copying a queue now only takes references to its segments
+    outBranch = *this;
+}
+
+//Writes the cars in a queue to a snapshot file, front first.
+static void writeCarQueueSnapshot(SnapshotFileClass &snapshotFile,
+                                  const CarQueueClass &carQueue) {
+    CarQueueClass remainingCars;
+    CarClass queuedCar;
+
+    remainingCars = carQueue;
+    snapshotFile.writeValue(remainingCars.getNumElems());
+    while (remainingCars.dequeue(queuedCar)) {
+        snapshotFile.writeValue(queuedCar.getId());
+        snapshotFile.writeValue(queuedCar.getArrivalTime());
+        snapshotFile.writeValue((int)queuedCar.getTravelDirCode());
+    }
+}
+
+//Replaces the cars in a queue with those written by writeCarQueueSnapshot.
+static void readCarQueueSnapshot(SnapshotFileClass &snapshotFile,
+                                 CarQueueClass &carQueue) {
+    int numCars = 0;
+    int carId = 0;
+    int arrivalTime = 0;
+    int dirCode = 0;
+
+    carQueue.clear();
+    snapshotFile.readValue(numCars);
+    if (numCars < 0) {
+        snapshotFile.markFailed();
+    }
+    for (int carIdx = 0; carIdx < numCars && !snapshotFile.getIsFailed();
+         carIdx++) {
+        snapshotFile.readValue(carId);
+        snapshotFile.readValue(arrivalTime);
+        snapshotFile.readValue(dirCode);
+        if (dirCode < 0 || dirCode >= NUM_DIRECTIONS) {
+            snapshotFile.markFailed();
+        }
+        else {
+            carQueue.enqueue(CarClass(carId, (unsigned char)dirCode,
+                                      arrivalTime));
+        }
+    }
+}
+
+//Returns the sizes of the parts of a snapshot that are stored as they are
+//laid out in memory, for the snapshot file's header.
+static void getSnapshotLayoutSizes(unsigned int layoutSizes[4]) {
+    layoutSizes[0] = sizeof(RandomGeneratorClass);
+    layoutSizes[1] = sizeof(ArrivalGeneratorClass);
+    layoutSizes[2] = sizeof(CycleStateStruct);
+    layoutSizes[3] = sizeof(TimeWeightedStatClass);
+}
+
+void IntersectionSimulationClass::getSnapshotParameters(
+                           SnapshotParametersStruct &outParameters) const {
+    //Cleared first so the padding compares equal too
+    memset(&outParameters, 0, sizeof(outParameters));
+    outParameters.randomSeedVal = randomSeedVal;
+    outParameters.timeToStopSim = timeToStopSim;
+    outParameters.lightTimes[0] = eastWestGreenTime;
+    outParameters.lightTimes[1] = eastWestYellowTime;
+    outParameters.lightTimes[2] = northSouthGreenTime;
+    outParameters.lightTimes[3] = northSouthYellowTime;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        getArrivalDistribution(dirIdx, outParameters.arrivalMeans[dirIdx],
+                               outParameters.arrivalStdDevs[dirIdx]);
+        outParameters.isApproachLinked[dirIdx] = isApproachLinked[dirIdx];
+        outParameters.isRecordingDepartures[dirIdx] =
+                      isRecordingDepartures[dirIdx];
+    }
+    outParameters.percentCarsAdvanceOnYellow = percentCarsAdvanceOnYellow;
+    outParameters.randomMode = randomGenerator.getMode();
+    outParameters.randomStreamId = randomStreamId;
+    outParameters.engineMode = engineMode;
+    outParameters.isDelayTrackingEnabled = isDelayTrackingEnabled;
+    outParameters.targetPrecision = targetPrecision;
+    outParameters.isAntithetic = isAntithetic;
+}
+
+bool IntersectionSimulationClass::saveSnapshot(
+                                  const string &snapshotFname) const {
+    SnapshotFileClass snapshotFile;
+    unsigned int layoutSizes[4];
+    SnapshotParametersStruct parameters;
+    EventListType pendingEvents;
+    EventClass pendingEvent;
+
+    traceWriter.flush();
+    getSnapshotLayoutSizes(layoutSizes);
+    if (!snapshotFile.openForWriting(snapshotFname, layoutSizes)) {
+        cout << "ERROR: Unable to create snapshot file: " << snapshotFname <<
+                endl;
+        return false;
+    }
+
+    getSnapshotParameters(parameters);
+    snapshotFile.writeValue(parameters);
+
+    snapshotFile.writeValue(currentTime);
+    snapshotFile.writeValue(currentLight);
+    snapshotFile.writeValue(randomGenerator);
+    snapshotFile.writeValue(nextCarId);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.writeValue(arrivalGenerators[dirIdx]);
+        snapshotFile.writeValue(yellowGenerators[dirIdx]);
+    }
+    snapshotFile.writeValue(lastLightChangeTime);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.writeValue(pendingArrivalTimes[dirIdx]);
+        snapshotFile.writeValue(pendingParentTimes[dirIdx]);
+        snapshotFile.writeValue(isPendingParentFirst[dirIdx]);
+        writeCarQueueSnapshot(snapshotFile, departedCars[dirIdx]);
+    }
+    snapshotFile.writeValue(isFastForwardDone);
+    snapshotFile.writeValue(hasSavedCycleState);
+    snapshotFile.writeValue(savedCycleState);
+    snapshotFile.writeValue(numCyclesSinceSave);
+    snapshotFile.writeValue(numCyclesBeforeSave);
+
+    //The events are written in the order they'll be handled, which is
+    //the order restoring them puts them back in, keeping the order of
+    //those at equal times
+    pendingEvents = eventList;
+    snapshotFile.writeValue(pendingEvents.getNumElems());
+    while (pendingEvents.removeFront(pendingEvent)) {
+        snapshotFile.writeValue(pendingEvent.getTimeOccurs());
+        snapshotFile.writeValue(pendingEvent.getType());
+    }
+    writeCarQueueSnapshot(snapshotFile, eastQueue);
+    writeCarQueueSnapshot(snapshotFile, westQueue);
+    writeCarQueueSnapshot(snapshotFile, northQueue);
+    writeCarQueueSnapshot(snapshotFile, southQueue);
+
+    snapshotFile.writeValue(maxEastQueueLength);
+    snapshotFile.writeValue(maxWestQueueLength);
+    snapshotFile.writeValue(maxNorthQueueLength);
+    snapshotFile.writeValue(maxSouthQueueLength);
+    snapshotFile.writeValue(numTotalAdvancedEast);
+    snapshotFile.writeValue(numTotalAdvancedWest);
+    snapshotFile.writeValue(numTotalAdvancedNorth);
+    snapshotFile.writeValue(numTotalAdvancedSouth);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.writeValue(queueLengthStats[dirIdx]);
+        snapshotFile.writeValue(savedQueueLengthStats[dirIdx]);
+    }
+    snapshotFile.writeValue(eventListSizeStat);
+    snapshotFile.writeValue(savedEventListSizeStat);
+    if (isDelayTrackingEnabled) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            delayHistograms[dirIdx].writeSnapshot(snapshotFile);
+            savedDelayHistograms[dirIdx].writeSnapshot(snapshotFile);
+        }
+    }
+    cycleObservations.writeSnapshot(snapshotFile);
+    snapshotFile.writeValue(cycleStartTime);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.writeValue(cycleStartNumAdvanced[dirIdx]);
+        snapshotFile.writeValue(cycleStartQueueIntegrals[dirIdx]);
+    }
+    snapshotFile.writeValue(numCyclesAtNextCheck);
+    snapshotFile.writeValue(isTargetPrecisionReached);
+    snapshotFile.writeValue(targetReachedTime);
+
+    if (!snapshotFile.close()) {
+        cout << "ERROR: Unable to write snapshot file: " << snapshotFname <<
+                endl;
+        return false;
+    }
+    return true;
+}
+
+bool IntersectionSimulationClass::restoreSnapshot(
+                                  const string &snapshotFname) {
+    SnapshotFileClass snapshotFile;
+    unsigned int layoutSizes[4];
+    SnapshotParametersStruct parameters;
+    SnapshotParametersStruct snapshotParameters;
+    int numEvents = 0;
+    int eventTime = 0;
+    int eventType = 0;
+
+    traceWriter.flush();
+    getSnapshotLayoutSizes(layoutSizes);
+    if (!snapshotFile.openForReading(snapshotFname, layoutSizes)) {
+        return false;
+    }
+
+    getSnapshotParameters(parameters);
+    memset(&snapshotParameters, 0, sizeof(snapshotParameters));
+    snapshotFile.readValue(snapshotParameters);
+    if (snapshotFile.getIsFailed()) {
+        cout << "ERROR: Snapshot file is truncated: " << snapshotFname << endl;
+        snapshotFile.close();
+        return false;
+    }
+    if (memcmp(&parameters, &snapshotParameters, sizeof(parameters))) {
+        cout << "ERROR: Snapshot " << snapshotFname <<
+                " was taken with different parameters" << endl;
+        snapshotFile.close();
+        return false;
+    }
+
+    //The arrival generators keep refilling with this machine's best
+    //kernel rather than the one they were saved with
+    int arrivalKernels[NUM_DIRECTIONS];
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        arrivalKernels[dirIdx] = arrivalGenerators[dirIdx].getKernel();
+    }
+
+    snapshotFile.readValue(currentTime);
+    snapshotFile.readValue(currentLight);
+    snapshotFile.readValue(randomGenerator);
+    snapshotFile.readValue(nextCarId);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.readValue(arrivalGenerators[dirIdx]);
+        arrivalGenerators[dirIdx].setKernel(arrivalKernels[dirIdx]);
+        snapshotFile.readValue(yellowGenerators[dirIdx]);
+    }
+    snapshotFile.readValue(lastLightChangeTime);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.readValue(pendingArrivalTimes[dirIdx]);
+        snapshotFile.readValue(pendingParentTimes[dirIdx]);
+        snapshotFile.readValue(isPendingParentFirst[dirIdx]);
+        readCarQueueSnapshot(snapshotFile, departedCars[dirIdx]);
+    }
+    snapshotFile.readValue(isFastForwardDone);
+    snapshotFile.readValue(hasSavedCycleState);
+    snapshotFile.readValue(savedCycleState);
+    snapshotFile.readValue(numCyclesSinceSave);
+    snapshotFile.readValue(numCyclesBeforeSave);
+
+    eventList.clear();
+    snapshotFile.readValue(numEvents);
+    if (numEvents < 0) {
+        snapshotFile.markFailed();
+    }
+    for (int eventIdx = 0; eventIdx < numEvents && !snapshotFile.getIsFailed();
+         eventIdx++) {
+        snapshotFile.readValue(eventTime);
+        snapshotFile.readValue(eventType);
+        if (eventTime < currentTime || eventType < EVENT_ARRIVE_EAST ||
+            eventType > EVENT_ENTER_SOUTH) {
+            snapshotFile.markFailed();
+        }
+        else {
+            eventList.insertValue(EventClass(eventTime, eventType));
+        }
+    }
+    readCarQueueSnapshot(snapshotFile, eastQueue);
+    readCarQueueSnapshot(snapshotFile, westQueue);
+    readCarQueueSnapshot(snapshotFile, northQueue);
+    readCarQueueSnapshot(snapshotFile, southQueue);
+
+    snapshotFile.readValue(maxEastQueueLength);
+    snapshotFile.readValue(maxWestQueueLength);
+    snapshotFile.readValue(maxNorthQueueLength);
+    snapshotFile.readValue(maxSouthQueueLength);
+    snapshotFile.readValue(numTotalAdvancedEast);
+    snapshotFile.readValue(numTotalAdvancedWest);
+    snapshotFile.readValue(numTotalAdvancedNorth);
+    snapshotFile.readValue(numTotalAdvancedSouth);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.readValue(queueLengthStats[dirIdx]);
+        snapshotFile.readValue(savedQueueLengthStats[dirIdx]);
+    }
+    snapshotFile.readValue(eventListSizeStat);
+    snapshotFile.readValue(savedEventListSizeStat);
+    if (isDelayTrackingEnabled) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            delayHistograms[dirIdx].readSnapshot(snapshotFile);
+            savedDelayHistograms[dirIdx].readSnapshot(snapshotFile);
+        }
+    }
+    cycleObservations.readSnapshot(snapshotFile);
+    snapshotFile.readValue(cycleStartTime);
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        snapshotFile.readValue(cycleStartNumAdvanced[dirIdx]);
+        snapshotFile.readValue(cycleStartQueueIntegrals[dirIdx]);
+    }
+    snapshotFile.readValue(numCyclesAtNextCheck);
+    snapshotFile.readValue(isTargetPrecisionReached);
+    snapshotFile.readValue(targetReachedTime);
+
+    if (!snapshotFile.close()) {
+        cout << "ERROR: Snapshot file is damaged: " << snapshotFname << endl;
+        isSetupProperly = false;
+        return false;
+    }
+    return true;
+}
+
+bool IntersectionSimulationClass::setLightTimes(
+                                  const int inEastWestGreenTime,
+                                  const int inEastWestYellowTime,
+                                  const int inNorthSouthGreenTime,
+                                  const int inNorthSouthYellowTime) {
+    if (inEastWestGreenTime <= 0 || inEastWestYellowTime <= 0 ||
+        inNorthSouthGreenTime <= 0 || inNorthSouthYellowTime <= 0 ||
+        (engineMode == ENGINE_LAZY_ARRIVALS && lastLightChangeTime != -1)) {
+        return false;
+    }
+    //Cycle starts seen with the old times can't predict those with the
+    //new ones
+    hasSavedCycleState = false;
+    numCyclesSinceSave = 0;
+    numCyclesBeforeSave = 1;
+
+    eastWestGreenTime = inEastWestGreenTime;
+    eastWestYellowTime = inEastWestYellowTime;
+    northSouthGreenTime = inNorthSouthGreenTime;
+    northSouthYellowTime = inNorthSouthYellowTime;
+    signalPlan.setLightTimes(eastWestGreenTime, eastWestYellowTime,
+                             northSouthGreenTime, northSouthYellowTime);
+    return true;
+}
+
+bool IntersectionSimulationClass::setArrivalDistribution(
+                                  const unsigned char dirCode,
+                                  const double meanVal,
+                                  const double stdDev) {
+    if (meanVal <= 0 || stdDev < 0) {
+        return false;
+    }
+    if (dirCode == DIR_CODE_EAST) {
+        eastArrivalMean = meanVal;
+        eastArrivalStdDev = stdDev;
+    }
+    else if (dirCode == DIR_CODE_WEST) {
+        westArrivalMean = meanVal;
+        westArrivalStdDev = stdDev;
+    }
+    else if (dirCode == DIR_CODE_NORTH) {
+        northArrivalMean = meanVal;
+        northArrivalStdDev = stdDev;
+    }
+    else if (dirCode == DIR_CODE_SOUTH) {
+        southArrivalMean = meanVal;
+        southArrivalStdDev = stdDev;
+    }
+    else {
+        return false;
+    }
+    setupApproachGenerators();
+    return true;
+}
+
+void IntersectionSimulationClass::getArrivalDistribution(
+                                  const unsigned char dirCode,
+                                  double &meanVal, double &stdDev) const {
+    meanVal = 0;
+    stdDev = 0;
+    if (dirCode == DIR_CODE_EAST) {
+        meanVal = eastArrivalMean;
+        stdDev = eastArrivalStdDev;
+    }
+    else if (dirCode == DIR_CODE_WEST) {
+        meanVal = westArrivalMean;
+        stdDev = westArrivalStdDev;
+    }
+    else if (dirCode == DIR_CODE_NORTH) {
+        meanVal = northArrivalMean;
+        stdDev = northArrivalStdDev;
+    }
+    else if (dirCode == DIR_CODE_SOUTH) {
+        meanVal = southArrivalMean;
+        stdDev = southArrivalStdDev;
+    }
 }
\ No newline at end of file
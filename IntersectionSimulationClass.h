@@ -5,11 +5,128 @@
 //Note: not "using namespace std" in header files, so will have to
 //      prepend all items from the std namespace with "std::" here
 #include "SortedListClass.h"
+#include "DaryHeapClass.h"
+#include "PairingHeapClass.h"
+#include "TimingWheelClass.h"
+#include "PoolNodeAllocatorClass.h"
 #include "EventClass.h"
-#include "FIFOQueueClass.h"
+#include "CarQueueClass.h"
 #include "CarClass.h"
+#include "TraceWriterClass.h"
+#include "BinaryTraceWriterClass.h"
+#include "RandomGeneratorClass.h"
+#include "ArrivalGeneratorClass.h"
+#include "SignalPlanClass.h"
+#include "LogHistogramClass.h"
+#include "TimeWeightedStatClass.h"
+#include "SnapshotFileClass.h"
+#include "BatchMeansClass.h"
 #include "constants.h"
 
+//The container holding the pending events is chosen at compile time via
+//the EVENT_LIST variable in the Makefile.  Every choice breaks ties
+//between events scheduled for the same time in FIFO order, so the
+//simulation output does not depend on which one is used.  The
+//node-based containers recycle their nodes through a pool, so none of
+//the choices touch the heap per event once the run has warmed up.
+#if defined(EVENT_LIST_SORTED_LIST)
+typedef SortedListClass<EventClass, PoolNodeAllocatorClass> EventListType;
+#elif defined(EVENT_LIST_BINARY_HEAP)
+typedef DaryHeapClass<EventClass, 2> EventListType;
+#elif defined(EVENT_LIST_PAIRING_HEAP)
+typedef PairingHeapClass<EventClass, PoolNodeAllocatorClass> EventListType;
+#elif defined(EVENT_LIST_QUATERNARY_HEAP)
+typedef DaryHeapClass<EventClass, 4> EventListType;
+#else
+typedef TimingWheelClass<EventClass> EventListType;
+#endif
+
+//The statistics one run of a simulation produced, per approach (indexed
+//by DIR_CODE_* value).
+struct SimulationResultStruct {
+    int maxQueueLengths[NUM_DIRECTIONS];
+    int numAdvanced[NUM_DIRECTIONS];
+    double meanQueueLengths[NUM_DIRECTIONS]; //Time-weighted, up to the
+                                             //end time
+    double meanDelays[NUM_DIRECTIONS]; //Of the cars that advanced, or 0
+                                       //if delays aren't tracked
+};
+
+//Most values used to describe a simulation's state at a light cycle
+//boundary (see CycleStateStruct)
+const int CYCLE_STATE_MAX_KEY_VALS = 4 * NUM_DIRECTIONS;
+
+//Most events pending at a light cycle boundary in the per-event engine:
+//the next arrival from each approach and the next light change
+const int CYCLE_STATE_MAX_EVENTS = NUM_DIRECTIONS + 1;
+
+//A simulation's state at the start of a light cycle, when its arrivals
+//and yellow-light decisions don't depend on random draws.  The key values
+//(queue lengths, then the pending events' types and times relative to the
+//cycle start in handling order, or for the lazy arrival engine the
+//pending and previous arrival times and tie flags) decide everything the
+//simulation does from there on, so two cycle starts with the same key
+//values are followed by the same statistics.
+struct CycleStateStruct {
+    int keyVals[CYCLE_STATE_MAX_KEY_VALS];
+    int numKeyVals;
+    unsigned int keyHash;     //Hash of the key values, for quick compares
+    int cycleStartTime;       //Time the cycle started
+    int numAdvanced[NUM_DIRECTIONS]; //Cars advanced by then, by approach
+};
+
+//The values a simulation observes in each light cycle for its
+//steady-state estimates (see setTargetPrecision): the cars advanced from
+//each approach during the cycle, then the time-weighted mean length of
+//each queue over it, each by DIR_CODE_* value
+const int CYCLE_SERIES_ADVANCED = 0;
+const int CYCLE_SERIES_QUEUE_LENGTH = NUM_DIRECTIONS;
+const int CYCLE_NUM_SERIES = 2 * NUM_DIRECTIONS;
+
+//Fewest light cycles left after the warm-up for steady-state estimates
+const int STEADY_STATE_MIN_CYCLES = 100;
+
+//Number of batches the light cycles after the warm-up are split into
+const int STEADY_STATE_NUM_BATCHES = 20;
+
+//Largest lag-1 autocorrelation of the batch means of every value at which
+//the batches are taken to be long enough to be close to independent, so
+//their confidence intervals can be trusted
+const double STEADY_STATE_MAX_CORRELATION = 0.2;
+
+//Steady-state estimates of the values observed in each light cycle, from
+//the means of equal batches of the cycles after the warm-up.  The
+//half-widths are those of 95% confidence intervals.
+struct SteadyStateEstimateStruct {
+    int numWarmupCycles;  //Light cycles dropped as warm-up
+    int batchSize;        //Light cycles per batch
+    double means[CYCLE_NUM_SERIES];      //By CYCLE_SERIES_* value
+    double halfWidths[CYCLE_NUM_SERIES]; //By CYCLE_SERIES_* value
+    double maxRelativeHalfWidth; //Largest half-width relative to its mean,
+                                 //over the values with a mean other than 0
+    double maxBatchCorrelation;  //Largest lag-1 autocorrelation of the
+                                 //batch means of a value
+};
+
+//The parameters a simulation snapshot was taken with, which a simulation
+//must also have to restore it (see saveSnapshot)
+struct SnapshotParametersStruct {
+    int randomSeedVal;
+    int timeToStopSim;
+    int lightTimes[4];  //East-west green and yellow, then north-south
+    double arrivalMeans[NUM_DIRECTIONS];   //By DIR_CODE_* value
+    double arrivalStdDevs[NUM_DIRECTIONS]; //By DIR_CODE_* value
+    int percentCarsAdvanceOnYellow;
+    int randomMode;
+    unsigned int randomStreamId;
+    int engineMode;
+    bool isDelayTrackingEnabled;
+    double targetPrecision;
+    bool isAntithetic;
+    bool isApproachLinked[NUM_DIRECTIONS];
+    bool isRecordingDepartures[NUM_DIRECTIONS];
+};
+
 //Programmer: Andrew Morgan
 //Date: November 2020
 //Purpose: A class that will act as the basis for an event-driven
@@ -21,6 +138,13 @@ class IntersectionSimulationClass {
           bool isSetupProperly; //Indicates whether this simulation object
                                 //is set up properly and is expected to be
                                 //in a state that is ready to run.
+          int verbosityLevel; //How much is written to the console, as one
+                              //of the VERBOSITY_* constants
+          mutable TraceWriterClass traceWriter; //Buffers the event trace
+                              //on its way to the console; flushed before
+                              //the simulation prints anything else
+          BinaryTraceWriterClass binaryTraceWriter; //Writes the binary
+                              //event trace, when one has been requested
 
           //Simulation control parameter attributes:
           int randomSeedVal; //Seed value to use for the random number generator
@@ -36,6 +160,9 @@ class IntersectionSimulationClass {
                                    //will be green in the north-south direction
           int northSouthYellowTime;//Number of "time tics" that the light
                                    //will be yellow in the north-south direction
+          SignalPlanClass signalPlan; //The same light times as a periodic
+                                      //plan, for finding light changes
+                                      //without scheduling them
           //Note: Not storing northSouthRedTime, because we don't want to store
           //      "compute-able data" and the NS red time is just the sum of
           //      the EW green and yellow times.
@@ -69,13 +196,70 @@ class IntersectionSimulationClass {
           int currentTime; 
           //The state of the traffic light at the current sim time
           int currentLight; 
-          SortedListClass<EventClass> eventList;//The time-sorted list of events
-                                                //currently scheduled to occur
-          FIFOQueueClass<CarClass> eastQueue; //Queue of cars waiting to advance
-                                              //through intersection east-bound
-          FIFOQueueClass<CarClass> westQueue; //West-bound queue of cars
-          FIFOQueueClass<CarClass> northQueue; //North-bound queue of cars
-          FIFOQueueClass<CarClass> southQueue; //South-bound queue of cars
+          //This simulation's own random number generator and car id
+          //counter, so that simulations don't affect each other's results
+          //and can run at the same time
+          RandomGeneratorClass randomGenerator;
+          int nextCarId; //Id given to the next car that arrives
+          unsigned int randomStreamId; //Random stream given to the
+                                       //generators (Philox mode only)
+          //With the Philox generator, each approach's inter-arrival
+          //times come from its own buffered generator instead, and its
+          //yellow-light decisions from its own substream, indexed by
+          //DIR_CODE_* value.  Every approach then draws the same values
+          //whatever the light times, so setups that are compared with
+          //the same seed see the same traffic (common random numbers).
+          ArrivalGeneratorClass arrivalGenerators[NUM_DIRECTIONS];
+          RandomGeneratorClass yellowGenerators[NUM_DIRECTIONS];
+          bool isAntithetic; //Whether every draw is the antithetic
+                             //variate of the plain one (Philox mode only)
+
+          //Lazy arrival engine state (see setEngineMode), indexed by
+          //DIR_CODE_* value.  Each approach's next arrival is only known
+          //by its time until a light change needs it in the queue.
+          int engineMode; //ENGINE_* value the simulation runs with
+          int lastLightChangeTime; //Time of the light change before the
+                                   //one being handled
+          int pendingArrivalTimes[NUM_DIRECTIONS]; //Time of each approach's
+                                   //next arrival not yet in its queue
+          int pendingParentTimes[NUM_DIRECTIONS]; //Time of the arrival
+                                   //before it (-1 for the first arrival)
+          bool isPendingParentFirst[NUM_DIRECTIONS]; //Whether that arrival
+                                   //came before a light change at the same
+                                   //time (the first arrivals come before
+                                   //the first light change)
+          //Steady state fast-forward (see setIsFastForwardEnabled), using
+          //Brent's cycle detection on the state at each cycle start
+          bool isFastForwardEnabled; //Whether to look for a steady state
+          bool isFastForwardDone; //Whether the run has been fast-forwarded
+          bool hasSavedCycleState; //Whether savedCycleState is set yet
+          CycleStateStruct savedCycleState; //Cycle start state compared
+                                   //against each new cycle start's
+          int numCyclesSinceSave;  //Cycles started since it was saved
+          int numCyclesBeforeSave; //Cycles after which it is replaced
+          LogHistogramClass savedDelayHistograms[NUM_DIRECTIONS]; //The
+                                   //delays as they were then, when they
+                                   //are being tracked
+          TimeWeightedStatClass savedQueueLengthStats[NUM_DIRECTIONS];
+          TimeWeightedStatClass savedEventListSizeStat; //The time-weighted
+                                   //statistics as they were then
+          //Links to neighbouring intersections in a network (see
+          //NetworkSimulationClass), indexed by DIR_CODE_* value
+          bool isApproachLinked[NUM_DIRECTIONS]; //Whether the approach's
+                                   //cars come from a linked intersection
+                                   //instead of its arrival distribution
+          bool isRecordingDepartures[NUM_DIRECTIONS]; //Whether cars that
+                                   //advance are kept in departedCars
+          CarQueueClass departedCars[NUM_DIRECTIONS]; //Cars that advanced
+                                   //and haven't been taken yet, with the
+                                   //time they advanced as arrival time
+          EventListType eventList; //The time-ordered collection of events
+                                   //currently scheduled to occur
+          CarQueueClass eastQueue; //Queue of cars waiting to advance
+                                   //through intersection east-bound
+          CarQueueClass westQueue; //West-bound queue of cars
+          CarQueueClass northQueue; //North-bound queue of cars
+          CarQueueClass southQueue; //South-bound queue of cars
 
           //Statistics-Related attributes
           int maxEastQueueLength;
@@ -86,11 +270,37 @@ class IntersectionSimulationClass {
           int numTotalAdvancedWest;
           int numTotalAdvancedNorth;
           int numTotalAdvancedSouth;
+          bool isDelayTrackingEnabled; //Whether delays are recorded (see
+                                       //setIsDelayTrackingEnabled)
+          LogHistogramClass delayHistograms[NUM_DIRECTIONS]; //Time each
+                                   //car that advanced waited, from arriving
+                                   //to advancing, by DIR_CODE_* value
+          TimeWeightedStatClass queueLengthStats[NUM_DIRECTIONS]; //Each
+                                   //queue's length over time, by DIR_CODE_*
+                                   //value
+          TimeWeightedStatClass eventListSizeStat; //Number of pending
+                                   //events over time (per-event engine)
+          bool isQueueStatsPrinted; //Whether printStatistics includes the
+                                    //time-weighted statistics
+          //Steady-state estimates (see setTargetPrecision), from one
+          //observation of the CYCLE_SERIES_* values per light cycle
+          double targetPrecision; //Relative half-width at which the run
+                                  //stops, or 0 to run to the end time
+          BatchMeansClass cycleObservations; //The observations so far
+          int cycleStartTime; //Time the cycle being observed started
+          int cycleStartNumAdvanced[NUM_DIRECTIONS]; //Cars advanced by then
+          long cycleStartQueueIntegrals[NUM_DIRECTIONS]; //Integrals of the
+                                  //queue lengths by then
+          int numCyclesAtNextCheck; //Observations at which the estimates
+                                    //are next checked against the target
+          bool isTargetPrecisionReached; //Whether the run stopped early
+          int targetReachedTime;  //Time at which it did
      public:
           //Explicit default ctor - sets the state of the sim to be NOT yet
           //setup properly.
           IntersectionSimulationClass() {
                isSetupProperly = false;
+               verbosityLevel = VERBOSITY_TRACE;
                //no need to initialize other params here, since the 
                //isSetupProperly boolean is used to indicate the other params 
                //can't be trusted yet.
@@ -98,6 +308,26 @@ class IntersectionSimulationClass {
                //Set up the initial state of the simulation itself..
                currentTime = 0;
                currentLight = LIGHT_GREEN_EW;
+               nextCarId = 0;
+               randomStreamId = 0;
+               engineMode = ENGINE_PER_EVENT;
+               isAntithetic = false;
+               lastLightChangeTime = -1;
+               isFastForwardEnabled = false;
+               isFastForwardDone = false;
+               hasSavedCycleState = false;
+               numCyclesSinceSave = 0;
+               numCyclesBeforeSave = 1;
+               for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                    isApproachLinked[dirIdx] = false;
+                    isRecordingDepartures[dirIdx] = false;
+                    pendingArrivalTimes[dirIdx] = 0;
+                    pendingParentTimes[dirIdx] = -1;
+                    isPendingParentFirst[dirIdx] = true;
+                    cycleStartNumAdvanced[dirIdx] = 0;
+                    cycleStartQueueIntegrals[dirIdx] = 0;
+               }
+               cycleStartTime = 0;
 
                //Initialize stats
                maxEastQueueLength = 0;
@@ -108,6 +338,12 @@ class IntersectionSimulationClass {
                numTotalAdvancedWest = 0;
                numTotalAdvancedNorth = 0;
                numTotalAdvancedSouth = 0;
+               isDelayTrackingEnabled = false;
+               isQueueStatsPrinted = false;
+               targetPrecision = 0;
+               numCyclesAtNextCheck = STEADY_STATE_MIN_CYCLES;
+               isTargetPrecisionReached = false;
+               targetReachedTime = 0;
           }
      
           //Returns true if this simulation is ready to be executed, false 
@@ -115,6 +351,19 @@ class IntersectionSimulationClass {
           bool getIsSetupProperly() const {
                return isSetupProperly;
           }
+
+          //Sets how much the simulation writes to the console, as one of
+          //the VERBOSITY_* constants.  The default is VERBOSITY_TRACE, which
+          //prints every event as it is scheduled and handled; at the lower
+          //levels only errors are printed by the simulation itself.
+          void setVerbosityLevel(const int inVerbosityLevel) {
+               verbosityLevel = inVerbosityLevel;
+          }
+
+          //Returns the current verbosity level (a VERBOSITY_* constant).
+          int getVerbosityLevel() const {
+               return verbosityLevel;
+          }
      
           //Reads a full set of simulation control parameters from a text file.
           //When successful, the simulation object will have its control
@@ -128,6 +377,142 @@ class IntersectionSimulationClass {
      
           //Print the simulation control parameters to the console
           void printParameters() const;
+
+          //Starts each approach's arrival and yellow-light generators
+          //from the current seed and stream, the arrival generator with
+          //that approach's arrival distribution.
+          void setupApproachGenerators();
+
+          //Returns the uniform draw that decides whether the next car on
+          //the given approach (a DIR_CODE_* value) advances on yellow.
+          int getYellowDraw(const unsigned char dirCode) {
+               if (randomGenerator.getMode() != RANDOM_MODE_PHILOX) {
+                    return randomGenerator.getUniform(UNIF_LOWER_BOUND,
+                                                      UNIF_UPPER_BOUND);
+               }
+               int draw = yellowGenerators[dirCode].getUniform(
+                                        UNIF_LOWER_BOUND, UNIF_UPPER_BOUND);
+               if (isAntithetic) {
+                    draw = UNIF_LOWER_BOUND + UNIF_UPPER_BOUND - draw;
+               }
+               return draw;
+          }
+
+          //Records the delay of a car that just advanced from the given
+          //approach (a DIR_CODE_* value), if delays are being tracked, and
+          //keeps the car, if departures from it are being recorded.
+          void recordDeparture(const int dirIdx, const CarClass &passingCar) {
+               if (isDelayTrackingEnabled) {
+                    delayHistograms[dirIdx].recordValue(
+                                   currentTime - passingCar.getArrivalTime());
+               }
+               if (isRecordingDepartures[dirIdx]) {
+                    departedCars[dirIdx].enqueue(CarClass(passingCar.getId(),
+                                        passingCar.getTravelDirCode(),
+                                        currentTime));
+               }
+          }
+
+          //Brings the time-weighted statistics up to the current time,
+          //with the queue lengths and event list size as they are now.
+          void updateTimeWeightedStats();
+
+          //Handles the given event, which has been taken out of the event
+          //list (or, for the lazy arrival engine, the signal plan) or is a
+          //car entering from a linked intersection.
+          void handleEvent(const EventClass &eventToHandle);
+
+          //Lazy arrival engine: draws each approach's first arrival time.
+          void scheduleLazyArrivals();
+
+          //Lazy arrival engine: returns the next light change to handle,
+          //worked out from the signal plan.  While every queue is empty,
+          //light changes have nothing to do, so those before the first
+          //pending arrival are skipped.
+          EventClass getNextLightChange();
+
+          //Returns whether every inter-arrival time is fixed and no car
+          //ever advances on yellow, so random draws don't change what the
+          //simulation does.
+          bool getIsDeterministic() const;
+
+          //Fills in the state at the start of the current light cycle.
+          void getCycleState(CycleStateStruct &cycleState);
+
+          //Moves every pending arrival and light change shiftTime later.
+          void shiftPendingEvents(const int shiftTime);
+
+          //Called at the start of each light cycle: once the simulation is
+          //seen to be repeating a run of cycles, skips as many whole
+          //repeats as fit before the end time, adding the cars each one
+          //advances (and their delays and time-weighted statistics) to the
+          //totals.  The longest queues are unchanged, as every repeat has
+          //the same queue lengths as the one seen.
+          void checkForSteadyState();
+
+          //Lazy arrival engine: puts every approach's cars that arrive by
+          //upToTime in its queue.  If a light change happens at upToTime,
+          //cars arriving at that same time are only added if the
+          //per-event engine would have handled their arrival first, which
+          //is when the event before theirs was handled before the event
+          //before the light change's (events at the same time are handled
+          //in the order they were scheduled).
+          void materializeArrivals(const int upToTime,
+                                   const bool isLightChangeAtTime);
+
+          //Returns the time until the next car arrives on the given
+          //approach (a DIR_CODE_* value), whose arrival intervals have the
+          //given mean and standard deviation.
+          int getArrivalInterval(const unsigned char dirCode,
+                                 const double meanVal, const double stdDev) {
+               if (randomGenerator.getMode() == RANDOM_MODE_PHILOX) {
+                    return arrivalGenerators[dirCode].getNextInterval();
+               }
+               return randomGenerator.getPositiveNormal(meanVal, stdDev);
+          }
+
+          //Replaces the random generator seed read from the parameter file,
+          //e.g. to run replications of one set of parameters.  Must be
+          //called before the seed events are scheduled.
+          void setRandomSeed(const int inRandomSeedVal) {
+               randomSeedVal = inRandomSeedVal;
+               randomGenerator.setSeed(randomSeedVal);
+               setupApproachGenerators();
+          }
+
+          //Returns the seed the random number generator was given.
+          int getRandomSeed() const {
+               return randomSeedVal;
+          }
+
+          //Selects the kind of random number generator to use (a
+          //RANDOM_MODE_* value); rand() compatible by default, which
+          //reproduces the original results.  Must be called before the
+          //seed events are scheduled.
+          void setRandomMode(const int inRandomMode) {
+               randomGenerator.setMode(inRandomMode);
+               if (inRandomMode != RANDOM_MODE_PHILOX) {
+                    engineMode = ENGINE_PER_EVENT;
+                    isAntithetic = false;
+               }
+          }
+
+          //Returns the kind of random number generator in use.
+          int getRandomMode() const {
+               return randomGenerator.getMode();
+          }
+
+          //Selects the random number stream to use with the seed, so
+          //simulations sharing a seed can still get independent values
+          //(only with RANDOM_MODE_PHILOX).  Must be called before the seed
+          //events are scheduled.
+          void setRandomStream(const unsigned int inStreamId) {
+               randomStreamId = inStreamId;
+               randomGenerator.setStream(randomStreamId);
+               if (isSetupProperly) {
+                    setupApproachGenerators();
+               }
+          }
      
           //Computes and returns the amount of time the light is red in the
           //east-west direction.
@@ -141,14 +526,312 @@ class IntersectionSimulationClass {
                return eastWestGreenTime + eastWestYellowTime;
           }
      
+          //Selects how the simulation advances (an ENGINE_* value).  With
+          //ENGINE_LAZY_ARRIVALS the event list isn't used: the simulation
+          //steps from light change to light change as the signal plan
+          //gives them, skipping whole idle cycles, and the cars that
+          //arrive before a light change are put in their queues when it
+          //is handled, so the work per light cycle no longer grows with
+          //the traffic.  The statistics are exactly those of the
+          //per-event engine, but the trace has no arrival lines or idle
+          //light changes, and cars are numbered approach by approach.
+          //Needs the Philox random generator, so returns false, changing
+          //nothing, with any other.  Must be called before the seed events
+          //are scheduled.
+          bool setEngineMode(const int inEngineMode) {
+               if (inEngineMode == ENGINE_LAZY_ARRIVALS &&
+                   randomGenerator.getMode() != RANDOM_MODE_PHILOX) {
+                    return false;
+               }
+               engineMode = inEngineMode;
+               return true;
+          }
+
+          //Returns how the simulation advances (an ENGINE_* value).
+          int getEngineMode() const {
+               return engineMode;
+          }
+
+          //Selects whether every random draw is replaced by its antithetic
+          //variate: the mirror image, within its distribution, of the
+          //value the plain run draws.  A plain run and an antithetic run
+          //with the same seed are negatively correlated, so the average of
+          //the pair varies less than that of two independent runs.  Needs
+          //the Philox generator, so returns false, changing nothing, with
+          //any other.  Must be called before the seed events are
+          //scheduled.
+          bool setIsAntithetic(const bool inIsAntithetic) {
+               if (inIsAntithetic &&
+                   randomGenerator.getMode() != RANDOM_MODE_PHILOX) {
+                    return false;
+               }
+               isAntithetic = inIsAntithetic;
+               if (isSetupProperly) {
+                    setupApproachGenerators();
+               }
+               return true;
+          }
+
+          //Returns whether random draws are replaced by their antithetic
+          //variates.
+          bool getIsAntithetic() const {
+               return isAntithetic;
+          }
+
+          //Selects whether to fast-forward through a steady state.  When
+          //every arrival standard deviation is 0 and no car advances on
+          //yellow, the simulation settles into a repeating pattern of
+          //light cycles; if enabled, the state at each cycle start is
+          //compared with an earlier one, and once the pattern repeats the
+          //run jumps ahead by whole repeats to just before the end time,
+          //with the same statistics as stepping through them.  Has no
+          //effect otherwise.  The trace notes the jump; car ids carry on
+          //from where they were.
+          void setIsFastForwardEnabled(const bool inIsFastForwardEnabled) {
+               isFastForwardEnabled = inIsFastForwardEnabled;
+          }
+
+          //Selects whether to track each car's delay (the time from its
+          //arrival to advancing through the intersection) in a histogram
+          //per approach, for printStatistics and getDelayHistogram.  Off
+          //by default, as the histograms take a few KB per approach.  Must
+          //be called before the seed events are scheduled.
+          void setIsDelayTrackingEnabled(const bool inIsEnabled) {
+               isDelayTrackingEnabled = inIsEnabled;
+          }
+
+          //Returns whether delays are being tracked.
+          bool getIsDelayTrackingEnabled() const {
+               return isDelayTrackingEnabled;
+          }
+
+          //Returns the delays of the cars that have advanced from the given
+          //approach (a DIR_CODE_* value), while delays are being tracked.
+          const LogHistogramClass& getDelayHistogram(
+                                   const unsigned char dirCode) const {
+               return delayHistograms[dirCode];
+          }
+
+          //Selects whether printStatistics includes the time-weighted mean
+          //and standard deviation of each queue's length, the share of the
+          //time it had cars waiting, and (for the per-event engine) the
+          //same for the number of pending events.  These are always kept
+          //up to date; printing them is off by default, which keeps the
+          //original output.
+          void setIsQueueStatsPrinted(const bool inIsPrinted) {
+               isQueueStatsPrinted = inIsPrinted;
+          }
+
+          //Returns whether printStatistics includes the time-weighted
+          //statistics.
+          bool getIsQueueStatsPrinted() const {
+               return isQueueStatsPrinted;
+          }
+
+          //Selects the precision at which the run stops early, as the
+          //largest half-width of a 95% confidence interval relative to its
+          //mean (e.g. 0.05 for 5%), or 0 (the default) to always run to the
+          //end time.  Each light cycle's cars advanced and mean queue
+          //length per approach are then observed; the warm-up from the
+          //empty start is found with MSER-5, and the cycles after it are
+          //split into batches whose means give the intervals.  The
+          //estimates are checked every 10% more cycles, and once every
+          //interval is within the target (and the batches are long enough
+          //for their means to be nearly uncorrelated) the run stops at
+          //that cycle's start, with the other statistics up to then.  The
+          //search for a steady state to fast-forward through is off while
+          //a target is set.  Must be called before the seed events are
+          //scheduled.
+          void setTargetPrecision(const double inTargetPrecision) {
+               targetPrecision = inTargetPrecision;
+               cycleObservations.setup((targetPrecision > 0) ?
+                                       CYCLE_NUM_SERIES : 0);
+          }
+
+          //Returns the target precision, or 0 if there is none.
+          double getTargetPrecision() const {
+               return targetPrecision;
+          }
+
+          //Returns whether the run stopped early because the target
+          //precision was reached.
+          bool getIsTargetPrecisionReached() const {
+               return isTargetPrecisionReached;
+          }
+
+          //Returns the time the run's statistics run up to: when the
+          //target precision was reached, if it was, else the end time.
+          int getRunEndTime() const {
+               return isTargetPrecisionReached ? targetReachedTime :
+                                                 timeToStopSim;
+          }
+
+          //Records the observations of the light cycle ending at
+          //cycleEndTime (when the next one starts), and once there are
+          //enough more since the last check, checks whether the target
+          //precision has been reached.
+          void observeLightCycle(const int cycleEndTime);
+
+          //Lazy arrival engine: observes the light cycles starting at
+          //the idle light changes skipped before the given time, which the
+          //per-event engine would have handled, up to the end time.
+          void observeSkippedCycles(const int nextChangeTime);
+
+          //Works out steady-state estimates from the light cycles observed
+          //so far (with a target precision set).  Returns false if there
+          //are too few cycles after the warm-up, or it can't be told apart
+          //from the rest of the run yet.
+          bool getSteadyStateEstimate(
+                              SteadyStateEstimateStruct &outEstimate) const;
+
+          //Returns the length over time of the queue on the given approach
+          //(a DIR_CODE_* value), since the seed events were scheduled.
+          //Its statistics run up to the run's end time (see
+          //getRunEndTime), as the queue doesn't change after the last
+          //event.
+          const TimeWeightedStatClass& getQueueLengthStat(
+                                       const unsigned char dirCode) const {
+               return queueLengthStats[dirCode];
+          }
+
+          //Returns the number of pending events over time, since the seed
+          //events were scheduled (always 0 for the lazy arrival engine).
+          const TimeWeightedStatClass& getEventListSizeStat() const {
+               return eventListSizeStat;
+          }
+
+          //Returns whether the run has been fast-forwarded.
+          bool getIsFastForwardDone() const {
+               return isFastForwardDone;
+          }
+
+          //Makes an approach (a DIR_CODE_* value) get its cars only through
+          //enterCar, from a linked intersection, instead of from its own
+          //arrival distribution.  Per-event engine only.  Must be called
+          //before the seed events are scheduled.
+          void setIsApproachLinked(const unsigned char dirCode,
+                                   const bool inIsLinked) {
+               isApproachLinked[dirCode] = inIsLinked;
+          }
+
+          //Selects whether the cars that advance from an approach (a
+          //DIR_CODE_* value) are kept for takeDepartedCar.
+          void setIsRecordingDepartures(const unsigned char dirCode,
+                                        const bool inIsRecording) {
+               isRecordingDepartures[dirCode] = inIsRecording;
+          }
+
+          //Takes the earliest kept car that advanced from the given
+          //approach, returning false if there is none.  The car's arrival
+          //time is the time it advanced.
+          bool takeDepartedCar(const unsigned char dirCode, CarClass &outCar) {
+               return departedCars[dirCode].dequeue(outCar);
+          }
+
+          //Handles a car from a linked intersection joining the given
+          //approach's queue (a DIR_CODE_* value) at enterTime, which must
+          //not be before the current time nor after the next event's.
+          void enterCar(const unsigned char dirCode, const int enterTime) {
+               handleEvent(EventClass(enterTime, EVENT_ENTER_EAST + dirCode));
+          }
+
+          //Makes this simulation's run state (time, light, event list,
+          //queues, counters and random number streams) a copy of another's
+          //that was set up the same way, leaving the parameters, trace
+          //writers and links alone.  This is all that changes as a
+          //network intersection runs, so it is all a checkpoint needs.
+          void copyRunState(const IntersectionSimulationClass &source);
+
+          //Makes outBranch a what-if branch of this simulation: a copy of
+          //its parameters and run state that then runs on its own, e.g.
+          //with other light times (see setLightTimes).  The cars queued so
+          //far are moved into immutable segments that this simulation and
+          //all its branches share, each dequeuing from its own position,
+          //so a fork doesn't copy them however long the queues are; only
+          //the cars queued after the fork are each simulation's own.  The
+          //rest of the state is small and copied.  Branches can run on
+          //different threads, but this simulation mustn't be running
+          //while it is forked.
+          void forkInto(IntersectionSimulationClass &outBranch);
+
+          //Fills in the parameters a snapshot of this simulation records.
+          void getSnapshotParameters(
+                              SnapshotParametersStruct &outParameters) const;
+
+          //Writes this simulation's parameters and complete run state
+          //(time, light, pending events, queues, counters, statistics and
+          //random number streams) to the named snapshot file, which
+          //restoreSnapshot can resume the run from.  The snapshot can only
+          //be read by a build of the same version on the same kind of
+          //machine.  Prints an error and returns false if the file can't
+          //be written.
+          bool saveSnapshot(const std::string &snapshotFname) const;
+
+          //Replaces this simulation's run state with the one in the named
+          //snapshot file, instead of scheduling the seed events, so that
+          //handling the remaining events gives exactly the results the
+          //run the snapshot was taken from does.  The simulation must be
+          //set up with the same parameters (and the same random generator,
+          //engine and delay tracking) as that run.  Prints an error and
+          //returns false if the file can't be read or doesn't match; if it
+          //was only partly read, the simulation is left not set up.
+          bool restoreSnapshot(const std::string &snapshotFname);
+
+          //Returns the current simulation time.
+          int getCurrentTime() const {
+               return currentTime;
+          }
+
+          //Gives the time of the next event in the event list, returning
+          //false if there is none.  Per-event engine only.
+          bool getNextEventTime(int &outTime) const {
+               EventClass nextEvent;
+               if (!eventList.peekFront(nextEvent)) {
+                    return false;
+               }
+               outTime = nextEvent.getTimeOccurs();
+               return true;
+          }
+
+          //Returns the time after which events aren't handled.
+          int getTimeToStopSim() const {
+               return timeToStopSim;
+          }
+
           //Schedules the first car arrival in each direction to "seed" the
           //event driven simulation.
           void scheduleSeedEvents() {
-               scheduleArrival(EAST_DIRECTION);
-               scheduleArrival(WEST_DIRECTION);
-               scheduleArrival(NORTH_DIRECTION);
-               scheduleArrival(SOUTH_DIRECTION);
+               //No car waits longer than the whole run
+               if (isDelayTrackingEnabled) {
+                    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                         delayHistograms[dirIdx].setup(timeToStopSim);
+                    }
+               }
+               if (engineMode == ENGINE_LAZY_ARRIVALS) {
+                    scheduleLazyArrivals();
+               }
+               else {
+                    if (!isApproachLinked[DIR_CODE_EAST]) {
+                         scheduleArrival(EAST_DIRECTION);
+                    }
+                    if (!isApproachLinked[DIR_CODE_WEST]) {
+                         scheduleArrival(WEST_DIRECTION);
+                    }
+                    if (!isApproachLinked[DIR_CODE_NORTH]) {
+                         scheduleArrival(NORTH_DIRECTION);
+                    }
+                    if (!isApproachLinked[DIR_CODE_SOUTH]) {
+                         scheduleArrival(SOUTH_DIRECTION);
+                    }
+               }
                scheduleLightChange();
+               traceWriter.flush();
+
+               for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                    queueLengthStats[dirIdx].reset(currentTime, 0);
+               }
+               eventListSizeStat.reset(currentTime, 0);
+               updateTimeWeightedStats();
           }
      
           //Schedules an arrival event in the specified direction.
@@ -160,11 +843,90 @@ class IntersectionSimulationClass {
           //Handles the next event scheduled in the simulation's event list.
           //Returns true if the event was handled, or false if the next
           //event's scheduled time occurs after the specified simulation end 
-          //time.
+          //time.  The event trace is buffered, and only guaranteed to have
+          //reached the console once this returns false (or after a call to
+          //flushTrace).
           bool handleNextEvent();
+
+          //Hands any buffered event trace output to the console.
+          void flushTrace() {
+               traceWriter.flush();
+          }
+
+          //Starts writing a binary trace of the simulation to the named
+          //file, in addition to any text trace.  Each scheduled event,
+          //handled event, car arrival and car advance becomes one
+          //fixed-size record (see BinaryTraceWriterClass.h).  Returns false
+          //if the file can't be created.
+          bool openBinaryTrace(const std::string &traceFname) {
+               return binaryTraceWriter.open(traceFname);
+          }
+
+          //Finishes writing the binary trace and closes its file.  This also
+          //happens automatically when the simulation object is destroyed.
+          //Returns false if any of the trace couldn't be written.
+          bool closeBinaryTrace() {
+               return binaryTraceWriter.close();
+          }
      
-          //Prints the computed statistics from the simulation.
+          //Prints the computed statistics from the simulation, and when
+          //delays are tracked, their percentiles for each approach.  With
+          //a target precision, the steady-state estimates and their
+          //half-widths follow.
           void printStatistics() const;
+
+          //Prints the steady-state estimates and whether the target
+          //precision was reached, as part of printStatistics.
+          void printSteadyStateEstimate() const;
+
+          //Returns the longest the queue of cars on the given approach (a
+          //DIR_CODE_* value) has been so far.
+          int getMaxQueueLength(const unsigned char dirCode) const;
+
+          //Returns the number of cars that have advanced through the
+          //intersection from the given approach (a DIR_CODE_* value).
+          int getNumTotalAdvanced(const unsigned char dirCode) const;
+
+          //Fills in the statistics gathered so far for every approach.
+          void getResults(SimulationResultStruct &results) const;
+
+          //Replaces the light timing read from the parameter file.
+          //Returns false, changing nothing, unless every time is positive.
+          //With the per-event engine it can also be called on a running
+          //simulation (such as a forked branch): the new times apply from
+          //the next light change scheduled, and the search for a steady
+          //state starts over.  The lazy arrival engine works the light
+          //changes out from the start of the run, so with it this returns
+          //false, changing nothing, once a light change has been handled.
+          bool setLightTimes(const int inEastWestGreenTime,
+                             const int inEastWestYellowTime,
+                             const int inNorthSouthGreenTime,
+                             const int inNorthSouthYellowTime);
+
+          //Gives the light timing in use.
+          void getLightTimes(int &outEastWestGreenTime,
+                             int &outEastWestYellowTime,
+                             int &outNorthSouthGreenTime,
+                             int &outNorthSouthYellowTime) const {
+               outEastWestGreenTime = eastWestGreenTime;
+               outEastWestYellowTime = eastWestYellowTime;
+               outNorthSouthGreenTime = northSouthGreenTime;
+               outNorthSouthYellowTime = northSouthYellowTime;
+          }
+
+          //Replaces the distribution of the times between arrivals on the
+          //given approach (a DIR_CODE_* value) read from the parameter
+          //file.  Returns false, changing nothing, unless the mean is
+          //positive and the standard deviation isn't negative.  Must be
+          //called before the seed events are scheduled.
+          bool setArrivalDistribution(const unsigned char dirCode,
+                                      const double meanVal,
+                                      const double stdDev);
+
+          //Gives the distribution of the times between arrivals on the
+          //given approach (a DIR_CODE_* value).
+          void getArrivalDistribution(const unsigned char dirCode,
+                                      double &meanVal, double &stdDev) const;
 };
 
 #endif // _INTERSECTIONSIMULATIONCLASS_H_
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <cmath>
+#include <climits>
+using namespace std;
+
+#include "LogHistogramClass.h"
+#include "SnapshotFileClass.h"
+
+//Number of buckets holding one value each, at the start of the counts
+const int LOG_HISTOGRAM_SUB_BUCKET_COUNT = 1 << LOG_HISTOGRAM_SUB_BUCKET_BITS;
+
+//Number of buckets each further power of two is split into
+const int LOG_HISTOGRAM_SUB_BUCKET_HALF_COUNT =
+                                  LOG_HISTOGRAM_SUB_BUCKET_COUNT / 2;
+
+int LogHistogramClass::getBucketIdx(const int val) {
+    if (val < 0) {
+        return -1;
+    }
+    if (val < LOG_HISTOGRAM_SUB_BUCKET_COUNT) {
+        return val;
+    }
+
+    //Values from 2^(bits + n - 1) up to 2^(bits + n) - 1 are counted
+    //2^n to a bucket
+    int highestBit = 31 - __builtin_clz((unsigned int)val);
+    int shift = highestBit - LOG_HISTOGRAM_SUB_BUCKET_BITS + 1;
+    return LOG_HISTOGRAM_SUB_BUCKET_COUNT +
+           (shift - 1) * LOG_HISTOGRAM_SUB_BUCKET_HALF_COUNT +
+           (val >> shift) - LOG_HISTOGRAM_SUB_BUCKET_HALF_COUNT;
+}
+
+int LogHistogramClass::getBucketHighestValue(const int bucketIdx) {
+    if (bucketIdx < LOG_HISTOGRAM_SUB_BUCKET_COUNT) {
+        return bucketIdx;
+    }
+
+    int offsetIdx = bucketIdx - LOG_HISTOGRAM_SUB_BUCKET_COUNT;
+    int shift = offsetIdx / LOG_HISTOGRAM_SUB_BUCKET_HALF_COUNT + 1;
+    int subBucketIdx = offsetIdx % LOG_HISTOGRAM_SUB_BUCKET_HALF_COUNT +
+                       LOG_HISTOGRAM_SUB_BUCKET_HALF_COUNT;
+    return (subBucketIdx << shift) + ((1 << shift) - 1);
+}
+
+void LogHistogramClass::reserveBuckets(const int minNumBuckets) {
+    if (minNumBuckets <= numBuckets) {
+        return;
+    }
+
+    long *newCounts = new long[minNumBuckets];
+    for (int bucketIdx = 0; bucketIdx < minNumBuckets; bucketIdx++) {
+        newCounts[bucketIdx] = (bucketIdx < numBuckets) ? counts[bucketIdx] :
+                                                          0;
+    }
+    delete [] counts;
+    counts = newCounts;
+    numBuckets = minNumBuckets;
+}
+
+LogHistogramClass::LogHistogramClass() {
+    counts = 0;
+    numBuckets = 0;
+    totalCount = 0;
+    sumValues = 0;
+    maxValue = 0;
+}
+
+LogHistogramClass::LogHistogramClass(const LogHistogramClass &rhs) {
+    counts = 0;
+    numBuckets = 0;
+    totalCount = 0;
+    sumValues = 0;
+    maxValue = 0;
+
+    *this = rhs;
+}
+
+LogHistogramClass::~LogHistogramClass() {
+    delete [] counts;
+}
+
+LogHistogramClass& LogHistogramClass::operator=(
+                                      const LogHistogramClass &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    //keep the counts array when it is already the right size
+    if (numBuckets != rhs.numBuckets) {
+        delete [] counts;
+        counts = (rhs.numBuckets > 0) ? new long[rhs.numBuckets] : 0;
+        numBuckets = rhs.numBuckets;
+    }
+    for (int bucketIdx = 0; bucketIdx < numBuckets; bucketIdx++) {
+        counts[bucketIdx] = rhs.counts[bucketIdx];
+    }
+    totalCount = rhs.totalCount;
+    sumValues = rhs.sumValues;
+    maxValue = rhs.maxValue;
+    return *this;
+}
+
+void LogHistogramClass::setup(const int highestValue) {
+    int newNumBuckets = getBucketIdx(highestValue < 0 ? 0 : highestValue) + 1;
+
+    if (newNumBuckets != numBuckets) {
+        delete [] counts;
+        counts = new long[newNumBuckets];
+        numBuckets = newNumBuckets;
+    }
+    clear();
+}
+
+void LogHistogramClass::clear() {
+    for (int bucketIdx = 0; bucketIdx < numBuckets; bucketIdx++) {
+        counts[bucketIdx] = 0;
+    }
+    totalCount = 0;
+    sumValues = 0;
+    maxValue = 0;
+}
+
+void LogHistogramClass::merge(const LogHistogramClass &rhs) {
+    reserveBuckets(rhs.numBuckets);
+    for (int bucketIdx = 0; bucketIdx < rhs.numBuckets; bucketIdx++) {
+        counts[bucketIdx] += rhs.counts[bucketIdx];
+    }
+    totalCount += rhs.totalCount;
+    sumValues += rhs.sumValues;
+    if (rhs.maxValue > maxValue) {
+        maxValue = rhs.maxValue;
+    }
+}
+
+void LogHistogramClass::repeatGrowthSince(const LogHistogramClass &earlier,
+                                          const long numRepeats) {
+    for (int bucketIdx = 0; bucketIdx < earlier.numBuckets; bucketIdx++) {
+        counts[bucketIdx] += numRepeats * (counts[bucketIdx] -
+                                           earlier.counts[bucketIdx]);
+    }
+    for (int bucketIdx = earlier.numBuckets; bucketIdx < numBuckets;
+         bucketIdx++) {
+        counts[bucketIdx] += numRepeats * counts[bucketIdx];
+    }
+    totalCount += numRepeats * (totalCount - earlier.totalCount);
+    sumValues += numRepeats * (sumValues - earlier.sumValues);
+}
+
+int LogHistogramClass::getValueAtPercentile(const double percentile) const {
+    if (totalCount == 0) {
+        return 0;
+    }
+
+    //The smallest value with at least this many values at or below it
+    long countAtPercentile = (long)ceil(percentile / 100 * totalCount);
+    if (countAtPercentile < 1) {
+        countAtPercentile = 1;
+    }
+    else if (countAtPercentile > totalCount) {
+        countAtPercentile = totalCount;
+    }
+
+    long countSoFar = 0;
+    for (int bucketIdx = 0; bucketIdx < numBuckets; bucketIdx++) {
+        countSoFar += counts[bucketIdx];
+        if (countSoFar >= countAtPercentile) {
+            int bucketHighestValue = getBucketHighestValue(bucketIdx);
+            return (bucketHighestValue < maxValue) ? bucketHighestValue :
+                                                     maxValue;
+        }
+    }
+    return maxValue;
+}
+
+void LogHistogramClass::printSummary() const {
+    cout << "Count: " << totalCount << " p50: " <<
+            getValueAtPercentile(50) << " p90: " <<
+            getValueAtPercentile(90) << " p99: " <<
+            getValueAtPercentile(99) << " Max: " << maxValue << endl;
+}
+
+void LogHistogramClass::writeSnapshot(SnapshotFileClass &snapshotFile) const {
+    snapshotFile.writeValue(numBuckets);
+    if (numBuckets > 0) {
+        snapshotFile.writeBytes(counts, numBuckets * sizeof(long));
+    }
+    snapshotFile.writeValue(totalCount);
+    snapshotFile.writeValue(sumValues);
+    snapshotFile.writeValue(maxValue);
+}
+
+void LogHistogramClass::readSnapshot(SnapshotFileClass &snapshotFile) {
+    int newNumBuckets = 0;
+
+    //No histogram has more buckets than the largest int needs
+    snapshotFile.readValue(newNumBuckets);
+    if (newNumBuckets < 0 || newNumBuckets > getBucketIdx(INT_MAX) + 1) {
+        snapshotFile.markFailed();
+    }
+    if (snapshotFile.getIsFailed()) {
+        newNumBuckets = 0;
+    }
+    if (newNumBuckets != numBuckets) {
+        delete [] counts;
+        counts = (newNumBuckets > 0) ? new long[newNumBuckets] : 0;
+        numBuckets = newNumBuckets;
+    }
+    if (numBuckets > 0) {
+        snapshotFile.readBytes(counts, numBuckets * sizeof(long));
+    }
+    snapshotFile.readValue(totalCount);
+    snapshotFile.readValue(sumValues);
+    snapshotFile.readValue(maxValue);
+    if (snapshotFile.getIsFailed()) {
+        clear();
+    }
+}
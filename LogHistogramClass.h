@@ -0,0 +1,128 @@
+#ifndef _LOGHISTOGRAMCLASS_H_
+#define _LOGHISTOGRAMCLASS_H_
+
+//Number of bits of each value a histogram keeps: values below
+//2^LOG_HISTOGRAM_SUB_BUCKET_BITS are counted exactly, and larger ones to
+//within 1 part in 2^(LOG_HISTOGRAM_SUB_BUCKET_BITS - 1)
+const int LOG_HISTOGRAM_SUB_BUCKET_BITS = 7;
+
+class SnapshotFileClass;
+
+//Purpose: Counts non-negative whole values (such as car delays) in
+//         log-linear buckets, in the style of HdrHistogram, so percentiles
+//         can be read back without keeping the values.  Small values get
+//         a bucket each; above that, each power of two is split into the
+//         same number of equal-width buckets, so every value is counted
+//         with the same relative precision.  Recording a value is a few
+//         bit operations and one increment, and the memory is fixed by
+//         the largest value the histogram is set up for.  Histograms add
+//         up bucket by bucket, so the ones kept by separate runs or
+//         threads can be merged, in any order, into exactly the histogram
+//         of all their values.
+class LogHistogramClass {
+    private:
+        long *counts;       //Number of values counted in each bucket
+        int numBuckets;     //Number of buckets allocated
+        long totalCount;    //Number of values recorded
+        long sumValues;     //Exact sum of the values recorded
+        int maxValue;       //Largest value recorded
+
+        //Returns the index of the bucket counting the given value.
+        static int getBucketIdx(const int val);
+
+        //Returns the largest value counted in the given bucket.
+        static int getBucketHighestValue(const int bucketIdx);
+
+        //Grows the counts to at least the given number of buckets.
+        void reserveBuckets(const int minNumBuckets);
+
+    public:
+        //Default ctor - starts out with no values and no buckets.
+        LogHistogramClass();
+
+        //Copy ctor - makes a complete (deep) copy of the histogram.
+        LogHistogramClass(const LogHistogramClass &rhs);
+
+        //Frees the counts.
+        ~LogHistogramClass();
+
+        //Makes this histogram a complete (deep) copy of another.
+        LogHistogramClass& operator=(const LogHistogramClass &rhs);
+
+        //Forgets all values and allocates buckets for values up to
+        //highestValue.  Larger values can still be recorded: they are
+        //counted in the last bucket, though the maximum stays exact.
+        void setup(const int highestValue);
+
+        //Forgets all values recorded so far, keeping the buckets.
+        void clear();
+
+        //Adds one value (0 or more) to the histogram.  Does nothing
+        //before setup has been called.
+        void recordValue(const int val) {
+            int bucketIdx = getBucketIdx(val);
+            if (bucketIdx >= numBuckets) {
+                bucketIdx = numBuckets - 1;
+            }
+            if (bucketIdx >= 0) {
+                counts[bucketIdx]++;
+                totalCount++;
+                sumValues += val;
+                if (val > maxValue) {
+                    maxValue = val;
+                }
+            }
+        }
+
+        //Adds all the values recorded in another histogram to this one,
+        //growing its buckets if the other has more.
+        void merge(const LogHistogramClass &rhs);
+
+        //Adds numRepeats more copies of the values recorded since this
+        //histogram was equal to the earlier copy given (which must not
+        //have more buckets), as if that stretch of values had been
+        //recorded numRepeats more times.
+        void repeatGrowthSince(const LogHistogramClass &earlier,
+                               const long numRepeats);
+
+        //Returns the number of values recorded.
+        long getCount() const {
+            return totalCount;
+        }
+
+        //Returns the (exact) mean of the values recorded, or 0 if there
+        //are none.
+        double getMean() const {
+            return (totalCount > 0) ? (double)sumValues / totalCount : 0;
+        }
+
+        //Returns the largest value recorded, or 0 if there are none.
+        int getMax() const {
+            return maxValue;
+        }
+
+        //Returns the value that the given percentage (0 to 100) of the
+        //recorded values are at or below, to within the histogram's
+        //precision (it is the top of the bucket the percentile falls in,
+        //but never more than the maximum), or 0 if there are none.
+        int getValueAtPercentile(const double percentile) const;
+
+        //Prints the number of values, the 50th, 90th and 99th
+        //percentiles and the maximum on one line.
+        void printSummary() const;
+
+        //Writes the histogram to a snapshot file.
+        void writeSnapshot(SnapshotFileClass &snapshotFile) const;
+
+        //Replaces the histogram with one written by writeSnapshot.  If the
+        //read fails (which the snapshot file records), the histogram is
+        //left empty.
+        void readSnapshot(SnapshotFileClass &snapshotFile);
+
+        //Returns the number of bytes allocated for the counts.
+        long getNumBytesAllocated() const {
+            return (long)numBuckets * sizeof(long);
+        }
+};
+
+#endif // _LOGHISTOGRAMCLASS_H_
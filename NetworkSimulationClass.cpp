@@ -0,0 +1,652 @@
+#include <iostream>
+#include <string>
+#include <climits>
+using namespace std;
+
+#include "NetworkSimulationClass.h"
+
+//Approach names used when printing the statistics, by direction code
+static const string NETWORK_BOUND_NAMES[NUM_DIRECTIONS] = {
+    "east-bound", "west-bound", "north-bound", "south-bound"
+};
+
+//Row and column steps from an intersection to the one its cars come from
+//on each approach, by direction code (east-bound cars come from the west)
+static const int UPSTREAM_ROW_STEPS[NUM_DIRECTIONS] = { 0, 0, 1, -1 };
+static const int UPSTREAM_COL_STEPS[NUM_DIRECTIONS] = { -1, 1, 0, 0 };
+
+NetworkSimulationClass::NetworkSimulationClass(
+                        const IntersectionSimulationClass &protoSim,
+                        const int inNumRows, const int inNumCols,
+                        const int inTravelTime, const int inSyncMode,
+                        const int inOptimismWindow) {
+    numRows = (inNumRows < 1) ? 1 : inNumRows;
+    numCols = (inNumCols < 1) ? 1 : inNumCols;
+    travelTime = (inTravelTime < 1) ? 1 : inTravelTime;
+    syncMode = inSyncMode;
+    optimismWindow = (inOptimismWindow < 1) ? 1 : inOptimismWindow;
+    currentWindow = optimismWindow;
+    checkpointInterval = optimismWindow / NETWORK_CHECKPOINTS_PER_WINDOW;
+    if (checkpointInterval < NETWORK_MIN_CHECKPOINT_INTERVAL) {
+        checkpointInterval = NETWORK_MIN_CHECKPOINT_INTERVAL;
+    }
+    windowEndTime = 0;
+    numWindows = 0;
+    gvtTime = 0;
+
+    intersections = new IntersectionSimulationClass[getNumIntersections()];
+    nodes = new NetworkNodeStruct[getNumIntersections()];
+    for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+         intersectionIdx++) {
+        IntersectionSimulationClass &simObj = intersections[intersectionIdx];
+        simObj = protoSim;
+        simObj.setVerbosityLevel(VERBOSITY_SILENT);
+        simObj.setEngineMode(ENGINE_PER_EVENT);
+        simObj.setIsFastForwardEnabled(false);
+        simObj.setRandomSeed(protoSim.getRandomSeed() + intersectionIdx);
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            unsigned char dirCode = (unsigned char)dirIdx;
+            simObj.setIsApproachLinked(dirCode,
+                   getUpstreamIdx(intersectionIdx, dirIdx) >= 0);
+            simObj.setIsRecordingDepartures(dirCode, false);
+        }
+
+        NetworkNodeStruct &node = nodes[intersectionIdx];
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            node.entryTimes[dirIdx].times = 0;
+            node.entryTimes[dirIdx].numTimes = 0;
+            node.entryTimes[dirIdx].capacity = 0;
+            node.numEntriesHandled[dirIdx] = 0;
+            node.sentTimes[dirIdx].times = 0;
+            node.sentTimes[dirIdx].numTimes = 0;
+            node.sentTimes[dirIdx].capacity = 0;
+            node.cancelTimes[dirIdx] = INT_MAX;
+            node.sentHistory[dirIdx].times = 0;
+            node.sentHistory[dirIdx].numTimes = 0;
+            node.sentHistory[dirIdx].capacity = 0;
+            node.numSentChecked[dirIdx] = 0;
+        }
+        node.checkpoints = 0;
+        node.numCheckpoints = 0;
+        node.numCheckpointSlots = 0;
+    }
+
+    //An approach's departures are kept when some intersection downstream
+    //will take them
+    for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+         intersectionIdx++) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            int upstreamIdx = getUpstreamIdx(intersectionIdx, dirIdx);
+            if (upstreamIdx >= 0) {
+                intersections[upstreamIdx].setIsRecordingDepartures(
+                                           (unsigned char)dirIdx, true);
+            }
+        }
+    }
+}
+
+NetworkSimulationClass::~NetworkSimulationClass() {
+    for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+         intersectionIdx++) {
+        NetworkNodeStruct &node = nodes[intersectionIdx];
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            delete [] node.entryTimes[dirIdx].times;
+            delete [] node.sentTimes[dirIdx].times;
+            delete [] node.sentHistory[dirIdx].times;
+        }
+        for (int slotIdx = 0; slotIdx < node.numCheckpointSlots; slotIdx++) {
+            delete node.checkpoints[slotIdx].sim;
+        }
+        delete [] node.checkpoints;
+    }
+    delete [] nodes;
+    delete [] intersections;
+}
+
+void NetworkSimulationClass::appendTime(TimeListStruct &timeList,
+                                        const int newTime) {
+    if (timeList.numTimes == timeList.capacity) {
+        int newCapacity = (timeList.capacity == 0) ? 16 :
+                          2 * timeList.capacity;
+        int *newTimes = new int[newCapacity];
+        for (int i = 0; i < timeList.numTimes; i++) {
+            newTimes[i] = timeList.times[i];
+        }
+        delete [] timeList.times;
+        timeList.times = newTimes;
+        timeList.capacity = newCapacity;
+    }
+    timeList.times[timeList.numTimes] = newTime;
+    timeList.numTimes++;
+}
+
+int NetworkSimulationClass::findTime(const TimeListStruct &timeList,
+                                     const int searchTime) {
+    int lowIdx = 0;
+    int highIdx = timeList.numTimes;
+
+    while (lowIdx < highIdx) {
+        int midIdx = lowIdx + (highIdx - lowIdx) / 2;
+        if (timeList.times[midIdx] < searchTime) {
+            lowIdx = midIdx + 1;
+        }
+        else {
+            highIdx = midIdx;
+        }
+    }
+    return lowIdx;
+}
+
+int NetworkSimulationClass::getUpstreamIdx(const int intersectionIdx,
+                                           const int dirIdx) const {
+    int upstreamRow = intersectionIdx / numCols + UPSTREAM_ROW_STEPS[dirIdx];
+    int upstreamCol = intersectionIdx % numCols + UPSTREAM_COL_STEPS[dirIdx];
+
+    if (upstreamRow < 0 || upstreamRow >= numRows ||
+        upstreamCol < 0 || upstreamCol >= numCols) {
+        return -1;
+    }
+    return upstreamRow * numCols + upstreamCol;
+}
+
+int NetworkSimulationClass::getNextTime(const int intersectionIdx) const {
+    const NetworkNodeStruct &node = nodes[intersectionIdx];
+    int nextTime = INT_MAX;
+
+    if (!intersections[intersectionIdx].getNextEventTime(nextTime)) {
+        nextTime = INT_MAX;
+    }
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        const TimeListStruct &entries = node.entryTimes[dirIdx];
+        if (node.numEntriesHandled[dirIdx] < entries.numTimes &&
+            entries.times[node.numEntriesHandled[dirIdx]] < nextTime) {
+            nextTime = entries.times[node.numEntriesHandled[dirIdx]];
+        }
+    }
+    return nextTime;
+}
+
+void NetworkSimulationClass::takeCheckpoint(const int intersectionIdx,
+                                            const int cpTime) {
+    NetworkNodeStruct &node = nodes[intersectionIdx];
+
+    if (node.numCheckpoints == node.numCheckpointSlots) {
+        int newNumSlots = (node.numCheckpointSlots == 0) ?
+                          NETWORK_CHECKPOINTS_PER_WINDOW + 2 :
+                          2 * node.numCheckpointSlots;
+        CheckpointStruct *newCheckpoints = new CheckpointStruct[newNumSlots];
+        for (int slotIdx = 0; slotIdx < newNumSlots; slotIdx++) {
+            newCheckpoints[slotIdx].sim = (slotIdx < node.numCheckpointSlots) ?
+                                          node.checkpoints[slotIdx].sim :
+                                          new IntersectionSimulationClass(
+                                          intersections[intersectionIdx]);
+            if (slotIdx < node.numCheckpoints) {
+                newCheckpoints[slotIdx].checkpointTime =
+                                       node.checkpoints[slotIdx].checkpointTime;
+                newCheckpoints[slotIdx].numHandled =
+                                       node.checkpoints[slotIdx].numHandled;
+            }
+        }
+        delete [] node.checkpoints;
+        node.checkpoints = newCheckpoints;
+        node.numCheckpointSlots = newNumSlots;
+    }
+
+    CheckpointStruct &checkpoint = node.checkpoints[node.numCheckpoints];
+    checkpoint.sim->copyRunState(intersections[intersectionIdx]);
+    checkpoint.checkpointTime = cpTime;
+    checkpoint.numHandled = node.numHandled;
+    node.numCheckpoints++;
+    node.nextCheckpointTime = cpTime - cpTime % checkpointInterval +
+                              checkpointInterval;
+}
+
+void NetworkSimulationClass::rollBack(const int intersectionIdx,
+                                      const int inRollbackTime) {
+    NetworkNodeStruct &node = nodes[intersectionIdx];
+
+    //GVT never passes a time something can still be rolled back to, and a
+    //checkpoint at or before GVT is always kept
+    int cpIdx = node.numCheckpoints - 1;
+    while (cpIdx > 0 &&
+           node.checkpoints[cpIdx].checkpointTime > inRollbackTime) {
+        cpIdx--;
+    }
+    const CheckpointStruct &checkpoint = node.checkpoints[cpIdx];
+    intersections[intersectionIdx].copyRunState(*checkpoint.sim);
+    node.numCheckpoints = cpIdx + 1;
+    node.numRollbacks++;
+    node.numRolledBack += node.numHandled - checkpoint.numHandled;
+    node.numHandled = checkpoint.numHandled;
+    node.lastHandledTime = checkpoint.checkpointTime - 1;
+    node.nextCheckpointTime = checkpoint.checkpointTime -
+                              checkpoint.checkpointTime % checkpointInterval +
+                              checkpointInterval;
+    node.rollbackTime = inRollbackTime;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        node.numEntriesHandled[dirIdx] = findTime(node.entryTimes[dirIdx],
+                                                  checkpoint.checkpointTime);
+        node.numSentChecked[dirIdx] = findTime(node.sentHistory[dirIdx],
+                                               checkpoint.checkpointTime +
+                                               travelTime);
+    }
+}
+
+void NetworkSimulationClass::sendCar(const int intersectionIdx,
+                                     const int dirIdx, const int entryTime) {
+    NetworkNodeStruct &node = nodes[intersectionIdx];
+
+    if (syncMode == NETWORK_SYNC_OPTIMISTIC) {
+        TimeListStruct &history = node.sentHistory[dirIdx];
+        int &numChecked = node.numSentChecked[dirIdx];
+        if (numChecked < history.numTimes) {
+            if (history.times[numChecked] == entryTime) {
+                numChecked++;
+                return;
+            }
+            cancelSentCars(intersectionIdx, dirIdx,
+                           (entryTime < history.times[numChecked]) ?
+                           entryTime : history.times[numChecked]);
+        }
+        appendTime(history, entryTime);
+        numChecked = history.numTimes;
+    }
+    appendTime(node.sentTimes[dirIdx], entryTime);
+}
+
+void NetworkSimulationClass::cancelSentCars(const int intersectionIdx,
+                                            const int dirIdx,
+                                            const int cancelTime) {
+    NetworkNodeStruct &node = nodes[intersectionIdx];
+    TimeListStruct &history = node.sentHistory[dirIdx];
+
+    //Cancelling goes by time, so the right cars entering at cancelTime are
+    //sent again after it
+    if (cancelTime < node.cancelTimes[dirIdx]) {
+        node.cancelTimes[dirIdx] = cancelTime;
+    }
+    for (int sentIdx = findTime(history, cancelTime);
+         sentIdx < node.numSentChecked[dirIdx]; sentIdx++) {
+        appendTime(node.sentTimes[dirIdx], history.times[sentIdx]);
+    }
+    history.numTimes = node.numSentChecked[dirIdx];
+}
+
+void NetworkSimulationClass::collectFossils(const int intersectionIdx) {
+    NetworkNodeStruct &node = nodes[intersectionIdx];
+    int numFossils = 0;
+
+    while (numFossils + 1 < node.numCheckpoints &&
+           node.checkpoints[numFossils + 1].checkpointTime <= gvtTime) {
+        numFossils++;
+    }
+    if (numFossils == 0) {
+        return;
+    }
+
+    //The freed checkpoints' states are moved to the back for reuse
+    for (int rotateIdx = 0; rotateIdx < numFossils; rotateIdx++) {
+        IntersectionSimulationClass *freedSim = node.checkpoints[0].sim;
+        for (int slotIdx = 1; slotIdx < node.numCheckpointSlots; slotIdx++) {
+            node.checkpoints[slotIdx - 1] = node.checkpoints[slotIdx];
+        }
+        node.checkpoints[node.numCheckpointSlots - 1].sim = freedSim;
+    }
+    node.numCheckpoints -= numFossils;
+
+    int oldestCheckpointTime = node.checkpoints[0].checkpointTime;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        TimeListStruct &entries = node.entryTimes[dirIdx];
+        int numOldEntries = findTime(entries, oldestCheckpointTime);
+        for (int i = numOldEntries; i < entries.numTimes; i++) {
+            entries.times[i - numOldEntries] = entries.times[i];
+        }
+        entries.numTimes -= numOldEntries;
+        node.numEntriesHandled[dirIdx] -= numOldEntries;
+
+        TimeListStruct &history = node.sentHistory[dirIdx];
+        int numOldSent = findTime(history, oldestCheckpointTime + travelTime);
+        for (int i = numOldSent; i < history.numTimes; i++) {
+            history.times[i - numOldSent] = history.times[i];
+        }
+        history.numTimes -= numOldSent;
+        node.numSentChecked[dirIdx] -= numOldSent;
+    }
+}
+
+void NetworkSimulationClass::runWindow(void *network,
+                                       const int intersectionIdx) {
+    NetworkSimulationClass *thisNetwork = (NetworkSimulationClass *)network;
+    IntersectionSimulationClass &simObj =
+                                thisNetwork->intersections[intersectionIdx];
+    NetworkNodeStruct &node = thisNetwork->nodes[intersectionIdx];
+    bool isOptimistic = (thisNetwork->syncMode == NETWORK_SYNC_OPTIMISTIC);
+    int endTime = thisNetwork->windowEndTime;
+    CarClass departedCar;
+
+    if (isOptimistic) {
+        thisNetwork->collectFossils(intersectionIdx);
+    }
+
+    while (true) {
+        //Entries go before the intersection's own events at the same time,
+        //in direction code order
+        int nextTime;
+        int entryDirIdx = -1;
+        if (!simObj.getNextEventTime(nextTime)) {
+            nextTime = INT_MAX;
+        }
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            const TimeListStruct &entries = node.entryTimes[dirIdx];
+            int entryIdx = node.numEntriesHandled[dirIdx];
+            if (entryIdx < entries.numTimes &&
+                (entries.times[entryIdx] < nextTime ||
+                 (entries.times[entryIdx] == nextTime && entryDirIdx < 0))) {
+                nextTime = entries.times[entryIdx];
+                entryDirIdx = dirIdx;
+            }
+        }
+        if (nextTime >= endTime || nextTime > simObj.getTimeToStopSim()) {
+            break;
+        }
+
+        if (isOptimistic && nextTime >= node.nextCheckpointTime) {
+            thisNetwork->takeCheckpoint(intersectionIdx, nextTime -
+                         nextTime % thisNetwork->checkpointInterval);
+        }
+        if (entryDirIdx >= 0) {
+            simObj.enterCar((unsigned char)entryDirIdx, nextTime);
+            node.numEntriesHandled[entryDirIdx]++;
+        }
+        else {
+            simObj.handleNextEvent();
+        }
+        node.numHandled++;
+        node.lastHandledTime = nextTime;
+
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            while (simObj.takeDepartedCar((unsigned char)dirIdx,
+                                          departedCar)) {
+                thisNetwork->sendCar(intersectionIdx, dirIdx,
+                                     departedCar.getArrivalTime() +
+                                     thisNetwork->travelTime);
+            }
+        }
+    }
+
+    //Cars sent before the rollback that should have left by now, but
+    //didn't this time, are wrong
+    if (isOptimistic) {
+        int handledEndTime = (endTime <= simObj.getTimeToStopSim()) ?
+                             endTime : simObj.getTimeToStopSim() + 1;
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            const TimeListStruct &history = node.sentHistory[dirIdx];
+            int numChecked = node.numSentChecked[dirIdx];
+            if (numChecked < history.numTimes &&
+                history.times[numChecked] - thisNetwork->travelTime <
+                handledEndTime) {
+                thisNetwork->cancelSentCars(intersectionIdx, dirIdx,
+                                            history.times[numChecked]);
+            }
+        }
+    }
+}
+
+void NetworkSimulationClass::deliverCars(void *network,
+                                         const int intersectionIdx) {
+    NetworkSimulationClass *thisNetwork = (NetworkSimulationClass *)network;
+    NetworkNodeStruct &node = thisNetwork->nodes[intersectionIdx];
+    int rollbackTime = INT_MAX;
+
+    //Each approach's cars are taken only by the one intersection
+    //downstream, so the tasks don't share anything
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        int upstreamIdx = thisNetwork->getUpstreamIdx(intersectionIdx, dirIdx);
+        if (upstreamIdx < 0) {
+            continue;
+        }
+        NetworkNodeStruct &upstreamNode = thisNetwork->nodes[upstreamIdx];
+        TimeListStruct &entries = node.entryTimes[dirIdx];
+        TimeListStruct &sent = upstreamNode.sentTimes[dirIdx];
+
+        //Cancelled entries that were already handled have to be undone
+        int cancelTime = upstreamNode.cancelTimes[dirIdx];
+        if (cancelTime != INT_MAX) {
+            int numKept = findTime(entries, cancelTime);
+            if (numKept < node.numEntriesHandled[dirIdx] &&
+                cancelTime < rollbackTime) {
+                rollbackTime = cancelTime;
+            }
+            entries.numTimes = numKept;
+            upstreamNode.cancelTimes[dirIdx] = INT_MAX;
+        }
+
+        //So do the events handled at or after a newly arrived entry
+        for (int sentIdx = 0; sentIdx < sent.numTimes; sentIdx++) {
+            if (sent.times[sentIdx] <= node.lastHandledTime &&
+                sent.times[sentIdx] < rollbackTime) {
+                rollbackTime = sent.times[sentIdx];
+            }
+            appendTime(entries, sent.times[sentIdx]);
+        }
+        sent.numTimes = 0;
+    }
+
+    if (rollbackTime != INT_MAX) {
+        thisNetwork->rollBack(intersectionIdx, rollbackTime);
+    }
+
+    //Handling the events and entries before the rollback time again sends
+    //the same cars, so the intersection can't cause a rollback before then
+    int lowerBoundTime = thisNetwork->getNextTime(intersectionIdx);
+    if (lowerBoundTime < node.rollbackTime) {
+        lowerBoundTime = node.rollbackTime;
+    }
+    node.lowerBoundTime = lowerBoundTime;
+}
+
+void NetworkSimulationClass::run(ThreadPoolClass &threadPool) {
+    int timeToStopSim = intersections[0].getTimeToStopSim();
+
+    for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+         intersectionIdx++) {
+        NetworkNodeStruct &node = nodes[intersectionIdx];
+        intersections[intersectionIdx].scheduleSeedEvents();
+        node.rollbackTime = INT_MIN;
+        node.lastHandledTime = INT_MIN;
+        node.nextCheckpointTime = 0;
+        node.numHandled = 0;
+        node.numRollbacks = 0;
+        node.numRolledBack = 0;
+        if (syncMode == NETWORK_SYNC_OPTIMISTIC) {
+            takeCheckpoint(intersectionIdx, 0);
+        }
+    }
+
+    windowEndTime = 0;
+    numWindows = 0;
+    gvtTime = 0;
+    if (syncMode == NETWORK_SYNC_OPTIMISTIC) {
+        //Each round takes in the cars sent during the last one, rolling
+        //back where needed, then lets every intersection run up to the
+        //current window past GVT
+        long lastNumWorked = 0;
+        long lastNumRolledBack = 0;
+        int minWindow = (travelTime < optimismWindow) ? travelTime :
+                                                        optimismWindow;
+        currentWindow = optimismWindow;
+        while (true) {
+            threadPool.runTasks(deliverCars, this, getNumIntersections());
+            gvtTime = INT_MAX;
+            long numWorked = 0;
+            long numRolledBack = 0;
+            for (int intersectionIdx = 0;
+                 intersectionIdx < getNumIntersections(); intersectionIdx++) {
+                const NetworkNodeStruct &node = nodes[intersectionIdx];
+                if (node.lowerBoundTime < gvtTime) {
+                    gvtTime = node.lowerBoundTime;
+                }
+                numWorked += node.numHandled + node.numRolledBack;
+                numRolledBack += node.numRolledBack;
+            }
+            if (gvtTime > timeToStopSim) {
+                break;
+            }
+
+            //Throttle the optimism when more than a quarter of the last
+            //round's work was undone
+            if (4 * (numRolledBack - lastNumRolledBack) >
+                numWorked - lastNumWorked) {
+                currentWindow = (currentWindow / 2 < minWindow) ?
+                                minWindow : currentWindow / 2;
+            }
+            else {
+                currentWindow = (currentWindow * 2 > optimismWindow) ?
+                                optimismWindow : currentWindow * 2;
+            }
+            lastNumWorked = numWorked;
+            lastNumRolledBack = numRolledBack;
+
+            windowEndTime = (timeToStopSim - gvtTime < currentWindow) ?
+                            timeToStopSim + 1 : gvtTime + currentWindow;
+            threadPool.runTasks(runWindow, this, getNumIntersections());
+            numWindows++;
+        }
+    }
+    else {
+        //Cars that advance during a window reach their next intersection
+        //at or after its end, so every intersection can handle the whole
+        //window without hearing from the others
+        while (windowEndTime <= timeToStopSim) {
+            windowEndTime = (timeToStopSim - windowEndTime < travelTime) ?
+                            timeToStopSim + 1 : windowEndTime + travelTime;
+            threadPool.runTasks(runWindow, this, getNumIntersections());
+            threadPool.runTasks(deliverCars, this, getNumIntersections());
+            numWindows++;
+        }
+    }
+}
+
+long NetworkSimulationClass::getNumHandled() const {
+    long numHandled = 0;
+
+    for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+         intersectionIdx++) {
+        numHandled += nodes[intersectionIdx].numHandled +
+                      nodes[intersectionIdx].numRolledBack;
+    }
+    return numHandled;
+}
+
+long NetworkSimulationClass::getNumRollbacks() const {
+    long numRollbacks = 0;
+
+    for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+         intersectionIdx++) {
+        numRollbacks += nodes[intersectionIdx].numRollbacks;
+    }
+    return numRollbacks;
+}
+
+long NetworkSimulationClass::getNumRolledBack() const {
+    long numRolledBack = 0;
+
+    for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+         intersectionIdx++) {
+        numRolledBack += nodes[intersectionIdx].numRolledBack;
+    }
+    return numRolledBack;
+}
+
+void NetworkSimulationClass::printStatistics() const {
+    cout << "===== Begin Network Statistics =====" << endl;
+    cout << "  Intersections: " << numRows << " x " << numCols <<
+            ", link travel time: " << travelTime << ", windows: " <<
+            numWindows << endl;
+    if (syncMode == NETWORK_SYNC_OPTIMISTIC) {
+        cout << "  Optimistic rounds with window " << optimismWindow <<
+                ", rollbacks: " << getNumRollbacks() <<
+                ", events rolled back: " << getNumRolledBack() << endl;
+    }
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        unsigned char dirCode = (unsigned char)dirIdx;
+        int longestQueue = 0;
+        int longestQueueIdx = 0;
+        long numAdvanced = 0;
+        long numLeft = 0;
+
+        for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+             intersectionIdx++) {
+            const IntersectionSimulationClass &simObj =
+                                      intersections[intersectionIdx];
+            if (simObj.getMaxQueueLength(dirCode) > longestQueue) {
+                longestQueue = simObj.getMaxQueueLength(dirCode);
+                longestQueueIdx = intersectionIdx;
+            }
+            numAdvanced += simObj.getNumTotalAdvanced(dirCode);
+        }
+
+        //Cars advancing from an intersection with no neighbour in their
+        //direction of travel leave the network
+        for (int intersectionIdx = 0; intersectionIdx < getNumIntersections();
+             intersectionIdx++) {
+            int row = intersectionIdx / numCols;
+            int col = intersectionIdx % numCols;
+            int nextRow = row - UPSTREAM_ROW_STEPS[dirIdx];
+            int nextCol = col - UPSTREAM_COL_STEPS[dirIdx];
+            if (nextRow < 0 || nextRow >= numRows ||
+                nextCol < 0 || nextCol >= numCols) {
+                numLeft += intersections[intersectionIdx].getNumTotalAdvanced(
+                                                          dirCode);
+            }
+        }
+
+        cout << "  Longest " << NETWORK_BOUND_NAMES[dirIdx] << " queue: " <<
+                longestQueue << " (intersection " <<
+                longestQueueIdx / numCols << "," <<
+                longestQueueIdx % numCols << ")" << endl;
+        cout << "  Total cars advanced " << NETWORK_BOUND_NAMES[dirIdx] <<
+                ": " << numAdvanced << ", leaving the network: " << numLeft <<
+                endl;
+    }
+
+    //The time-weighted statistics are averaged over the intersections
+    if (intersections[0].getIsQueueStatsPrinted()) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            double sumMeans = 0;
+            double sumBusyFractions = 0;
+            for (int intersectionIdx = 0;
+                 intersectionIdx < getNumIntersections(); intersectionIdx++) {
+                const IntersectionSimulationClass &simObj =
+                                          intersections[intersectionIdx];
+                const TimeWeightedStatClass &queueStat =
+                          simObj.getQueueLengthStat((unsigned char)dirIdx);
+                sumMeans += queueStat.getMean(simObj.getTimeToStopSim());
+                sumBusyFractions += queueStat.getFractionNonZero(
+                                              simObj.getTimeToStopSim());
+            }
+            cout << "  Time-weighted " << NETWORK_BOUND_NAMES[dirIdx] <<
+                    " queue, per intersection - Mean: " <<
+                    sumMeans / getNumIntersections() << " Busy: " <<
+                    sumBusyFractions / getNumIntersections() << endl;
+        }
+    }
+
+    //Each intersection's delays only cover its own queues, so a car
+    //crossing several is counted once at each
+    if (intersections[0].getIsDelayTrackingEnabled()) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            LogHistogramClass delayHistogram;
+            for (int intersectionIdx = 0;
+                 intersectionIdx < getNumIntersections(); intersectionIdx++) {
+                delayHistogram.merge(intersections[intersectionIdx].
+                                     getDelayHistogram((unsigned char)dirIdx));
+            }
+            cout << "  Delay of " << NETWORK_BOUND_NAMES[dirIdx] <<
+                    " cars - ";
+            delayHistogram.printSummary();
+        }
+    }
+    cout << "===== End Network Statistics =====" << endl;
+}
@@ -0,0 +1,260 @@
+#ifndef _NETWORKSIMULATIONCLASS_H_
+#define _NETWORKSIMULATIONCLASS_H_
+
+#include "IntersectionSimulationClass.h"
+#include "ThreadPoolClass.h"
+#include "constants.h"
+
+//Most intersections a network may have
+const long NETWORK_MAX_NUM_INTERSECTIONS = 10000000;
+
+//Time to drive a link between neighbouring intersections, unless given
+const int NETWORK_DEFAULT_TRAVEL_TIME = 10;
+
+//Ways of keeping a network's intersections in step
+const int NETWORK_SYNC_CONSERVATIVE = 0; //Windows one travel time long
+const int NETWORK_SYNC_OPTIMISTIC = 1;   //Time Warp: run ahead, roll back
+
+//How far past global virtual time an intersection may run ahead with
+//optimistic synchronization, unless given
+const int NETWORK_DEFAULT_OPTIMISM_WINDOW = 100;
+
+//Checkpoints an intersection takes per optimism window, and the least
+//time between two of them (a checkpoint costs about as much as handling
+//a few dozen events)
+const int NETWORK_CHECKPOINTS_PER_WINDOW = 4;
+const int NETWORK_MIN_CHECKPOINT_INTERVAL = 20;
+
+//Purpose: A growable array of times, in nondecreasing order.
+struct TimeListStruct {
+    int *times;     //The times, or 0 if nothing has been allocated yet
+    int numTimes;   //Number of times in the list
+    int capacity;   //Number of times the array can hold
+};
+
+//Purpose: A copy of an intersection's run state (queues, light, event
+//         list, counters and random number streams; see
+//         IntersectionSimulationClass::copyRunState), taken when it had
+//         handled everything before checkpointTime and nothing at or
+//         after it.
+struct CheckpointStruct {
+    IntersectionSimulationClass *sim; //The state (allocated once, reused)
+    int checkpointTime;     //Time the state was taken at
+    long numHandled;        //Events and entries handled by then
+};
+
+//Purpose: What a network keeps for each intersection besides its
+//         simulation: the cars entering it from its neighbours, the cars
+//         it has sent on, and, with optimistic synchronization, the
+//         checkpoints it can roll back to.
+struct NetworkNodeStruct {
+    TimeListStruct entryTimes[NUM_DIRECTIONS]; //Times cars enter each
+                            //approach from upstream, by direction code
+    int numEntriesHandled[NUM_DIRECTIONS]; //How many of those have been
+                            //handled
+    TimeListStruct sentTimes[NUM_DIRECTIONS]; //Entry times of the cars
+                            //sent downstream in each direction that the
+                            //next intersection hasn't taken yet
+    int cancelTimes[NUM_DIRECTIONS]; //With sentTimes: the next
+                            //intersection must first drop the entries at
+                            //or after this time (INT_MAX if none)
+    TimeListStruct sentHistory[NUM_DIRECTIONS]; //Optimistic: entry times
+                            //of every car sent in each direction since
+                            //the oldest checkpoint
+    int numSentChecked[NUM_DIRECTIONS]; //Optimistic: how many of those
+                            //are known to still be right; after a
+                            //rollback, the cars sent again are compared
+                            //with the rest
+    int rollbackTime;       //Time of the last rollback; handling the
+                            //events before it again sends the same cars
+    int lastHandledTime;    //Time of the last event or entry handled, or
+                            //less than every time if none
+    int nextCheckpointTime; //No checkpoint is taken before this time
+    int lowerBoundTime;     //No message the intersection sends from now
+                            //on can roll anything back before this time
+    long numHandled;        //Events and entries handled (including
+                            //those since rolled back)
+    long numRollbacks;      //Rollbacks done
+    long numRolledBack;     //Events and entries undone by rollbacks
+    CheckpointStruct *checkpoints; //Oldest first
+    int numCheckpoints;     //Checkpoints in use
+    int numCheckpointSlots; //Entries of checkpoints with a state allocated
+};
+
+//Purpose: Runs a grid of intersections (a corridor when it has one row),
+//         where the cars advancing from an approach of one intersection
+//         join the same approach of the next intersection in their
+//         direction of travel after the link travel time.  Row 0 is the
+//         northernmost, column 0 the westernmost.  Cars only arrive from
+//         the parameter file's distributions on approaches at the edge of
+//         the grid; cars advancing from the far edge leave the network.
+//         Intersection i is a copy of the setup with the setup's seed
+//         plus i.
+//
+//         The intersections run in parallel on the threads of a pool with
+//         conservative synchronization: a car that advances at time t
+//         can't reach a neighbour before t plus the travel time, so the
+//         run proceeds in windows that long, each intersection handling
+//         its events in a window independently, and the cars that left
+//         during the window are handed to their next intersection between
+//         windows.  The window boundaries and hand-over order don't
+//         depend on the threads, so neither do the results.
+//
+//         With short travel times those windows are tiny, so the network
+//         can instead use optimistic (Time Warp) synchronization: each
+//         intersection runs up to an optimism window past the global
+//         virtual time (GVT), checkpointing its state every so often.  A
+//         car that turns up for a time the intersection has already
+//         passed (a straggler), or the cancellation of one it has already
+//         handled, rolls it back to the last checkpoint before that time.
+//         Cancellation is lazy: the cars it sent since are only cancelled
+//         if handling its events again sends different ones, which keeps
+//         a straggler on one approach from rolling back the neighbours
+//         the other approaches feed.  When much of a round's work is
+//         rolled back the window is halved (down to the travel time, at
+//         which no newly sent car can be a straggler), and otherwise
+//         doubled.  GVT,
+//         the earliest time anything can still be rolled back to, is
+//         worked out between rounds, and the checkpoints and entries from
+//         before it are freed (fossil collection).
+//
+//         Either way, cars entering an approach at time t join its queue
+//         before the intersection's own events at t, in direction code
+//         order, so both give the same results.
+class NetworkSimulationClass {
+    private:
+        int numRows;                //Rows of intersections in the grid
+        int numCols;                //Columns of intersections in the grid
+        int travelTime;             //Time to drive a link, which is also
+                                    //the length of each conservative
+                                    //window
+        int syncMode;               //A NETWORK_SYNC_* value
+        int optimismWindow;         //Most intersections may run past GVT
+                                    //with optimistic synchronization
+        int currentWindow;          //How far past GVT they may run in the
+                                    //current round
+        int checkpointInterval;     //Time between checkpoints
+        IntersectionSimulationClass *intersections; //By row, then column
+        NetworkNodeStruct *nodes;   //Links and checkpoints, by
+                                    //intersection
+        int windowEndTime;          //End (exclusive) of the current window
+        int numWindows;             //Windows (or optimistic rounds) run
+                                    //so far
+        int gvtTime;                //Global virtual time of the round
+
+        //Adds a time at the end of a list.
+        static void appendTime(TimeListStruct &timeList, const int newTime);
+
+        //Returns the index of the first time in a list at or after the
+        //given time.
+        static int findTime(const TimeListStruct &timeList,
+                            const int searchTime);
+
+        //Returns the index of the intersection cars joining the given
+        //approach (a DIR_CODE_* value) of an intersection come from, or
+        //-1 if the approach is at the edge of the grid.
+        int getUpstreamIdx(const int intersectionIdx,
+                           const int dirIdx) const;
+
+        //Returns the time of the next event or entry an intersection
+        //will handle, or INT_MAX if none.
+        int getNextTime(const int intersectionIdx) const;
+
+        //Takes a checkpoint of an intersection at the given time.
+        void takeCheckpoint(const int intersectionIdx, const int cpTime);
+
+        //Rolls an intersection back to its last checkpoint at or before
+        //inRollbackTime.  The cars it sent since are cancelled only once
+        //handling its events again turns out to send different ones.
+        void rollBack(const int intersectionIdx, const int inRollbackTime);
+
+        //Passes on a car that will enter the next intersection in the
+        //given direction at entryTime.
+        void sendCar(const int intersectionIdx, const int dirIdx,
+                     const int entryTime);
+
+        //Cancels the cars an intersection sent in the given direction
+        //that turned out to be wrong, the first of which enters at
+        //cancelTime, sending again the right ones entering then.
+        void cancelSentCars(const int intersectionIdx, const int dirIdx,
+                            const int cancelTime);
+
+        //Frees an intersection's checkpoints and entries from before the
+        //last checkpoint at or before GVT.
+        void collectFossils(const int intersectionIdx);
+
+        //Thread pool task: handles one intersection's events and entries
+        //before the end of the current window (for optimistic
+        //synchronization, GVT plus the optimism window), passing on the
+        //cars that advance towards a neighbour.
+        static void runWindow(void *network, const int intersectionIdx);
+
+        //Thread pool task: takes the cars (and cancellations) sent
+        //towards one intersection during the last window, rolling it back
+        //if any are for a time it has already passed, then works out the
+        //earliest time it can still affect.
+        static void deliverCars(void *network, const int intersectionIdx);
+
+        //A network owns its intersections, so it can't be copied.
+        NetworkSimulationClass(const NetworkSimulationClass &rhs);
+        NetworkSimulationClass& operator=(const NetworkSimulationClass &rhs);
+
+    public:
+        //Builds a grid of the given size from a simulation that has read
+        //its parameters (but not scheduled its seed events), with links
+        //taking inTravelTime (at least 1) to drive.  Every intersection
+        //uses the per-event engine and prints nothing.  The intersections
+        //are kept in step with the given NETWORK_SYNC_* mode, running up
+        //to inOptimismWindow (at least 1) past GVT if it is optimistic.
+        NetworkSimulationClass(const IntersectionSimulationClass &protoSim,
+                               const int inNumRows, const int inNumCols,
+                               const int inTravelTime,
+                               const int inSyncMode =
+                                         NETWORK_SYNC_CONSERVATIVE,
+                               const int inOptimismWindow =
+                                         NETWORK_DEFAULT_OPTIMISM_WINDOW);
+
+        //Frees the intersections and their links and checkpoints.
+        ~NetworkSimulationClass();
+
+        //Runs every intersection to the end time on the pool's threads.
+        void run(ThreadPoolClass &threadPool);
+
+        //Returns the number of intersections.
+        int getNumIntersections() const {
+            return numRows * numCols;
+        }
+
+        //Returns the number of windows (or optimistic rounds) the last
+        //run took.
+        int getNumWindows() const {
+            return numWindows;
+        }
+
+        //Returns the number of events and entries the intersections
+        //handled in the last run, counting those later rolled back.
+        long getNumHandled() const;
+
+        //Returns the number of rollbacks in the last run.
+        long getNumRollbacks() const;
+
+        //Returns the number of events and entries undone by rollbacks in
+        //the last run.
+        long getNumRolledBack() const;
+
+        //Returns one intersection (by row, then column).
+        const IntersectionSimulationClass& getIntersection(
+                                           const int intersectionIdx) const {
+            return intersections[intersectionIdx];
+        }
+
+        //Prints, for each direction of travel, the longest queue at any
+        //intersection, the cars advanced at all of them, and the cars that
+        //left the network, with optimistic synchronization how much was
+        //rolled back, and if the intersections print them, the average
+        //time-weighted queue statistics and the delay percentiles over
+        //all of them.
+        void printStatistics() const;
+};
+
+#endif // _NETWORKSIMULATIONCLASS_H_
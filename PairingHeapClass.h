@@ -0,0 +1,105 @@
+#ifndef _PAIRINGHEAPCLASS_H
+#define _PAIRINGHEAPCLASS_H
+
+using namespace std;
+#include "HeapNodeAllocatorClass.h"
+
+// A priority queue implemented as a pairing heap: a heap-ordered
+// multi-way tree where insertion is an O(1) link with the root and
+// removing the front does a two-pass pairing of the root's children, for
+// O(log n) amortized cost. It offers the same interface as
+// SortedListClass for the operations an event list needs. Values are
+// ordered with T's operator<=, and values that are "equal to" each other
+// come out in the order they were inserted (FIFO), just like with
+// SortedListClass. Node storage comes from an allocator of type
+// NodeAllocT<node type>, as with SortedListClass.
+template <class T, template <class> class NodeAllocT = HeapNodeAllocatorClass>
+class PairingHeapClass {
+    private:
+        // One node of the tree. Children of a node are kept in a singly
+        // linked list through their nextSibling pointers.
+        struct HeapNodeStruct {
+            T value;
+            unsigned long seqNum; // Insertion sequence number used to
+                                  // break ties between equal values.
+            HeapNodeStruct *firstChild;
+            HeapNodeStruct *nextSibling;
+        };
+
+        HeapNodeStruct *root;     // Root of the tree, or NULL if empty.
+        int numElems;             // Number of nodes in the tree.
+        unsigned long nextSeqNum; // Sequence number given to the next value
+                                  // inserted.
+        NodeAllocT<HeapNodeStruct> nodeAllocator; // Provides storage for
+                                  // this heap's nodes.
+
+        // Returns true if node "lhs" has to come out of the heap before
+        // node "rhs".
+        static bool nodePrecedes(const HeapNodeStruct *lhs,
+                                 const HeapNodeStruct *rhs);
+
+        // Links two trees together, making the root that comes out later
+        // the first child of the other. Returns the resulting root.
+        static HeapNodeStruct* linkTrees(HeapNodeStruct *first,
+                                         HeapNodeStruct *second);
+
+        // Combines a list of sibling trees into a single tree using the
+        // standard two-pass pairing, returning its root.
+        static HeapNodeStruct* mergeSiblings(HeapNodeStruct *firstSibling);
+
+        // Destroys a node and gives its storage back to the node allocator.
+        void destroyNode(HeapNodeStruct *node);
+
+        // Adds a value carrying an already assigned sequence number.
+        void insertWithSeqNum(const T &valToInsert,
+                              const unsigned long seqNum);
+
+    public:
+        // Default Constructor. Will properly initialize a heap to
+        // be an empty heap, to which values can be added.
+        PairingHeapClass();
+
+        // Copy constructor. Will make a complete (deep) copy of the heap,
+        // such that one can be changed without affecting the other.
+        PairingHeapClass(const PairingHeapClass<T, NodeAllocT> &rhs);
+
+        // Destructor. Responsible for making sure any dynamic memory
+        // associated with an object is freed up when the object is
+        // being destroyed.
+        ~PairingHeapClass();
+
+        // Assignment operator. Will assign one heap (on left hand side of
+        // operator) to be a duplicate of the other (on the right hand side
+        // of operator).
+        PairingHeapClass<T, NodeAllocT>& operator=(
+            const PairingHeapClass<T, NodeAllocT> &rhs);
+
+        // Clears the heap to an empty state without resulting in any
+        // memory leaks.
+        void clear();
+
+        // Inserts a value into the heap. If the value is found to be "equal
+        // to" one or more values already in the heap, it will be removed
+        // AFTER the previously inserted ones.
+        void insertValue(const T &valToInsert);
+
+        // Removes the front (smallest) item from the heap and returns it
+        // via the reference parameter. If the heap was empty, the function
+        // returns false and the reference parameter is left unchanged.
+        // Otherwise true is returned.
+        bool removeFront(T &theVal);
+
+        // Provides a copy of the front (smallest) item without removing
+        // it. Returns false, leaving outVal unchanged, if the heap is empty.
+        bool peekFront(T &outVal) const;
+
+        // Returns the number of values contained in the heap.
+        int getNumElems() const;
+
+        // Provides read access to the allocator this heap takes its nodes
+        // from, e.g. to look at its allocation counters.
+        const NodeAllocT<HeapNodeStruct>& getNodeAllocator() const;
+};
+
+#include "PairingHeapClass.inl"
+#endif
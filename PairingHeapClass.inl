@@ -0,0 +1,250 @@
+// Returns true if node "lhs" has to come out of the heap before
+// node "rhs".
+template <class T, template <class> class NodeAllocT>
+bool PairingHeapClass<T, NodeAllocT>::nodePrecedes(
+    const HeapNodeStruct *lhs,
+    const HeapNodeStruct *rhs) {
+    // strictly smaller value goes first
+    if (!(rhs->value <= lhs->value)) {
+        return true;
+    }
+    // strictly greater value goes last
+    if (!(lhs->value <= rhs->value)) {
+        return false;
+    }
+    // equal values come out in insertion order
+    return lhs->seqNum < rhs->seqNum;
+}
+
+// Links two trees together, making the root that comes out later
+// the first child of the other. Returns the resulting root.
+template <class T, template <class> class NodeAllocT>
+typename PairingHeapClass<T, NodeAllocT>::HeapNodeStruct*
+PairingHeapClass<T, NodeAllocT>::linkTrees(HeapNodeStruct *first,
+                                           HeapNodeStruct *second) {
+    if (first == 0) {
+        return second;
+    }
+    if (second == 0) {
+        return first;
+    }
+
+    if (nodePrecedes(second, first)) {
+        HeapNodeStruct *temp = first;
+        first = second;
+        second = temp;
+    }
+    second->nextSibling = first->firstChild;
+    first->firstChild = second;
+    first->nextSibling = 0;
+    return first;
+}
+
+// Combines a list of sibling trees into a single tree using the
+// standard two-pass pairing, returning its root.
+template <class T, template <class> class NodeAllocT>
+typename PairingHeapClass<T, NodeAllocT>::HeapNodeStruct*
+PairingHeapClass<T, NodeAllocT>::mergeSiblings(
+    HeapNodeStruct *firstSibling) {
+    // first pass: link siblings in pairs from left to right, collecting
+    // the results in a list that ends up in right-to-left order
+    HeapNodeStruct *pairedList = 0;
+    HeapNodeStruct *currNode = firstSibling;
+    while (currNode != 0) {
+        HeapNodeStruct *first = currNode;
+        HeapNodeStruct *second = currNode->nextSibling;
+        if (second != 0) {
+            currNode = second->nextSibling;
+        }
+        else {
+            currNode = 0;
+        }
+
+        HeapNodeStruct *linked = linkTrees(first, second);
+        linked->nextSibling = pairedList;
+        pairedList = linked;
+    }
+
+    // second pass: fold the pairs together from right to left
+    HeapNodeStruct *result = 0;
+    while (pairedList != 0) {
+        HeapNodeStruct *next = pairedList->nextSibling;
+        pairedList->nextSibling = 0;
+        result = linkTrees(result, pairedList);
+        pairedList = next;
+    }
+    return result;
+}
+
+// Destroys a node and gives its storage back to the node allocator.
+template <class T, template <class> class NodeAllocT>
+void PairingHeapClass<T, NodeAllocT>::destroyNode(HeapNodeStruct *node) {
+    node->~HeapNodeStruct();
+    nodeAllocator.deallocate(node);
+}
+
+// Adds a value carrying an already assigned sequence number.
+template <class T, template <class> class NodeAllocT>
+void PairingHeapClass<T, NodeAllocT>::insertWithSeqNum(
+    const T &valToInsert,
+    const unsigned long seqNum) {
+    HeapNodeStruct *newNode = new (nodeAllocator.allocate()) HeapNodeStruct;
+    newNode->value = valToInsert;
+    newNode->seqNum = seqNum;
+    newNode->firstChild = 0;
+    newNode->nextSibling = 0;
+
+    root = linkTrees(root, newNode);
+    numElems++;
+}
+
+// Default Constructor. Will properly initialize a heap to
+// be an empty heap, to which values can be added.
+template <class T, template <class> class NodeAllocT>
+PairingHeapClass<T, NodeAllocT>::PairingHeapClass() {
+    root = 0;
+    numElems = 0;
+    nextSeqNum = 0;
+}
+
+// Copy constructor. Will make a complete (deep) copy of the heap,
+// such that one can be changed without affecting the other.
+template <class T, template <class> class NodeAllocT>
+PairingHeapClass<T, NodeAllocT>::PairingHeapClass(
+    const PairingHeapClass<T, NodeAllocT> &rhs) {
+    root = 0;
+    numElems = 0;
+    nextSeqNum = 0;
+
+    *this = rhs;
+}
+
+// Destructor. Responsible for making sure any dynamic memory
+// associated with an object is freed up when the object is
+// being destroyed.
+template <class T, template <class> class NodeAllocT>
+PairingHeapClass<T, NodeAllocT>::~PairingHeapClass() {
+    clear();
+}
+
+// Assignment operator. Will assign one heap (on left hand side of
+// operator) to be a duplicate of the other (on the right hand side
+// of operator).
+template <class T, template <class> class NodeAllocT>
+PairingHeapClass<T, NodeAllocT>& PairingHeapClass<T, NodeAllocT>::operator=(
+    const PairingHeapClass<T, NodeAllocT> &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+    clear();
+
+    // walk every node of rhs without recursion, re-inserting each value
+    // with its original sequence number so ties keep their order
+    const HeapNodeStruct *currNode = rhs.root;
+    const HeapNodeStruct **pendingStack = 0;
+    int numPending = 0;
+    if (rhs.numElems > 0) {
+        pendingStack = new const HeapNodeStruct*[rhs.numElems];
+    }
+    while (currNode != 0) {
+        insertWithSeqNum(currNode->value, currNode->seqNum);
+        if (currNode->nextSibling != 0) {
+            pendingStack[numPending] = currNode->nextSibling;
+            numPending++;
+        }
+        if (currNode->firstChild != 0) {
+            currNode = currNode->firstChild;
+        }
+        else if (numPending > 0) {
+            numPending--;
+            currNode = pendingStack[numPending];
+        }
+        else {
+            currNode = 0;
+        }
+    }
+    delete [] pendingStack;
+    nextSeqNum = rhs.nextSeqNum;
+
+    return *this;
+}
+
+// Clears the heap to an empty state without resulting in any
+// memory leaks.
+template <class T, template <class> class NodeAllocT>
+void PairingHeapClass<T, NodeAllocT>::clear() {
+    // splice each node's children into the list of nodes still to be
+    // deleted, so the whole tree is freed without recursion
+    HeapNodeStruct *pendingList = root;
+    while (pendingList != 0) {
+        HeapNodeStruct *currNode = pendingList;
+        pendingList = currNode->nextSibling;
+
+        HeapNodeStruct *lastChild = currNode->firstChild;
+        if (lastChild != 0) {
+            while (lastChild->nextSibling != 0) {
+                lastChild = lastChild->nextSibling;
+            }
+            lastChild->nextSibling = pendingList;
+            pendingList = currNode->firstChild;
+        }
+        destroyNode(currNode);
+    }
+
+    root = 0;
+    numElems = 0;
+    nextSeqNum = 0;
+}
+
+// Inserts a value into the heap. If the value is found to be "equal
+// to" one or more values already in the heap, it will be removed
+// AFTER the previously inserted ones.
+template <class T, template <class> class NodeAllocT>
+void PairingHeapClass<T, NodeAllocT>::insertValue(const T &valToInsert) {
+    insertWithSeqNum(valToInsert, nextSeqNum);
+    nextSeqNum++;
+}
+
+// Removes the front (smallest) item from the heap and returns it
+// via the reference parameter. If the heap was empty, the function
+// returns false and the reference parameter is left unchanged.
+// Otherwise true is returned.
+template <class T, template <class> class NodeAllocT>
+bool PairingHeapClass<T, NodeAllocT>::removeFront(T &theVal) {
+    if (root == 0) {
+        return false;
+    }
+
+    HeapNodeStruct *oldRoot = root;
+    theVal = oldRoot->value;
+    root = mergeSiblings(oldRoot->firstChild);
+    numElems--;
+
+    destroyNode(oldRoot);
+    return true;
+}
+
+// Provides a copy of the front (smallest) item without removing
+// it. Returns false, leaving outVal unchanged, if the heap is empty.
+template <class T, template <class> class NodeAllocT>
+bool PairingHeapClass<T, NodeAllocT>::peekFront(T &outVal) const {
+    if (root == 0) {
+        return false;
+    }
+    outVal = root->value;
+    return true;
+}
+
+// Returns the number of values contained in the heap.
+template <class T, template <class> class NodeAllocT>
+int PairingHeapClass<T, NodeAllocT>::getNumElems() const {
+    return numElems;
+}
+
+// Provides read access to the allocator this heap takes its nodes
+// from, e.g. to look at its allocation counters.
+template <class T, template <class> class NodeAllocT>
+const NodeAllocT<typename PairingHeapClass<T, NodeAllocT>::HeapNodeStruct>&
+PairingHeapClass<T, NodeAllocT>::getNodeAllocator() const {
+    return nodeAllocator;
+}
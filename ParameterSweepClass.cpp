@@ -0,0 +1,247 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cmath>
+using namespace std;
+
+#include "ParameterSweepClass.h"
+
+//Number of swept parameters that are light times (and so must be whole
+//numbers); they come first in the parameter names
+const int SWEEP_NUM_LIGHT_TIME_PARAMS = 4;
+
+//Names of the parameters a sweep can vary, as used in sweep files and CSV
+//headers
+static const string SWEEP_PARAM_NAMES[SWEEP_NUM_PARAMS] = {
+    "eastWestGreenTime", "eastWestYellowTime",
+    "northSouthGreenTime", "northSouthYellowTime",
+    "eastArrivalMean", "eastArrivalStdDev",
+    "westArrivalMean", "westArrivalStdDev",
+    "northArrivalMean", "northArrivalStdDev",
+    "southArrivalMean", "southArrivalStdDev"
+};
+
+//Names of the statistics columns of the CSV output, by direction code
+static const string SWEEP_BOUND_NAMES[NUM_DIRECTIONS] = {
+    "EastBound", "WestBound", "NorthBound", "SouthBound"
+};
+
+//How close to a whole number a light time must be
+const double SWEEP_WHOLE_NUMBER_TOLERANCE = 1e-9;
+
+//Returns whether a value is a whole number.
+static bool getIsWholeNumber(const double val) {
+    return fabs(val - floor(val + 0.5)) < SWEEP_WHOLE_NUMBER_TOLERANCE;
+}
+
+//Returns whether a value is allowed for the given parameter.
+static bool getIsValidParamValue(const int paramIdx, const double val) {
+    if (paramIdx < SWEEP_NUM_LIGHT_TIME_PARAMS) {
+        return val > 0 && getIsWholeNumber(val);
+    }
+    //Even offsets after the light times are means, odd ones std devs
+    if ((paramIdx - SWEEP_NUM_LIGHT_TIME_PARAMS) % 2 == 0) {
+        return val > 0;
+    }
+    return val >= 0;
+}
+
+ParameterSweepClass::ParameterSweepClass(
+                     const IntersectionSimulationClass &inBaseSim) {
+    baseSim = &inBaseSim;
+    numRanges = 0;
+    numPoints = 0;
+    results = 0;
+}
+
+ParameterSweepClass::~ParameterSweepClass() {
+    delete [] results;
+}
+
+bool ParameterSweepClass::readSweepFile(const string &sweepFname) {
+    bool success = true;
+    bool isSwept[SWEEP_NUM_PARAMS];
+    ifstream sweepF;
+    string line;
+    long numGridPoints = 1;
+
+    for (int i = 0; i < SWEEP_NUM_PARAMS; i++) {
+        isSwept[i] = false;
+    }
+    numRanges = 0;
+
+    sweepF.open(sweepFname.c_str());
+    if (sweepF.fail()) {
+        cout << "ERROR: Unable to open sweep file: " << sweepFname << endl;
+        return false;
+    }
+
+    while (success && getline(sweepF, line)) {
+        istringstream lineStream(line);
+        string paramName;
+        double firstVal;
+        double lastVal;
+        double stepVal;
+
+        if (!(lineStream >> paramName) || paramName[0] == '#') {
+            continue;
+        }
+
+        int paramIdx = 0;
+        while (paramIdx < SWEEP_NUM_PARAMS &&
+               SWEEP_PARAM_NAMES[paramIdx] != paramName) {
+            paramIdx++;
+        }
+        if (paramIdx == SWEEP_NUM_PARAMS) {
+            success = false;
+            cout << "ERROR: Unknown sweep parameter: " << paramName << endl;
+        }
+        else if (isSwept[paramIdx]) {
+            success = false;
+            cout << "ERROR: Sweep parameter listed twice: " << paramName <<
+                    endl;
+        }
+        else if (!(lineStream >> firstVal >> lastVal >> stepVal) ||
+                 stepVal <= 0 || lastVal < firstVal) {
+            success = false;
+            cout << "ERROR: Unable to read/set range for sweep parameter: " <<
+                    paramName << endl;
+        }
+        else if (!getIsValidParamValue(paramIdx, firstVal) ||
+                 !getIsValidParamValue(paramIdx, lastVal) ||
+                 (paramIdx < SWEEP_NUM_LIGHT_TIME_PARAMS &&
+                  !getIsWholeNumber(stepVal))) {
+            success = false;
+            cout << "ERROR: Invalid values in range for sweep parameter: " <<
+                    paramName << endl;
+        }
+        else {
+            //Counted as a double, as a tiny step can make more values than
+            //an int holds; the check is written so a NaN fails it too
+            double numValuesVal = floor((lastVal - firstVal) / stepVal +
+                                        SWEEP_WHOLE_NUMBER_TOLERANCE) + 1;
+            if (!(numValuesVal * numGridPoints <= SWEEP_MAX_NUM_POINTS)) {
+                success = false;
+                cout << "ERROR: Sweep has more than " <<
+                        SWEEP_MAX_NUM_POINTS << " points" << endl;
+            }
+            else {
+                SweepRangeStruct &range = ranges[numRanges];
+                range.paramIdx = paramIdx;
+                range.firstVal = firstVal;
+                range.stepVal = stepVal;
+                range.numValues = (int)numValuesVal;
+                isSwept[paramIdx] = true;
+                numRanges++;
+                numGridPoints *= range.numValues;
+            }
+        }
+    }
+    sweepF.close();
+
+    if (success && numRanges == 0) {
+        success = false;
+        cout << "ERROR: Sweep file lists no parameters: " << sweepFname <<
+                endl;
+    }
+    else if (success && numGridPoints <= 0) {
+        success = false;
+        cout << "ERROR: Sweep has no points: " << sweepFname << endl;
+    }
+    if (!success) {
+        numRanges = 0;
+        numGridPoints = 0;
+    }
+
+    delete [] results;
+    numPoints = (int)numGridPoints;
+    results = new SimulationResultStruct[numPoints > 0 ? numPoints : 1];
+    return success;
+}
+
+void ParameterSweepClass::getPointParams(const int pointIdx,
+                                         double paramVals[]) const {
+    int lightTimes[SWEEP_NUM_LIGHT_TIME_PARAMS];
+
+    baseSim->getLightTimes(lightTimes[0], lightTimes[1], lightTimes[2],
+                           lightTimes[3]);
+    for (int i = 0; i < SWEEP_NUM_LIGHT_TIME_PARAMS; i++) {
+        paramVals[i] = lightTimes[i];
+    }
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        int meanIdx = SWEEP_NUM_LIGHT_TIME_PARAMS + 2 * dirIdx;
+        baseSim->getArrivalDistribution((unsigned char)dirIdx,
+                                        paramVals[meanIdx],
+                                        paramVals[meanIdx + 1]);
+    }
+
+    //The point index is a mixed-radix number whose last digit belongs to
+    //the last range
+    int remainingIdx = pointIdx;
+    for (int rangeIdx = numRanges - 1; rangeIdx >= 0; rangeIdx--) {
+        const SweepRangeStruct &range = ranges[rangeIdx];
+        int valueIdx = remainingIdx % range.numValues;
+        remainingIdx /= range.numValues;
+        paramVals[range.paramIdx] = range.firstVal + valueIdx * range.stepVal;
+    }
+}
+
+void ParameterSweepClass::runPoint(void *sweep, const int pointIdx) {
+    ParameterSweepClass *thisSweep = (ParameterSweepClass *)sweep;
+    IntersectionSimulationClass simObj(*thisSweep->baseSim);
+    double paramVals[SWEEP_NUM_PARAMS];
+
+    thisSweep->getPointParams(pointIdx, paramVals);
+    simObj.setVerbosityLevel(VERBOSITY_SILENT);
+    simObj.setLightTimes((int)floor(paramVals[0] + 0.5),
+                         (int)floor(paramVals[1] + 0.5),
+                         (int)floor(paramVals[2] + 0.5),
+                         (int)floor(paramVals[3] + 0.5));
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        int meanIdx = SWEEP_NUM_LIGHT_TIME_PARAMS + 2 * dirIdx;
+        simObj.setArrivalDistribution((unsigned char)dirIdx,
+                                      paramVals[meanIdx],
+                                      paramVals[meanIdx + 1]);
+    }
+
+    simObj.scheduleSeedEvents();
+    while (simObj.handleNextEvent()) {
+    }
+    simObj.getResults(thisSweep->results[pointIdx]);
+}
+
+void ParameterSweepClass::run(ThreadPoolClass &threadPool) {
+    threadPool.runTasks(runPoint, this, numPoints);
+}
+
+void ParameterSweepClass::writeCsv(ostream &outStream) const {
+    double paramVals[SWEEP_NUM_PARAMS];
+
+    for (int rangeIdx = 0; rangeIdx < numRanges; rangeIdx++) {
+        outStream << SWEEP_PARAM_NAMES[ranges[rangeIdx].paramIdx] << ",";
+    }
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        outStream << "longest" << SWEEP_BOUND_NAMES[dirIdx] << "Queue,";
+    }
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        outStream << "totalAdvanced" << SWEEP_BOUND_NAMES[dirIdx] <<
+                     (dirIdx + 1 < NUM_DIRECTIONS ? "," : "\n");
+    }
+
+    for (int pointIdx = 0; pointIdx < numPoints; pointIdx++) {
+        const SimulationResultStruct &result = results[pointIdx];
+        getPointParams(pointIdx, paramVals);
+        for (int rangeIdx = 0; rangeIdx < numRanges; rangeIdx++) {
+            outStream << paramVals[ranges[rangeIdx].paramIdx] << ",";
+        }
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            outStream << result.maxQueueLengths[dirIdx] << ",";
+        }
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            outStream << result.numAdvanced[dirIdx] <<
+                         (dirIdx + 1 < NUM_DIRECTIONS ? "," : "\n");
+        }
+    }
+    outStream.flush();
+}
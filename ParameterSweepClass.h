@@ -0,0 +1,98 @@
+#ifndef _PARAMETERSWEEPCLASS_H_
+#define _PARAMETERSWEEPCLASS_H_
+
+#include <string>
+#include <ostream>
+#include "IntersectionSimulationClass.h"
+#include "ThreadPoolClass.h"
+#include "constants.h"
+
+//Number of simulation parameters a sweep can vary: the four light times,
+//then the arrival mean and standard deviation of each approach in
+//DIR_CODE_* order
+const int SWEEP_NUM_PARAMS = 4 + 2 * NUM_DIRECTIONS;
+
+//Largest number of points a sweep may have
+const long SWEEP_MAX_NUM_POINTS = 10000000;
+
+//Purpose: One swept parameter's values: first, first + step, ... up to
+//         last.
+struct SweepRangeStruct {
+    int paramIdx;     //Which parameter (index into the sweep's names)
+    double firstVal;  //First value
+    double stepVal;   //Difference between consecutive values
+    int numValues;    //Number of values
+};
+
+//Purpose: Runs a simulation setup over a grid of light timings and
+//         arrival distributions, in-process on the threads of a pool, and
+//         writes one CSV row of statistics per grid point.  Every point
+//         starts as a copy of the setup with its swept parameters
+//         replaced, and uses the setup's seed, so points differ only in
+//         their parameters.  Runs can differ a lot in length, which the
+//         pool's work stealing evens out.
+//
+//         The sweep file has one line per swept parameter, "name first
+//         last step", where name is one of eastWestGreenTime,
+//         eastWestYellowTime, northSouthGreenTime, northSouthYellowTime,
+//         eastArrivalMean, eastArrivalStdDev, westArrivalMean, ...,
+//         southArrivalStdDev.  Blank lines and lines starting with # are
+//         ignored.  The grid is every combination of the values, with the
+//         last parameter listed changing fastest.
+class ParameterSweepClass {
+    private:
+        const IntersectionSimulationClass *baseSim; //The setup every point
+                                    //starts as a copy of
+        int numRanges;              //Number of swept parameters
+        SweepRangeStruct ranges[SWEEP_NUM_PARAMS]; //Their values, in the
+                                    //order they were listed
+        int numPoints;              //Number of grid points
+        SimulationResultStruct *results; //Results, by grid point
+
+        //Fills paramVals (indexed like the parameter names) with the base
+        //setup's values, replaced by the given grid point's for the swept
+        //parameters.
+        void getPointParams(const int pointIdx, double paramVals[]) const;
+
+        //Thread pool task: runs one grid point and stores its results.
+        static void runPoint(void *sweep, const int pointIdx);
+
+        //A sweep owns its results array, so it can't be copied.
+        ParameterSweepClass(const ParameterSweepClass &rhs);
+        ParameterSweepClass& operator=(const ParameterSweepClass &rhs);
+
+    public:
+        //Prepares to sweep the given simulation, which has read its
+        //parameters (but not scheduled its seed events).  The simulation
+        //must stay alive and unchanged while the sweep is in use.
+        ParameterSweepClass(const IntersectionSimulationClass &inBaseSim);
+
+        //Frees the results.
+        ~ParameterSweepClass();
+
+        //Reads the parameter ranges from a sweep file.  Prints an error
+        //and returns false if the file can't be read, names an unknown or
+        //repeated parameter, gives a range that is empty or has invalid
+        //values (e.g. a fractional light time), or makes more than
+        //SWEEP_MAX_NUM_POINTS points.
+        bool readSweepFile(const std::string &sweepFname);
+
+        //Returns the number of grid points.
+        int getNumPoints() const {
+            return numPoints;
+        }
+
+        //Runs every grid point on the pool's threads.
+        void run(ThreadPoolClass &threadPool);
+
+        //Returns the results of one grid point, once run has been called.
+        const SimulationResultStruct& getResult(const int pointIdx) const {
+            return results[pointIdx];
+        }
+
+        //Writes a header line, then one line per grid point with the
+        //swept parameters' values and the point's statistics, as CSV.
+        void writeCsv(std::ostream &outStream) const;
+};
+
+#endif // _PARAMETERSWEEPCLASS_H_
@@ -0,0 +1,78 @@
+#ifndef _POOLNODEALLOCATORCLASS_H
+#define _POOLNODEALLOCATORCLASS_H
+
+using namespace std;
+
+// A slab/free-list node allocator for the linked containers. Storage for
+// nodes is taken from the heap in slabs that double in size (up to a
+// limit), and nodes that are given back go onto a free list to be handed
+// out again, so once a container has reached its working size it never
+// touches the heap again. Each container owns its own pool, and the
+// slabs are only returned to the heap when the pool is destroyed.
+template <class NodeT>
+class PoolNodeAllocatorClass {
+    private:
+        // One slot of a slab. While a slot is free its storage holds the
+        // link to the next free slot; the other members only force
+        // suitable alignment for the node.
+        union SlotUnion {
+            SlotUnion *nextFree;
+            char nodeStorage[sizeof(NodeT)];
+            double alignDouble;
+            long alignLong;
+            void *alignPointer;
+        };
+
+        SlotUnion **slabs;   // Every slab taken from the heap so far.
+        int numSlabs;        // Number of slabs in use.
+        int slabCapacity;    // Number of slab pointers "slabs" can hold.
+        int nextSlabSize;    // Number of slots the next slab will get.
+        SlotUnion *freeList; // First free slot, or NULL if none.
+
+        long numHeapAllocs;      // Number of allocations made from the heap.
+        long numNodesAllocated;  // Number of nodes ever handed out.
+        long numNodesInUse;      // Number of nodes handed out and not yet
+                                 // given back.
+
+        // Takes a new slab from the heap and threads its slots onto the
+        // free list.
+        void addSlab();
+
+    public:
+        // Default Constructor. No storage is taken until the first node
+        // is allocated.
+        PoolNodeAllocatorClass();
+
+        // Copy constructor. Pools are never shared or copied along with
+        // a container, so the copy starts out empty.
+        PoolNodeAllocatorClass(const PoolNodeAllocatorClass<NodeT> &rhs);
+
+        // Destructor. Returns every slab to the heap. All nodes must have
+        // been given back (and destroyed) by then.
+        ~PoolNodeAllocatorClass();
+
+        // Assignment operator. Leaves this pool (and its counters)
+        // untouched, for the same reason as the copy constructor.
+        PoolNodeAllocatorClass<NodeT>& operator=(
+            const PoolNodeAllocatorClass<NodeT> &rhs);
+
+        // Returns uninitialized storage big enough for one NodeT.
+        void* allocate();
+
+        // Gives back storage obtained from allocate. The node that lived
+        // there must already have been destroyed.
+        void deallocate(void *nodeStorage);
+
+        // Returns the number of allocations made from the heap (slabs,
+        // plus growing the table of slabs).
+        long getNumHeapAllocs() const;
+
+        // Returns the number of nodes ever handed out.
+        long getNumNodesAllocated() const;
+
+        // Returns the number of nodes currently handed out.
+        long getNumNodesInUse() const;
+};
+
+#include "PoolNodeAllocatorClass.inl"
+#endif
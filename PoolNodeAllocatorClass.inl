@@ -0,0 +1,129 @@
+// Number of slots in a pool's first slab, and the most any slab gets.
+const int POOL_FIRST_SLAB_SLOTS = 32;
+const int POOL_MAX_SLAB_SLOTS = 4096;
+
+// Takes a new slab from the heap and threads its slots onto the
+// free list.
+template <class NodeT>
+void PoolNodeAllocatorClass<NodeT>::addSlab() {
+    // make room to remember the slab so it can be freed later
+    if (numSlabs == slabCapacity) {
+        int newCapacity = 8;
+        if (slabCapacity > 0) {
+            newCapacity = slabCapacity * 2;
+        }
+        SlotUnion **newSlabs = new SlotUnion*[newCapacity];
+        for (int i = 0; i < numSlabs; i++) {
+            newSlabs[i] = slabs[i];
+        }
+        delete [] slabs;
+        slabs = newSlabs;
+        slabCapacity = newCapacity;
+        numHeapAllocs++;
+    }
+
+    SlotUnion *newSlab = new SlotUnion[nextSlabSize];
+    numHeapAllocs++;
+    slabs[numSlabs] = newSlab;
+    numSlabs++;
+
+    for (int i = 0; i < nextSlabSize - 1; i++) {
+        newSlab[i].nextFree = &newSlab[i + 1];
+    }
+    newSlab[nextSlabSize - 1].nextFree = freeList;
+    freeList = newSlab;
+
+    if (nextSlabSize < POOL_MAX_SLAB_SLOTS) {
+        nextSlabSize *= 2;
+    }
+}
+
+// Default Constructor. No storage is taken until the first node
+// is allocated.
+template <class NodeT>
+PoolNodeAllocatorClass<NodeT>::PoolNodeAllocatorClass() {
+    slabs = 0;
+    numSlabs = 0;
+    slabCapacity = 0;
+    nextSlabSize = POOL_FIRST_SLAB_SLOTS;
+    freeList = 0;
+    numHeapAllocs = 0;
+    numNodesAllocated = 0;
+    numNodesInUse = 0;
+}
+
+// Copy constructor. Pools are never shared or copied along with
+// a container, so the copy starts out empty.
+template <class NodeT>
+PoolNodeAllocatorClass<NodeT>::PoolNodeAllocatorClass(
+    const PoolNodeAllocatorClass<NodeT> &) {
+    slabs = 0;
+    numSlabs = 0;
+    slabCapacity = 0;
+    nextSlabSize = POOL_FIRST_SLAB_SLOTS;
+    freeList = 0;
+    numHeapAllocs = 0;
+    numNodesAllocated = 0;
+    numNodesInUse = 0;
+}
+
+// Destructor. Returns every slab to the heap. All nodes must have
+// been given back (and destroyed) by then.
+template <class NodeT>
+PoolNodeAllocatorClass<NodeT>::~PoolNodeAllocatorClass() {
+    for (int i = 0; i < numSlabs; i++) {
+        delete [] slabs[i];
+    }
+    delete [] slabs;
+}
+
+// Assignment operator. Leaves this pool (and its counters)
+// untouched, for the same reason as the copy constructor.
+template <class NodeT>
+PoolNodeAllocatorClass<NodeT>& PoolNodeAllocatorClass<NodeT>::operator=(
+    const PoolNodeAllocatorClass<NodeT> &) {
+    return *this;
+}
+
+// Returns uninitialized storage big enough for one NodeT.
+template <class NodeT>
+void* PoolNodeAllocatorClass<NodeT>::allocate() {
+    if (freeList == 0) {
+        addSlab();
+    }
+    SlotUnion *slot = freeList;
+    freeList = slot->nextFree;
+
+    numNodesAllocated++;
+    numNodesInUse++;
+    return slot->nodeStorage;
+}
+
+// Gives back storage obtained from allocate. The node that lived
+// there must already have been destroyed.
+template <class NodeT>
+void PoolNodeAllocatorClass<NodeT>::deallocate(void *nodeStorage) {
+    SlotUnion *slot = reinterpret_cast<SlotUnion*>(nodeStorage);
+    slot->nextFree = freeList;
+    freeList = slot;
+    numNodesInUse--;
+}
+
+// Returns the number of allocations made from the heap (slabs,
+// plus growing the table of slabs).
+template <class NodeT>
+long PoolNodeAllocatorClass<NodeT>::getNumHeapAllocs() const {
+    return numHeapAllocs;
+}
+
+// Returns the number of nodes ever handed out.
+template <class NodeT>
+long PoolNodeAllocatorClass<NodeT>::getNumNodesAllocated() const {
+    return numNodesAllocated;
+}
+
+// Returns the number of nodes currently handed out.
+template <class NodeT>
+long PoolNodeAllocatorClass<NodeT>::getNumNodesInUse() const {
+    return numNodesInUse;
+}
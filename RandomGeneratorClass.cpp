@@ -0,0 +1,266 @@
+#include <cmath>
+using namespace std;
+
+#include "RandomGeneratorClass.h"
+
+//Distance between the two state words combined for each new value
+const int RANDOM_FEEDBACK_SEPARATION = 3;
+
+//Number of values thrown away after seeding, to get away from the
+//(linear congruential) values the state was filled with
+const int RANDOM_NUM_DISCARDED = 10 * RANDOM_STATE_SIZE;
+
+//Parameters of the "minimal standard" generator used to fill the state
+//from the seed, and Schrage's factorization of its modulus so that the
+//products fit in 32 bits
+const int SEED_MULTIPLIER = 16807;
+const int SEED_MODULUS = 2147483647;
+const int SEED_QUOTIENT = 127773;   //SEED_MODULUS / SEED_MULTIPLIER
+const int SEED_REMAINDER = 2836;    //SEED_MODULUS % SEED_MULTIPLIER
+
+ZigguratTablesStruct::ZigguratTablesStruct() {
+    const double TWO_TO_31 = 2147483648.0;
+    double edgeX = ZIGGURAT_TAIL_START;
+    double prevEdgeX = edgeX;
+    double baseWidth = ZIGGURAT_LAYER_AREA / exp(-0.5 * edgeX * edgeX);
+
+    limits[0] = (unsigned int)((edgeX / baseWidth) * TWO_TO_31);
+    limits[1] = 0;
+    widths[0] = baseWidth / TWO_TO_31;
+    widths[ZIGGURAT_NUM_LAYERS - 1] = edgeX / TWO_TO_31;
+    heights[0] = 1.0;
+    heights[ZIGGURAT_NUM_LAYERS - 1] = exp(-0.5 * edgeX * edgeX);
+    for (int i = ZIGGURAT_NUM_LAYERS - 2; i >= 1; i--) {
+        edgeX = sqrt(-2.0 * log(ZIGGURAT_LAYER_AREA / edgeX +
+                                exp(-0.5 * edgeX * edgeX)));
+        limits[i + 1] = (unsigned int)((edgeX / prevEdgeX) * TWO_TO_31);
+        prevEdgeX = edgeX;
+        heights[i] = exp(-0.5 * edgeX * edgeX);
+        widths[i] = edgeX / TWO_TO_31;
+    }
+}
+
+const ZigguratTablesStruct ZIGGURAT_TABLES;
+
+//Returns the high and low 32-bit words of the 64-bit product of a and b.
+static inline void multiplyHighLow(const unsigned int a, const unsigned int b,
+                                   unsigned int &high, unsigned int &low) {
+    unsigned long long product = (unsigned long long)a * b;
+    high = (unsigned int)(product >> 32);
+    low = (unsigned int)product;
+}
+
+RandomGeneratorClass::RandomGeneratorClass(const int inSeedVal) {
+    randomMode = RANDOM_MODE_RAND_COMPAT;
+    seedVal = inSeedVal;
+    streamId = 0;
+    substreamId = 0;
+    restart();
+}
+
+void RandomGeneratorClass::setSeed(const int inSeedVal) {
+    seedVal = inSeedVal;
+    restart();
+}
+
+void RandomGeneratorClass::setStream(const unsigned int inStreamId,
+                                     const unsigned int inSubstreamId) {
+    streamId = inStreamId;
+    substreamId = inSubstreamId;
+    restart();
+}
+
+void RandomGeneratorClass::setMode(const int inRandomMode) {
+    randomMode = inRandomMode;
+    restart();
+}
+
+void RandomGeneratorClass::restart() {
+    if (randomMode == RANDOM_MODE_PHILOX) {
+        blockCounter[0] = 0;
+        blockCounter[1] = 0;
+        blockIdx = PHILOX_BLOCK_SIZE;
+        return;
+    }
+
+    int word = (seedVal == 0) ? 1 : seedVal;
+
+    state[0] = (unsigned int)word;
+    for (int i = 1; i < RANDOM_STATE_SIZE; i++) {
+        int hi = word / SEED_QUOTIENT;
+        int lo = word % SEED_QUOTIENT;
+        word = SEED_MULTIPLIER * lo - SEED_REMAINDER * hi;
+        if (word < 0) {
+            word += SEED_MODULUS;
+        }
+        state[i] = (unsigned int)word;
+    }
+
+    frontIdx = RANDOM_FEEDBACK_SEPARATION;
+    rearIdx = 0;
+    for (int i = 0; i < RANDOM_NUM_DISCARDED; i++) {
+        getNext();
+    }
+}
+
+void RandomGeneratorClass::computePhiloxBlock(const unsigned int counter[],
+                                              const unsigned int key[],
+                                              unsigned int output[]) {
+    //Kept in locals rather than arrays so the rounds stay in registers
+    unsigned int counter0 = counter[0];
+    unsigned int counter1 = counter[1];
+    unsigned int counter2 = counter[2];
+    unsigned int counter3 = counter[3];
+    unsigned int key0 = key[0];
+    unsigned int key1 = key[1];
+    unsigned int high0, low0, high1, low1;
+
+    for (int round = 0; round < PHILOX_NUM_ROUNDS; round++) {
+        multiplyHighLow(PHILOX_MULTIPLIER_0, counter0, high0, low0);
+        multiplyHighLow(PHILOX_MULTIPLIER_1, counter2, high1, low1);
+        counter0 = high1 ^ counter1 ^ key0;
+        counter1 = low1;
+        counter2 = high0 ^ counter3 ^ key1;
+        counter3 = low0;
+        key0 += PHILOX_KEY_BUMP_0;
+        key1 += PHILOX_KEY_BUMP_1;
+    }
+    output[0] = counter0;
+    output[1] = counter1;
+    output[2] = counter2;
+    output[3] = counter3;
+}
+
+void RandomGeneratorClass::makePhiloxBlock() {
+    unsigned int counter[PHILOX_BLOCK_SIZE];
+    unsigned int key[2];
+
+    counter[0] = blockCounter[0];
+    counter[1] = blockCounter[1];
+    counter[2] = substreamId;
+    counter[3] = 0;
+    key[0] = (unsigned int)seedVal;
+    key[1] = streamId;
+    computePhiloxBlock(counter, key, block);
+    blockIdx = 0;
+
+    blockCounter[0]++;
+    if (blockCounter[0] == 0) {
+        blockCounter[1]++;
+    }
+}
+
+double RandomGeneratorClass::getStandardNormalFrom(unsigned int word) {
+    while (true) {
+        //The low bits pick the layer and the rest, kept separate so the
+        //two are independent, give the signed position within it
+        int layerIdx = (int)(word & (ZIGGURAT_NUM_LAYERS - 1));
+        int signedPos = (int)(word & ~(unsigned int)(ZIGGURAT_NUM_LAYERS - 1));
+        unsigned int absPos = (signedPos < 0) ? -(unsigned int)signedPos :
+                                                (unsigned int)signedPos;
+        double x = signedPos * ZIGGURAT_TABLES.widths[layerIdx];
+
+        if (absPos < ZIGGURAT_TABLES.limits[layerIdx]) {
+            return x;
+        }
+        if (layerIdx == 0) {
+            //Sample from the tail beyond the base strip
+            double tailX;
+            double tailY;
+            do {
+                tailX = -log(getPhiloxOpenUnit()) / ZIGGURAT_TAIL_START;
+                tailY = -log(getPhiloxOpenUnit());
+            } while (tailY + tailY < tailX * tailX);
+            return (signedPos > 0) ? ZIGGURAT_TAIL_START + tailX :
+                                     -ZIGGURAT_TAIL_START - tailX;
+        }
+        double layerHeight = ZIGGURAT_TABLES.heights[layerIdx];
+        double heightAbove = ZIGGURAT_TABLES.heights[layerIdx - 1];
+        if (layerHeight + getPhiloxOpenUnit() * (heightAbove - layerHeight) <
+            exp(-0.5 * x * x)) {
+            return x;
+        }
+        word = getNextPhiloxWord();
+    }
+}
+
+int RandomGeneratorClass::getNext() {
+    if (randomMode == RANDOM_MODE_PHILOX) {
+        return (int)(getNextPhiloxWord() >> 1);
+    }
+
+    state[frontIdx] += state[rearIdx];
+    int result = (int)(state[frontIdx] >> 1);
+
+    frontIdx++;
+    if (frontIdx == RANDOM_STATE_SIZE) {
+        frontIdx = 0;
+    }
+    rearIdx++;
+    if (rearIdx == RANDOM_STATE_SIZE) {
+        rearIdx = 0;
+    }
+    return result;
+}
+
+int RandomGeneratorClass::getUniform(const int minVal, const int maxVal) {
+    if (randomMode == RANDOM_MODE_PHILOX) {
+        //Scale a 32-bit word into the range with one multiply, rejecting
+        //the few words that would make some results more likely (Lemire)
+        unsigned int rangeSize = (unsigned int)(maxVal - minVal) + 1;
+        if (rangeSize == 0) {
+            return minVal + (int)getNextPhiloxWord();
+        }
+        unsigned long long scaled =
+                   (unsigned long long)getNextPhiloxWord() * rangeSize;
+        if ((unsigned int)scaled < rangeSize) {
+            unsigned int threshold = -rangeSize % rangeSize;
+            while ((unsigned int)scaled < threshold) {
+                scaled = (unsigned long long)getNextPhiloxWord() * rangeSize;
+            }
+        }
+        return minVal + (int)(scaled >> 32);
+    }
+
+    int uniRand;
+    uniRand = getNext() % ((maxVal + 1) - minVal) + minVal;
+    return (uniRand);
+}
+
+int RandomGeneratorClass::getPositiveNormal(const double meanVal,
+                                            const double stdDev) {
+    const int NUM_UNIFORM = 12;
+    const int MAX = 1000;
+    const double ORIGINAL_MEAN = NUM_UNIFORM * 0.5;
+    double sum;
+    double standardNormal;
+    double newNormal;
+    int uni;
+
+    if (randomMode == RANDOM_MODE_PHILOX) {
+        newNormal = meanVal + stdDev *
+                    getStandardNormalFrom(getNextPhiloxWord());
+        if (newNormal < 0) {
+            newNormal *= - 1;
+        }
+        return ((int)newNormal);
+    }
+
+    sum = 0;
+    for (int i = 0; i < NUM_UNIFORM; i++) {
+        uni = getNext() % (MAX + 1);
+        sum += uni;
+    }
+    sum = sum / MAX;
+    standardNormal = sum - ORIGINAL_MEAN;
+    newNormal = meanVal + stdDev * standardNormal;
+
+    //The purpose of this function is to get a POSITIVE integer, so
+    //if the computed value ends up being negative, just flip the
+    //sign.  Not ideal since the result won't necessarily be a
+    //true normal distribution, but this will suffice for our purpose.
+    if (newNormal < 0) {
+        newNormal *= - 1;
+    }
+    return ((int)newNormal);
+}
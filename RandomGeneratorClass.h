@@ -0,0 +1,160 @@
+#ifndef _RANDOMGENERATORCLASS_H_
+#define _RANDOMGENERATORCLASS_H_
+
+//Number of 32-bit words of generator state in rand() compatible mode
+const int RANDOM_STATE_SIZE = 31;
+
+//Number of 32-bit words produced by one Philox block
+const int PHILOX_BLOCK_SIZE = 4;
+
+//Modes a generator can run in: reproducing glibc's rand() sequence (and
+//the original sum-of-uniforms normal approximation), or the counter-based
+//Philox4x32-10 generator with an unbiased uniform and a ziggurat normal
+//sampler
+const int RANDOM_MODE_RAND_COMPAT = 0;
+const int RANDOM_MODE_PHILOX = 1;
+
+//Philox4x32-10 round multipliers and key schedule increments
+const unsigned int PHILOX_MULTIPLIER_0 = 0xD2511F53u;
+const unsigned int PHILOX_MULTIPLIER_1 = 0xCD9E8D57u;
+const unsigned int PHILOX_KEY_BUMP_0 = 0x9E3779B9u;
+const unsigned int PHILOX_KEY_BUMP_1 = 0xBB67AE85u;
+const int PHILOX_NUM_ROUNDS = 10;
+
+//Number of layers of the ziggurat, the x coordinate where its base strip
+//meets the tail, and the area of each layer
+const int ZIGGURAT_NUM_LAYERS = 128;
+const double ZIGGURAT_TAIL_START = 3.442619855899;
+const double ZIGGURAT_LAYER_AREA = 9.91256303526217e-3;
+
+//Purpose: The ziggurat's layer tables for a standard normal density
+//         (Marsaglia and Tsang), built once when the program starts.
+//         Layer i's right edge is at widths[i] * 2^31; a value whose
+//         magnitude is below limits[i] lies inside every layer above it
+//         and is accepted at once.  heights[i] is the density at layer
+//         i's right edge.
+struct ZigguratTablesStruct {
+    unsigned int limits[ZIGGURAT_NUM_LAYERS];
+    double widths[ZIGGURAT_NUM_LAYERS];
+    double heights[ZIGGURAT_NUM_LAYERS];
+
+    ZigguratTablesStruct();
+};
+
+extern const ZigguratTablesStruct ZIGGURAT_TABLES;
+
+//Purpose: A pseudo-random number generator whose state belongs to the
+//         object, so each simulation can have its own and several can run
+//         side by side (or on different threads) without disturbing each
+//         other.
+//
+//         In rand() compatible mode (the default) it produces exactly the
+//         same sequence as the C library's rand() does after srand() on
+//         glibc (the additive feedback generator r[i] = r[i-3] + r[i-31]),
+//         and draws uniform and normal values the way the original
+//         version of the simulation did, so results match it.
+//
+//         In Philox mode the values are the Philox4x32-10 block cipher
+//         applied to a 64-bit counter and a substream number, keyed by
+//         the seed and a stream number, so every (seed, stream, substream)
+//         combination is an independent stream.
+//         Uniform integers are drawn without modulo bias and normal
+//         values with a 128-layer ziggurat, which usually needs one
+//         32-bit word per sample instead of twelve.
+class RandomGeneratorClass {
+    private:
+        int randomMode; //RANDOM_MODE_* value the generator runs in
+        int seedVal;    //Seed the current sequence was started from
+        unsigned int streamId; //Stream number (Philox mode only)
+        unsigned int substreamId; //Substream within the stream (Philox
+                                  //mode only)
+
+        //rand() compatible mode state
+        unsigned int state[RANDOM_STATE_SIZE]; //The last 31 values of the
+                                               //feedback sequence
+        int frontIdx; //Index of the state word that is updated next
+        int rearIdx;  //Index of the state word added into it
+
+        //Philox mode state
+        unsigned int blockCounter[2]; //Index of the next block to make,
+                                      //low word first
+        unsigned int block[PHILOX_BLOCK_SIZE]; //Current block of output
+        int blockIdx; //Index of the next unused word of the block
+
+        //Restarts the sequence of the current mode from seedVal,
+        //streamId and substreamId.
+        void restart();
+
+        //Returns the next 32-bit word of the Philox sequence.
+        unsigned int getNextPhiloxWord() {
+            if (blockIdx == PHILOX_BLOCK_SIZE) {
+                makePhiloxBlock();
+            }
+            return block[blockIdx++];
+        }
+
+        //Encrypts the block counter into a new block of output and
+        //advances the counter.
+        void makePhiloxBlock();
+
+        //Returns a double uniformly distributed strictly between 0 and 1,
+        //from the Philox sequence.
+        double getPhiloxOpenUnit() {
+            return (getNextPhiloxWord() + 0.5) * (1.0 / 4294967296.0);
+        }
+
+    public:
+        //Creates a generator in rand() compatible mode with the given seed
+        //(1 by default, which is also what rand() uses when srand() was
+        //never called).
+        RandomGeneratorClass(const int inSeedVal = 1);
+
+        //Restarts the sequence from the given seed, like srand().  The
+        //mode and stream are kept.
+        void setSeed(const int inSeedVal);
+
+        //Selects the stream, and the substream within it, (Philox mode
+        //only; rand() compatible mode has a single stream per seed) and
+        //restarts the sequence.
+        void setStream(const unsigned int inStreamId,
+                       const unsigned int inSubstreamId = 0);
+
+        //Selects the mode (a RANDOM_MODE_* value) and restarts the
+        //sequence from the current seed.
+        void setMode(const int inRandomMode);
+
+        //Returns the mode the generator runs in.
+        int getMode() const {
+            return randomMode;
+        }
+
+        //Returns the next value of the sequence, from 0 to 2^31 - 1, like
+        //rand().
+        int getNext();
+
+        //Returns an integer value from a uniform distribution
+        //between the specified min and max values.
+        int getUniform(const int minVal, const int maxVal);
+
+        //Returns an integer drawn from a normal distribution
+        //described by the input mean and standard deviation
+        //values.  Note: this may not result in a truly proper
+        //normal distribution because it ensures that negative
+        //values are never returned!
+        int getPositiveNormal(const double meanVal, const double stdDev);
+
+        //Returns a standard normal value drawn with the ziggurat method,
+        //using firstWord as the first 32-bit word of the draw and taking
+        //any more it needs from this generator's sequence (Philox mode
+        //only).  Lets callers that test the common case themselves, a
+        //block of words at a time, finish the rare rejected draws.
+        double getStandardNormalFrom(unsigned int firstWord);
+
+        //Computes the Philox4x32-10 block for the given four-word counter
+        //and two-word key.
+        static void computePhiloxBlock(const unsigned int counter[],
+                                       const unsigned int key[],
+                                       unsigned int output[]);
+};
+
+#endif // _RANDOMGENERATORCLASS_H_
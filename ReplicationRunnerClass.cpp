@@ -0,0 +1,387 @@
+#include <iostream>
+#include <string>
+#include <cmath>
+using namespace std;
+
+#include "ReplicationRunnerClass.h"
+
+//Approach names used when printing the summary, by direction code
+static const string SUMMARY_BOUND_NAMES[NUM_DIRECTIONS] = {
+    "east-bound", "west-bound", "north-bound", "south-bound"
+};
+
+//Prints one line of the confidence intervals after a sequential run.
+static void printIntervalLine(const string &statName,
+                              const StatAccumulatorClass &stats) {
+    cout << "  " << statName << ": " << stats.getMean() << " +/- " <<
+            stats.getConfidenceHalfWidth() << endl;
+}
+
+//Beginnings and ends of the names of the REPLICATION_STAT_* statistics,
+//which go either side of the approach name
+static const string STAT_NAME_STARTS[REPLICATION_NUM_STATS] = {
+    "Longest ", "Total cars advanced ", "Time-weighted mean ", "Mean delay of "
+};
+static const string STAT_NAME_ENDS[REPLICATION_NUM_STATS] = {
+    " queue", "", " queue", " cars"
+};
+
+//Returns the given statistic (a REPLICATION_STAT_* value) of the given
+//approach from one replication's results.
+static double getResultValue(const SimulationResultStruct &result,
+                             const int statIdx, const int dirIdx) {
+    if (statIdx == REPLICATION_STAT_MAX_QUEUE_LENGTH) {
+        return result.maxQueueLengths[dirIdx];
+    }
+    else if (statIdx == REPLICATION_STAT_NUM_ADVANCED) {
+        return result.numAdvanced[dirIdx];
+    }
+    else if (statIdx == REPLICATION_STAT_MEAN_QUEUE_LENGTH) {
+        return result.meanQueueLengths[dirIdx];
+    }
+    return result.meanDelays[dirIdx];
+}
+
+//Returns a fraction as a percentage rounded to a tenth of a percent, so
+//the round-off in a variance reduction near 0 isn't printed.
+static double getRoundedPercent(const double fraction) {
+    return floor(fraction * 1000 + 0.5) / 10;
+}
+
+//Prints one line of the replication summary.
+static void printSummaryLine(const string &statName,
+                             const StatAccumulatorClass &stats) {
+    cout << "  " << statName << " - Mean: " << stats.getMean() <<
+            " StdDev: " << stats.getStdDev() << " Min: " << stats.getMin() <<
+            " Max: " << stats.getMax() << endl;
+}
+
+ReplicationRunnerClass::ReplicationRunnerClass(
+                        const IntersectionSimulationClass &inPrototypeSim,
+                        const int inNumReplications) {
+    prototypeSim = &inPrototypeSim;
+    numReplications = (inNumReplications < 0) ? 0 : inNumReplications;
+    numReplicationsRun = 0;
+    firstBatchReplicationIdx = 0;
+    targetPrecision = 0;
+    comparisonSim = 0;
+    isAntitheticPairs = false;
+    results = new SimulationResultStruct[numReplications > 0 ?
+                                          numReplications : 1];
+    comparisonResults = 0;
+    pthread_mutex_init(&delayMutex, 0);
+}
+
+ReplicationRunnerClass::~ReplicationRunnerClass() {
+    pthread_mutex_destroy(&delayMutex);
+    delete [] results;
+    delete [] comparisonResults;
+}
+
+void ReplicationRunnerClass::setComparisonSim(
+                     const IntersectionSimulationClass &inComparisonSim) {
+    comparisonSim = &inComparisonSim;
+    if (comparisonResults == 0) {
+        comparisonResults = new SimulationResultStruct[numReplications > 0 ?
+                                                       numReplications : 1];
+    }
+}
+
+bool ReplicationRunnerClass::setIsAntitheticPairs(
+                             const bool inIsAntitheticPairs) {
+    if (inIsAntitheticPairs &&
+        (prototypeSim->getRandomMode() != RANDOM_MODE_PHILOX ||
+         (comparisonSim != 0 &&
+          comparisonSim->getRandomMode() != RANDOM_MODE_PHILOX))) {
+        return false;
+    }
+    isAntitheticPairs = inIsAntitheticPairs;
+    return true;
+}
+
+void ReplicationRunnerClass::runReplication(void *runner,
+                                            const int taskIdx) {
+    ReplicationRunnerClass *thisRunner = (ReplicationRunnerClass *)runner;
+    int numSetups = (thisRunner->comparisonSim != 0) ? 2 : 1;
+    int replicationIdx = thisRunner->firstBatchReplicationIdx +
+                         taskIdx / numSetups;
+    bool isComparison = (taskIdx % numSetups == 1);
+    IntersectionSimulationClass simObj(isComparison ?
+                                       *thisRunner->comparisonSim :
+                                       *thisRunner->prototypeSim);
+
+    //Both members of an antithetic pair, and both setups, share a seed
+    simObj.setVerbosityLevel(VERBOSITY_SILENT);
+    simObj.setIsAntithetic(thisRunner->isAntitheticPairs &&
+                           replicationIdx % 2 == 1);
+    simObj.setRandomSeed(thisRunner->prototypeSim->getRandomSeed() +
+                         replicationIdx / thisRunner->getNumPerSample());
+    simObj.scheduleSeedEvents();
+    while (simObj.handleNextEvent()) {
+    }
+
+    if (isComparison) {
+        simObj.getResults(thisRunner->comparisonResults[replicationIdx]);
+        return;
+    }
+    simObj.getResults(thisRunner->results[replicationIdx]);
+    if (simObj.getIsDelayTrackingEnabled()) {
+        pthread_mutex_lock(&thisRunner->delayMutex);
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            thisRunner->delayHistograms[dirIdx].merge(
+                        simObj.getDelayHistogram((unsigned char)dirIdx));
+        }
+        pthread_mutex_unlock(&thisRunner->delayMutex);
+    }
+}
+
+double ReplicationRunnerClass::getSampleValue(
+                     const SimulationResultStruct *sampleResults,
+                     const int sampleIdx, const int statIdx,
+                     const int dirIdx) const {
+    int numPerSample = getNumPerSample();
+    double valueSum = 0;
+
+    for (int replicationIdx = sampleIdx * numPerSample;
+         replicationIdx < (sampleIdx + 1) * numPerSample; replicationIdx++) {
+        valueSum += getResultValue(sampleResults[replicationIdx], statIdx,
+                                   dirIdx);
+    }
+    return valueSum / numPerSample;
+}
+
+void ReplicationRunnerClass::runBatch(ThreadPoolClass &threadPool,
+                                      const int numInBatch) {
+    int numSetups = (comparisonSim != 0) ? 2 : 1;
+
+    firstBatchReplicationIdx = numReplicationsRun;
+    threadPool.runTasks(runReplication, this, numInBatch * numSetups);
+    numReplicationsRun += numInBatch;
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        maxQueueLengthStats[dirIdx].clear();
+        numAdvancedStats[dirIdx].clear();
+        meanQueueLengthStats[dirIdx].clear();
+        meanDelayStats[dirIdx].clear();
+    }
+    for (int sampleIdx = 0;
+         sampleIdx < numReplicationsRun / getNumPerSample(); sampleIdx++) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            maxQueueLengthStats[dirIdx].addValue(getSampleValue(results,
+                     sampleIdx, REPLICATION_STAT_MAX_QUEUE_LENGTH, dirIdx));
+            numAdvancedStats[dirIdx].addValue(getSampleValue(results,
+                     sampleIdx, REPLICATION_STAT_NUM_ADVANCED, dirIdx));
+            meanQueueLengthStats[dirIdx].addValue(getSampleValue(results,
+                     sampleIdx, REPLICATION_STAT_MEAN_QUEUE_LENGTH, dirIdx));
+            meanDelayStats[dirIdx].addValue(getSampleValue(results,
+                     sampleIdx, REPLICATION_STAT_MEAN_DELAY, dirIdx));
+        }
+    }
+}
+
+void ReplicationRunnerClass::run(ThreadPoolClass &threadPool) {
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        delayHistograms[dirIdx].clear();
+    }
+    numReplicationsRun = 0;
+    targetPrecision = 0;
+    runBatch(threadPool, numReplications);
+}
+
+void ReplicationRunnerClass::runSequential(ThreadPoolClass &threadPool,
+                                           const double inTargetPrecision,
+                                           const int batchSize) {
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        delayHistograms[dirIdx].clear();
+    }
+    numReplicationsRun = 0;
+    targetPrecision = inTargetPrecision;
+
+    //The first batch is made up to the fewest replications checked, and
+    //every batch to whole antithetic pairs
+    int numPerSample = getNumPerSample();
+    int minNumInBatch = REPLICATION_MIN_SEQUENTIAL * numPerSample;
+    int numInBatch = (batchSize > minNumInBatch) ? batchSize : minNumInBatch;
+    while (numReplicationsRun < numReplications) {
+        numInBatch += (numPerSample - numInBatch % numPerSample) %
+                      numPerSample;
+        if (numInBatch > numReplications - numReplicationsRun) {
+            numInBatch = numReplications - numReplicationsRun;
+        }
+        runBatch(threadPool, numInBatch);
+        if (numReplicationsRun >= minNumInBatch &&
+            getMaxRelativeHalfWidth() <= targetPrecision) {
+            return;
+        }
+        numInBatch = (batchSize > 0) ? batchSize : 1;
+    }
+}
+
+//Raises maxRelativeHalfWidth to the half-width of the statistic's
+//confidence interval relative to its mean, if that is larger and the
+//mean isn't 0.
+static void updateMaxRelativeHalfWidth(const StatAccumulatorClass &stats,
+                                       double &maxRelativeHalfWidth) {
+    if (stats.getMean() != 0) {
+        double relativeHalfWidth = stats.getConfidenceHalfWidth() /
+                                   fabs(stats.getMean());
+        if (relativeHalfWidth > maxRelativeHalfWidth) {
+            maxRelativeHalfWidth = relativeHalfWidth;
+        }
+    }
+}
+
+double ReplicationRunnerClass::getMaxRelativeHalfWidth() const {
+    double maxRelativeHalfWidth = 0;
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        updateMaxRelativeHalfWidth(maxQueueLengthStats[dirIdx],
+                                   maxRelativeHalfWidth);
+        updateMaxRelativeHalfWidth(numAdvancedStats[dirIdx],
+                                   maxRelativeHalfWidth);
+        if (prototypeSim->getIsDelayTrackingEnabled()) {
+            updateMaxRelativeHalfWidth(meanDelayStats[dirIdx],
+                                       maxRelativeHalfWidth);
+        }
+    }
+    return maxRelativeHalfWidth;
+}
+
+void ReplicationRunnerClass::printStatistics() const {
+    int firstSeed = prototypeSim->getRandomSeed();
+
+    cout << "===== Begin Replication Statistics =====" << endl;
+    cout << "  Replications: " << numReplicationsRun << " (seeds " <<
+            firstSeed << " to " <<
+            firstSeed + numReplicationsRun / getNumPerSample() - 1 <<
+            (isAntitheticPairs ? ", in antithetic pairs)" : ")") << endl;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        printSummaryLine("Longest " + SUMMARY_BOUND_NAMES[dirIdx] + " queue",
+                         maxQueueLengthStats[dirIdx]);
+    }
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        printSummaryLine("Total cars advanced " + SUMMARY_BOUND_NAMES[dirIdx],
+                         numAdvancedStats[dirIdx]);
+    }
+    if (prototypeSim->getIsQueueStatsPrinted()) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            printSummaryLine("Time-weighted mean " +
+                             SUMMARY_BOUND_NAMES[dirIdx] + " queue",
+                             meanQueueLengthStats[dirIdx]);
+        }
+    }
+    if (prototypeSim->getIsDelayTrackingEnabled()) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            cout << "  Delay of " << SUMMARY_BOUND_NAMES[dirIdx] <<
+                    " cars - ";
+            delayHistograms[dirIdx].printSummary();
+        }
+    }
+    if (targetPrecision > 0) {
+        printConfidenceIntervals();
+    }
+    if (comparisonSim != 0 || isAntitheticPairs) {
+        printVarianceReduction();
+    }
+    cout << "===== End Replication Statistics =====" << endl;
+}
+
+void ReplicationRunnerClass::printConfidenceIntervals() const {
+    cout << "  95% confidence intervals:" << endl;
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        printIntervalLine("Longest " + SUMMARY_BOUND_NAMES[dirIdx] + " queue",
+                          maxQueueLengthStats[dirIdx]);
+    }
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        printIntervalLine("Total cars advanced " +
+                          SUMMARY_BOUND_NAMES[dirIdx],
+                          numAdvancedStats[dirIdx]);
+    }
+    if (prototypeSim->getIsDelayTrackingEnabled()) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            printIntervalLine("Mean delay of " + SUMMARY_BOUND_NAMES[dirIdx] +
+                              " cars", meanDelayStats[dirIdx]);
+        }
+    }
+
+    double maxRelativeHalfWidth = getMaxRelativeHalfWidth();
+    cout << "  Target precision of " << targetPrecision * 100 << "% ";
+    if (numReplicationsRun >= REPLICATION_MIN_SEQUENTIAL * getNumPerSample() &&
+        maxRelativeHalfWidth <= targetPrecision) {
+        cout << "reached after " << numReplicationsRun << " replications";
+    }
+    else {
+        cout << "not reached within " << numReplications << " replications";
+    }
+    cout << " (achieved: " << maxRelativeHalfWidth * 100 << "%)" << endl;
+}
+
+void ReplicationRunnerClass::printVarianceReduction() const {
+    int numPerSample = getNumPerSample();
+    int numSamples = numReplicationsRun / numPerSample;
+    int numStats = prototypeSim->getIsDelayTrackingEnabled() ?
+                   REPLICATION_NUM_STATS : REPLICATION_STAT_MEAN_DELAY;
+    bool isReductionFound = false;
+    double minReduction = 0;
+
+    if (comparisonSim != 0) {
+        cout << "  Compared setup minus this one, 95% confidence intervals:" <<
+                endl;
+    }
+    else {
+        cout << "  Antithetic pairs, 95% confidence intervals:" << endl;
+    }
+    for (int statIdx = 0; statIdx < numStats; statIdx++) {
+        for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+            StatAccumulatorClass sampleStats;
+            StatAccumulatorClass ownStats;
+            StatAccumulatorClass comparedStats;
+
+            for (int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++) {
+                double value = getSampleValue(results, sampleIdx, statIdx,
+                                              dirIdx);
+                if (comparisonSim != 0) {
+                    value = getSampleValue(comparisonResults, sampleIdx,
+                                           statIdx, dirIdx) - value;
+                }
+                sampleStats.addValue(value);
+            }
+            //The variance the same number of independent replications
+            //would have given
+            for (int replicationIdx = 0;
+                 replicationIdx < numSamples * numPerSample;
+                 replicationIdx++) {
+                ownStats.addValue(getResultValue(results[replicationIdx],
+                                                 statIdx, dirIdx));
+                if (comparisonSim != 0) {
+                    comparedStats.addValue(getResultValue(
+                              comparisonResults[replicationIdx], statIdx,
+                              dirIdx));
+                }
+            }
+            double independentVariance = (ownStats.getVariance() +
+                                          comparedStats.getVariance()) /
+                                         numPerSample;
+
+            cout << "    " << STAT_NAME_STARTS[statIdx] <<
+                    SUMMARY_BOUND_NAMES[dirIdx] << STAT_NAME_ENDS[statIdx] <<
+                    ": " << sampleStats.getMean() << " +/- " <<
+                    sampleStats.getConfidenceHalfWidth();
+            if (independentVariance > 0) {
+                double reduction = 1 - sampleStats.getVariance() /
+                                       independentVariance;
+                cout << " (variance reduction: " <<
+                        getRoundedPercent(reduction) << "%)";
+                if (!isReductionFound || reduction < minReduction) {
+                    minReduction = reduction;
+                }
+                isReductionFound = true;
+            }
+            cout << endl;
+        }
+    }
+    if (isReductionFound) {
+        cout << "  Smallest variance reduction: " <<
+                getRoundedPercent(minReduction) << "%" << endl;
+    }
+}
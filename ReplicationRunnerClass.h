@@ -0,0 +1,238 @@
+#ifndef _REPLICATIONRUNNERCLASS_H_
+#define _REPLICATIONRUNNERCLASS_H_
+
+#include <pthread.h>
+#include "IntersectionSimulationClass.h"
+#include "StatAccumulatorClass.h"
+#include "LogHistogramClass.h"
+#include "ThreadPoolClass.h"
+#include "constants.h"
+
+//Fewest replications runSequential runs before it checks their confidence
+//intervals, as a few replications can agree closely by chance
+const int REPLICATION_MIN_SEQUENTIAL = 10;
+
+//Replications runSequential runs between checks, unless told otherwise
+const int REPLICATION_DEFAULT_BATCH_SIZE = 10;
+
+//Statistics kept of each replication, for the summaries and the variance
+//reduction report
+const int REPLICATION_STAT_MAX_QUEUE_LENGTH = 0;
+const int REPLICATION_STAT_NUM_ADVANCED = 1;
+const int REPLICATION_STAT_MEAN_QUEUE_LENGTH = 2;
+const int REPLICATION_STAT_MEAN_DELAY = 3;
+const int REPLICATION_NUM_STATS = 4;
+
+//Purpose: Runs many replications of one simulation setup, each with its
+//         own random generator seed, spread over the threads of a pool,
+//         and summarizes the statistics they produce.  Replication i uses
+//         the setup's seed plus i.  Each replication's results are kept
+//         in its own slot and summarized in replication order once all
+//         are done, so the summary is the same whatever the number of
+//         threads.  When the setup tracks delays, each replication's
+//         delay histograms are merged into the runner's as it finishes;
+//         merging doesn't depend on the order, so neither do they.
+//         Instead of a fixed number, the replications can also be run in
+//         batches until the confidence intervals of their statistics are
+//         narrow enough (see runSequential); the batches don't depend on
+//         the number of threads either, so neither does where that stops.
+//
+//         Two variance reduction techniques are available.  Another setup
+//         can be compared with this one: each replication then also runs
+//         it with the same seed, so with the Philox generator both see
+//         the same arrivals and yellow-light draws on every approach
+//         (common random numbers), and the difference between them
+//         varies far less than that of independent runs.  And, with the
+//         Philox generator, replications can run in antithetic pairs:
+//         replications 2k and 2k + 1 both use the setup's seed plus k,
+//         the second with antithetic draws, and the summaries are of the
+//         pairs' averages.  Either way, the report compares the variance
+//         achieved with that of independent replications.
+class ReplicationRunnerClass {
+    private:
+        const IntersectionSimulationClass *prototypeSim; //The setup every
+                                    //replication starts as a copy of
+        int numReplications;        //Number of replications to run (at
+                                    //most, for runSequential)
+        int numReplicationsRun;     //Number of them run so far
+        int firstBatchReplicationIdx; //Index of the first replication in
+                                    //the batch being run
+        double targetPrecision;     //Relative half-width runSequential
+                                    //was given, or 0 after run
+        const IntersectionSimulationClass *comparisonSim; //The setup each
+                                    //replication is compared with, or 0
+        bool isAntitheticPairs;     //Whether replications run in
+                                    //antithetic pairs
+        SimulationResultStruct *results; //Results, by replication
+        SimulationResultStruct *comparisonResults; //The compared setup's
+                                    //results, by replication
+        StatAccumulatorClass maxQueueLengthStats[NUM_DIRECTIONS];
+        StatAccumulatorClass numAdvancedStats[NUM_DIRECTIONS];
+        StatAccumulatorClass meanQueueLengthStats[NUM_DIRECTIONS];
+        StatAccumulatorClass meanDelayStats[NUM_DIRECTIONS];
+        LogHistogramClass delayHistograms[NUM_DIRECTIONS]; //Delays of all
+                                    //the replications, by approach
+        pthread_mutex_t delayMutex; //Guards the delay histograms
+
+        //Thread pool task: runs one replication of the batch being run,
+        //or the compared setup's run of it, and stores its results.
+        static void runReplication(void *runner, const int taskIdx);
+
+        //Returns the number of replications whose results are averaged
+        //into each summarized value: 2 for antithetic pairs, else 1.
+        int getNumPerSample() const {
+            return isAntitheticPairs ? 2 : 1;
+        }
+
+        //Returns the given statistic (a REPLICATION_STAT_* value) of the
+        //given approach, averaged over the replications of one sample,
+        //from the given results (those of this setup, or of the compared
+        //one).
+        double getSampleValue(const SimulationResultStruct *sampleResults,
+                              const int sampleIdx, const int statIdx,
+                              const int dirIdx) const;
+
+        //Runs the given number of replications after those run so far,
+        //on the pool's threads, and summarizes the results of all of
+        //them.
+        void runBatch(ThreadPoolClass &threadPool, const int numInBatch);
+
+        //Prints the confidence intervals after runSequential, as part of
+        //printStatistics.
+        void printConfidenceIntervals() const;
+
+        //Prints the confidence intervals and variance reduction achieved
+        //by the comparison or antithetic pairs, as part of
+        //printStatistics.
+        void printVarianceReduction() const;
+
+        //A runner owns its results array, so it can't be copied.
+        ReplicationRunnerClass(const ReplicationRunnerClass &rhs);
+        ReplicationRunnerClass& operator=(const ReplicationRunnerClass &rhs);
+
+    public:
+        //Prepares to run the given number of replications of a simulation
+        //that has read its parameters (but not scheduled its seed events).
+        //The simulation must stay alive and unchanged while the runner is
+        //in use.
+        ReplicationRunnerClass(
+                        const IntersectionSimulationClass &inPrototypeSim,
+                        const int inNumReplications);
+
+        //Frees the results.
+        ~ReplicationRunnerClass();
+
+        //Makes each replication also run the given setup (which has read
+        //its parameters, but not scheduled its seed events) with the
+        //same seed as this one, and report how the two differ.  The
+        //setup must stay alive and unchanged while the runner is in use.
+        void setComparisonSim(
+                    const IntersectionSimulationClass &inComparisonSim);
+
+        //Selects whether replications run in antithetic pairs, in which
+        //case the number of them should be even.  Needs the Philox
+        //generator, so returns false, changing nothing, if the setup (or
+        //the compared one) uses any other.
+        bool setIsAntitheticPairs(const bool inIsAntitheticPairs);
+
+        //Runs all the replications on the pool's threads and summarizes
+        //their results.
+        void run(ThreadPoolClass &threadPool);
+
+        //Runs the replications batchSize at a time, stopping once the 95%
+        //confidence interval of every statistic the stop rule covers has
+        //a half-width of at most inTargetPrecision (e.g. 0.05 for 5%)
+        //relative to its mean, or once all of them have run.  The rule
+        //covers the longest queue, the cars advanced and (if the setup
+        //tracks delays) the mean delay of each approach, leaving out any
+        //with a mean of 0.  It is first checked after
+        //REPLICATION_MIN_SEQUENTIAL replications (or antithetic pairs),
+        //then after each batch; batches are rounded up to whole pairs.
+        void runSequential(ThreadPoolClass &threadPool,
+                           const double inTargetPrecision,
+                           const int batchSize);
+
+        //Returns the number of replications (the most runSequential may
+        //run).
+        int getNumReplications() const {
+            return numReplications;
+        }
+
+        //Returns the number of replications that have been run.
+        int getNumReplicationsRun() const {
+            return numReplicationsRun;
+        }
+
+        //Returns the largest half-width, relative to its mean, of the
+        //confidence intervals of the statistics runSequential's stop rule
+        //covers, over the replications run so far.
+        double getMaxRelativeHalfWidth() const;
+
+        //Returns the results of one replication, once run has been called.
+        const SimulationResultStruct& getResult(
+                                       const int replicationIdx) const {
+            return results[replicationIdx];
+        }
+
+        //Returns the results of the compared setup's run of one
+        //replication, once run has been called with a compared setup.
+        const SimulationResultStruct& getComparisonResult(
+                                       const int replicationIdx) const {
+            return comparisonResults[replicationIdx];
+        }
+
+        //Returns the summary, over all replications, of the longest queue
+        //on the given approach (a DIR_CODE_* value).
+        const StatAccumulatorClass& getMaxQueueLengthStats(
+                                    const unsigned char dirCode) const {
+            return maxQueueLengthStats[dirCode];
+        }
+
+        //Returns the summary, over all replications, of the number of cars
+        //that advanced from the given approach (a DIR_CODE_* value).
+        const StatAccumulatorClass& getNumAdvancedStats(
+                                    const unsigned char dirCode) const {
+            return numAdvancedStats[dirCode];
+        }
+
+        //Returns the summary, over all replications, of the time-weighted
+        //mean length of the queue on the given approach (a DIR_CODE_*
+        //value).
+        const StatAccumulatorClass& getMeanQueueLengthStats(
+                                    const unsigned char dirCode) const {
+            return meanQueueLengthStats[dirCode];
+        }
+
+        //Returns the summary, over all replications, of the mean delay of
+        //the cars that advanced from the given approach (a DIR_CODE_*
+        //value), if the setup tracks delays.
+        const StatAccumulatorClass& getMeanDelayStats(
+                                    const unsigned char dirCode) const {
+            return meanDelayStats[dirCode];
+        }
+
+        //Returns the delays of the cars that advanced from the given
+        //approach (a DIR_CODE_* value) in every replication, if the setup
+        //tracks delays.
+        const LogHistogramClass& getDelayHistogram(
+                                 const unsigned char dirCode) const {
+            return delayHistograms[dirCode];
+        }
+
+        //Prints the mean, standard deviation, minimum and maximum of each
+        //statistic over the replications (the time-weighted mean queue
+        //lengths only if the setup prints them), and the delay percentiles
+        //over all of them if the setup tracks delays.  After
+        //runSequential, the confidence intervals of the statistics its
+        //stop rule covers follow, and whether the target was reached.
+        //With a compared setup or antithetic pairs, the confidence
+        //intervals of the differences between the setups (or of this
+        //setup's statistics) end the summary, each with the variance
+        //reduction achieved: how much less its variance is than that of
+        //independent replications, which is also the share of the
+        //replications those would need for the same precision that are
+        //saved.
+        void printStatistics() const;
+};
+
+#endif // _REPLICATIONRUNNERCLASS_H_
@@ -0,0 +1,100 @@
+#include "SignalPlanClass.h"
+#include "constants.h"
+
+SignalPlanClass::SignalPlanClass() {
+    setLightTimes(1, 1, 1, 1);
+}
+
+void SignalPlanClass::setLightTimes(const int inEastWestGreenTime,
+                                    const int inEastWestYellowTime,
+                                    const int inNorthSouthGreenTime,
+                                    const int inNorthSouthYellowTime) {
+    eastWestGreenTime = inEastWestGreenTime;
+    eastWestYellowTime = inEastWestYellowTime;
+    northSouthGreenTime = inNorthSouthGreenTime;
+    northSouthYellowTime = inNorthSouthYellowTime;
+    cycleLength = eastWestGreenTime + eastWestYellowTime +
+                  northSouthGreenTime + northSouthYellowTime;
+}
+
+int SignalPlanClass::getCycleStart(const int time, int &offset) const {
+    offset = time % cycleLength;
+    return time - offset;
+}
+
+int SignalPlanClass::getLightAt(const int time) const {
+    int offset;
+
+    getCycleStart(time, offset);
+    if (offset < eastWestGreenTime) {
+        return LIGHT_GREEN_EW;
+    }
+    offset -= eastWestGreenTime;
+    if (offset < eastWestYellowTime) {
+        return LIGHT_YELLOW_EW;
+    }
+    offset -= eastWestYellowTime;
+    if (offset < northSouthGreenTime) {
+        return LIGHT_GREEN_NS;
+    }
+    return LIGHT_YELLOW_NS;
+}
+
+int SignalPlanClass::getNextChangeTime(const int time) const {
+    int offset;
+    int changeTime = getCycleStart(time, offset);
+
+    //Walk the phase boundaries of the cycle until one is past the time
+    //(the last boundary, the end of the cycle, always is)
+    changeTime += eastWestGreenTime;
+    if (changeTime > time) {
+        return changeTime;
+    }
+    changeTime += eastWestYellowTime;
+    if (changeTime > time) {
+        return changeTime;
+    }
+    changeTime += northSouthGreenTime;
+    if (changeTime > time) {
+        return changeTime;
+    }
+    return changeTime + northSouthYellowTime;
+}
+
+int SignalPlanClass::getPreviousChangeTime(const int time) const {
+    if (time <= eastWestGreenTime) {
+        return 0;
+    }
+
+    int offset;
+    int changeTime = getCycleStart(time - 1, offset);
+
+    //The last boundary of the cycle holding time - 1 that isn't past it
+    if (offset >= eastWestGreenTime) {
+        changeTime += eastWestGreenTime;
+        offset -= eastWestGreenTime;
+        if (offset >= eastWestYellowTime) {
+            changeTime += eastWestYellowTime;
+            offset -= eastWestYellowTime;
+            if (offset >= northSouthGreenTime) {
+                changeTime += northSouthGreenTime;
+            }
+        }
+    }
+    return changeTime;
+}
+
+int SignalPlanClass::getChangeTypeAt(const int changeTime) const {
+    int lightAfterChange = getLightAt(changeTime);
+
+    if (lightAfterChange == LIGHT_GREEN_EW) {
+        return EVENT_CHANGE_GREEN_EW;
+    }
+    else if (lightAfterChange == LIGHT_YELLOW_EW) {
+        return EVENT_CHANGE_YELLOW_EW;
+    }
+    else if (lightAfterChange == LIGHT_GREEN_NS) {
+        return EVENT_CHANGE_GREEN_NS;
+    }
+    return EVENT_CHANGE_YELLOW_NS;
+}
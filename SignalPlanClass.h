@@ -0,0 +1,54 @@
+#ifndef _SIGNALPLANCLASS_H_
+#define _SIGNALPLANCLASS_H_
+
+//Purpose: The intersection's fixed-time light plan: east-west green,
+//         east-west yellow, north-south green, north-south yellow, over
+//         and over, starting with east-west green at time 0.  Because the
+//         plan is strictly periodic, the light showing at any time and the
+//         light changes around it follow from the time modulo the cycle
+//         length, with no events needed to step through it.  A light
+//         change at time t takes effect at t, so the light "at" t is the
+//         one the change switches to.
+class SignalPlanClass {
+    private:
+        int eastWestGreenTime;    //Length of each phase, in time units
+        int eastWestYellowTime;
+        int northSouthGreenTime;
+        int northSouthYellowTime;
+        int cycleLength;          //Sum of the four phase lengths
+
+        //Returns the start of the cycle containing the given time, and
+        //sets offset to how far into that cycle the time is.
+        int getCycleStart(const int time, int &offset) const;
+
+    public:
+        //Default ctor - a plan with every phase one time unit long.
+        SignalPlanClass();
+
+        //Sets the phase lengths, which must all be positive.
+        void setLightTimes(const int inEastWestGreenTime,
+                           const int inEastWestYellowTime,
+                           const int inNorthSouthGreenTime,
+                           const int inNorthSouthYellowTime);
+
+        //Returns the length of one full cycle of the four phases.
+        int getCycleLength() const {
+            return cycleLength;
+        }
+
+        //Returns the light (a LIGHT_* value) showing at the given time.
+        int getLightAt(const int time) const;
+
+        //Returns the time of the first light change after the given time.
+        int getNextChangeTime(const int time) const;
+
+        //Returns the time of the last light change before the given time
+        //(0, the start of the plan, for times up to the first change).
+        int getPreviousChangeTime(const int time) const;
+
+        //Returns the type of the light change (an EVENT_CHANGE_* value)
+        //that happens at the given time, which must be a change time.
+        int getChangeTypeAt(const int changeTime) const;
+};
+
+#endif // _SIGNALPLANCLASS_H_
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+using namespace std;
+
+#include "SnapshotFileClass.h"
+
+SnapshotFileClass::SnapshotFileClass() {
+    snapshotFile = 0;
+    isFailed = false;
+}
+
+SnapshotFileClass::~SnapshotFileClass() {
+    if (snapshotFile != 0) {
+        fclose(snapshotFile);
+    }
+}
+
+bool SnapshotFileClass::openForWriting(const string &snapshotFname,
+                                       const unsigned int layoutSizes[4]) {
+    SnapshotFileHeaderStruct fileHeader;
+
+    close();
+    snapshotFile = fopen(snapshotFname.c_str(), "wb");
+    if (snapshotFile == 0) {
+        return false;
+    }
+
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    memcpy(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(fileHeader.magic));
+    fileHeader.version = SNAPSHOT_VERSION;
+    fileHeader.byteOrderMark = SNAPSHOT_BYTE_ORDER_MARK;
+    memcpy(fileHeader.layoutSizes, layoutSizes,
+           sizeof(fileHeader.layoutSizes));
+    writeValue(fileHeader);
+    return !isFailed;
+}
+
+bool SnapshotFileClass::openForReading(const string &snapshotFname,
+                                       const unsigned int layoutSizes[4]) {
+    SnapshotFileHeaderStruct fileHeader;
+
+    close();
+    snapshotFile = fopen(snapshotFname.c_str(), "rb");
+    if (snapshotFile == 0) {
+        cout << "ERROR: Unable to open snapshot file: " << snapshotFname <<
+                endl;
+        return false;
+    }
+
+    memset(&fileHeader, 0, sizeof(fileHeader));
+    readValue(fileHeader);
+    if (isFailed ||
+        memcmp(fileHeader.magic, SNAPSHOT_MAGIC, sizeof(fileHeader.magic))) {
+        cout << "ERROR: Not a simulation snapshot: " << snapshotFname << endl;
+    }
+    else if (fileHeader.version != SNAPSHOT_VERSION) {
+        cout << "ERROR: Snapshot " << snapshotFname << " is version " <<
+                fileHeader.version << ", but only version " <<
+                SNAPSHOT_VERSION << " can be read" << endl;
+    }
+    else if (fileHeader.byteOrderMark != SNAPSHOT_BYTE_ORDER_MARK ||
+             memcmp(fileHeader.layoutSizes, layoutSizes,
+                    sizeof(fileHeader.layoutSizes))) {
+        cout << "ERROR: Snapshot " << snapshotFname <<
+                " was written by an incompatible build" << endl;
+    }
+    else {
+        return true;
+    }
+
+    fclose(snapshotFile);
+    snapshotFile = 0;
+    isFailed = false;
+    return false;
+}
+
+bool SnapshotFileClass::close() {
+    bool success = !isFailed;
+
+    if (snapshotFile != 0) {
+        //A snapshot being read should have been used up exactly
+        if (success && !ferror(snapshotFile) && fgetc(snapshotFile) != EOF) {
+            success = false;
+        }
+        if (ferror(snapshotFile)) {
+            clearerr(snapshotFile);
+        }
+        if (fclose(snapshotFile) != 0) {
+            success = false;
+        }
+        snapshotFile = 0;
+    }
+    isFailed = false;
+    return success;
+}
+
+void SnapshotFileClass::writeBytes(const void *bytes, const size_t numBytes) {
+    if (snapshotFile == 0 || isFailed ||
+        fwrite(bytes, 1, numBytes, snapshotFile) != numBytes) {
+        isFailed = true;
+    }
+}
+
+void SnapshotFileClass::readBytes(void *bytes, const size_t numBytes) {
+    if (snapshotFile == 0 || isFailed ||
+        fread(bytes, 1, numBytes, snapshotFile) != numBytes) {
+        isFailed = true;
+    }
+}
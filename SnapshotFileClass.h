@@ -0,0 +1,95 @@
+#ifndef _SNAPSHOTFILECLASS_H_
+#define _SNAPSHOTFILECLASS_H_
+
+#include <cstdio>
+#include <string>
+
+//Identifies a simulation snapshot file, and the version of its layout
+const char SNAPSHOT_MAGIC[4] = { 'I', 'S', 'N', 'P' };
+const unsigned int SNAPSHOT_VERSION = 4;
+//Written in the machine's byte order, so a reader can tell whether the
+//file came from a machine with the same byte order as its own
+const unsigned int SNAPSHOT_BYTE_ORDER_MARK = 0x01020304;
+
+//The header at the start of every snapshot file.  Some parts of a
+//simulation (such as its random generators) are stored as they are laid
+//out in memory, so their sizes are recorded too, and a snapshot can only
+//be read by a build that lays them out the same way.
+struct SnapshotFileHeaderStruct {
+    char magic[4];              //SNAPSHOT_MAGIC
+    unsigned int version;       //SNAPSHOT_VERSION
+    unsigned int byteOrderMark; //SNAPSHOT_BYTE_ORDER_MARK
+    unsigned int layoutSizes[4]; //Sizes of the parts stored as laid out
+                                 //in memory, set by the simulation
+};
+
+//Purpose: A binary snapshot file being written or read.  Values are
+//         written one after the other in the machine's byte order, and
+//         read back in the same order.  Reading past the end of the file
+//         (or any other failed read or write) marks the file as failed;
+//         further reads then leave their values unchanged, so a whole
+//         snapshot can be read and checked for failure once at the end.
+class SnapshotFileClass {
+    private:
+        FILE *snapshotFile; //File being written or read, or 0 if none
+        bool isFailed;      //Whether a read or write has failed
+
+        //A snapshot file is open at most once, so it can't be copied.
+        SnapshotFileClass(const SnapshotFileClass &rhs);
+        SnapshotFileClass& operator=(const SnapshotFileClass &rhs);
+
+    public:
+        //Default ctor - no file open.
+        SnapshotFileClass();
+
+        //Closes the file, if one is open.
+        ~SnapshotFileClass();
+
+        //Creates (or truncates) the named file and writes a header with
+        //the given layout sizes to it.  Returns false if the file can't be
+        //created.
+        bool openForWriting(const std::string &snapshotFname,
+                            const unsigned int layoutSizes[4]);
+
+        //Opens the named file and checks its header: the magic, version
+        //and byte order must be this build's, and the layout sizes the
+        //given ones.  Prints an error and returns false if the file can't
+        //be opened or isn't a snapshot this build can read.
+        bool openForReading(const std::string &snapshotFname,
+                            const unsigned int layoutSizes[4]);
+
+        //Closes the file.  Returns false if anything written or read
+        //failed, or (after reading) if the file has data left over.
+        bool close();
+
+        //Writes a block of bytes.
+        void writeBytes(const void *bytes, const size_t numBytes);
+
+        //Reads a block of bytes.
+        void readBytes(void *bytes, const size_t numBytes);
+
+        //Writes one value of a type that can be copied byte by byte.
+        template <class T>
+        void writeValue(const T &val) {
+            writeBytes(&val, sizeof(T));
+        }
+
+        //Reads one value written by writeValue.
+        template <class T>
+        void readValue(T &val) {
+            readBytes(&val, sizeof(T));
+        }
+
+        //Marks the file as failed, e.g. when a value read from it is out
+        //of range.
+        void markFailed() {
+            isFailed = true;
+        }
+
+        //Returns whether a read or write has failed.
+        bool getIsFailed() const {
+            return isFailed;
+        }
+};
+
+#endif // _SNAPSHOTFILECLASS_H_
@@ -3,17 +3,39 @@
 
 using namespace std;
 #include "LinkedNodeClass.h"
+#include "HeapNodeAllocatorClass.h"
 
 // The sorted list class does not store any data directly. Instead,
 // it contains a collection of LinkedNodeClass objects, each of which
-// contains one element.
-template <class T>
+// contains one element. The storage for the nodes comes from an
+// allocator of type NodeAllocT< LinkedNodeClass<T> >, which defaults to
+// allocating each node from the heap; PoolNodeAllocatorClass can be used
+// instead to recycle nodes without touching the heap.
+template <class T, template <class> class NodeAllocT = HeapNodeAllocatorClass>
 class SortedListClass {
     private:
         LinkedNodeClass<T> *head; // Points to the first node in a list, or NULL
                                // if list is empty.
         LinkedNodeClass<T> *tail; // Points to the last node in a list, or NULL
                                // if list is empty.
+        NodeAllocT< LinkedNodeClass<T> > nodeAllocator; // Provides storage
+                               // for this list's nodes.
+        int numElems; // The number of nodes in the list, kept up to date
+                      // by createNode and destroyNode.
+
+        // Builds a new node in storage taken from this list's node
+        // allocator.
+        LinkedNodeClass<T>* createNode(
+            LinkedNodeClass<T> *inPrev,
+            const T &inVal,
+            LinkedNodeClass<T> *inNext);
+
+        // Destroys a node and gives its storage back to the node allocator.
+        void destroyNode(LinkedNodeClass<T> *node);
+
+        // Appends copies of another list's values after this list's tail,
+        // in their order.
+        void appendAll(const SortedListClass<T, NodeAllocT> &rhs);
     public:
         // Default Constructor. Will properly initialize a list to
         // be an empty list, to which values can be added.
@@ -21,7 +43,7 @@ class SortedListClass {
 
         // Copy constructor. Will make a complete (deep) copy of the list, such
         // that one can be changed without affecting the other.
-        SortedListClass(const SortedListClass<T> &rhs);
+        SortedListClass(const SortedListClass<T, NodeAllocT> &rhs);
 
         // Destructor. Responsible for making sure any dynamic memory
         // associated with an object is freed up when the object is
@@ -31,7 +53,8 @@ class SortedListClass {
         // Assignment operator. Will assign one list (on left hand side of
         // operator) to be a duplicate of the other (on the right hand side
         // of operator).
-        SortedListClass<T>& operator=(const SortedListClass<T> &rhs);
+        SortedListClass<T, NodeAllocT>& operator=(
+            const SortedListClass<T, NodeAllocT> &rhs);
 
         // Clears the list to an empty state without resulting in any
         // memory leaks.
@@ -77,6 +100,11 @@ class SortedListClass {
         // be set to the item that was removed.
         bool removeLast(T &theVal);
 
+        // Provides a copy of the front item without removing it. If the
+        // list is empty, the function returns false and outVal remains
+        // unchanged. Otherwise true is returned.
+        bool peekFront(T &outVal) const;
+
         // Returns the number of nodes contained in the list.
         int getNumElems() const;
 
@@ -86,6 +114,10 @@ class SortedListClass {
         // returns true, and the reference parameter outVal will contain
         // a copy of the value at that location.
         bool getElemAtIndex(const int index, T &outVal) const;
+
+        // Provides read access to the allocator this list takes its nodes
+        // from, e.g. to look at its allocation counters.
+        const NodeAllocT< LinkedNodeClass<T> >& getNodeAllocator() const;
 };
 
 #include "SortedListClass.inl"
@@ -1,50 +1,83 @@
+// Builds a new node in storage taken from this list's node allocator.
+template <class T, template <class> class NodeAllocT>
+LinkedNodeClass<T>* SortedListClass<T, NodeAllocT>::createNode(
+    LinkedNodeClass<T> *inPrev,
+    const T &inVal,
+    LinkedNodeClass<T> *inNext) {
+    LinkedNodeClass<T> *newNode = new (nodeAllocator.allocate())
+                                  LinkedNodeClass<T>(inPrev, inVal, inNext);
+    numElems++;
+    return newNode;
+}
+
+// Destroys a node and gives its storage back to the node allocator.
+template <class T, template <class> class NodeAllocT>
+void SortedListClass<T, NodeAllocT>::destroyNode(LinkedNodeClass<T> *node) {
+    node->~LinkedNodeClass<T>();
+    nodeAllocator.deallocate(node);
+    numElems--;
+}
+
+// Appends copies of rhs's values after the tail. Used to copy a list,
+// whose values are already in order, in O(n) rather than searching for
+// each value's place.
+template <class T, template <class> class NodeAllocT>
+void SortedListClass<T, NodeAllocT>::appendAll(
+    const SortedListClass<T, NodeAllocT> &rhs) {
+    LinkedNodeClass<T> *currNode = rhs.head;
+    while (currNode != 0) {
+        LinkedNodeClass<T> *nodeToInsert = createNode(tail,
+                                                      currNode->getValue(),
+                                                      0);
+        nodeToInsert->setBeforeAndAfterPointers();
+        if (tail == 0) {
+            head = nodeToInsert;
+        }
+        tail = nodeToInsert;
+        currNode = currNode->getNext();
+    }
+}
+
 // Default Constructor. Will properly initialize a list to
 // be an empty list, to which values can be added.
-template <class T>
-SortedListClass<T>::SortedListClass() {
+template <class T, template <class> class NodeAllocT>
+SortedListClass<T, NodeAllocT>::SortedListClass() {
     head = 0;
     tail = 0;
+    numElems = 0;
 }
 
 // Copy constructor. Will make a complete (deep) copy of the list, such
 // that one can be changed without affecting the other.
-template <class T>
-SortedListClass<T>::SortedListClass(const SortedListClass<T> &rhs) {
+template <class T, template <class> class NodeAllocT>
+SortedListClass<T, NodeAllocT>::SortedListClass(
+    const SortedListClass<T, NodeAllocT> &rhs) {
     head = 0;
     tail = 0;
+    numElems = 0;
 
-    // get the head of rhs
-    LinkedNodeClass<T> *currNode = rhs.head;
-    // copy until tail
-    while (currNode != 0) {
-        insertValue(currNode->getValue());
-        currNode = currNode->getNext();
-    }
+    appendAll(rhs);
 }
 
 // Destructor. Responsible for making sure any dynamic memory
 // associated with an object is freed up when the object is
 // being destroyed.
-template <class T>
-SortedListClass<T>::~SortedListClass() {
+template <class T, template <class> class NodeAllocT>
+SortedListClass<T, NodeAllocT>::~SortedListClass() {
     clear();
 }
 
 // Assignment operator. Will assign one list (on left hand side of
 // operator) to be a duplicate of the other (on the right hand side
 // of operator).
-template <class T>
-SortedListClass<T>& SortedListClass<T>::operator=(
-    const SortedListClass<T> &rhs) {
-    clear();
-
-    // get the head of rhs
-    LinkedNodeClass<T> *currNode = rhs.head;
-    // copy until tail
-    while (currNode != 0) {
-        insertValue(currNode->getValue());
-        currNode = currNode->getNext();
+template <class T, template <class> class NodeAllocT>
+SortedListClass<T, NodeAllocT>& SortedListClass<T, NodeAllocT>::operator=(
+    const SortedListClass<T, NodeAllocT> &rhs) {
+    if (this == &rhs) {
+        return *this;
     }
+    clear();
+    appendAll(rhs);
 
     // dereference
     return *this;
@@ -52,13 +85,13 @@ SortedListClass<T>& SortedListClass<T>::operator=(
 
 // Clears the list to an empty state without resulting in any
 // memory leaks.
-template <class T>
-void SortedListClass<T>::clear() {
+template <class T, template <class> class NodeAllocT>
+void SortedListClass<T, NodeAllocT>::clear() {
     // delete node if head is not null
     while (head != 0) {
         LinkedNodeClass<T> *currNode = head;
         head = head->getNext();
-        delete currNode;
+        destroyNode(currNode);
     }
 
     // set tail back to default
@@ -72,14 +105,14 @@ void SortedListClass<T>::clear() {
 // being inserted is found to be "equal to" one or more node values
 // already in the list, the newly inserted node will be placed AFTER
 // the previously inserted nodes.
-template <class T>
-void SortedListClass<T>::insertValue(
+template <class T, template <class> class NodeAllocT>
+void SortedListClass<T, NodeAllocT>::insertValue(
     const T &valToInsert) { //The value to insert into the list
     // add a node if empty
     if (head == 0) {
-        LinkedNodeClass<T> *nodeToInsert = new LinkedNodeClass<T>(0, 
-                                                                  valToInsert,
-                                                                  0);
+        LinkedNodeClass<T> *nodeToInsert = createNode(0, 
+                                                      valToInsert,
+                                                      0);
         head = nodeToInsert;
         tail = nodeToInsert;
         return;
@@ -92,7 +125,7 @@ void SortedListClass<T>::insertValue(
             currNode = currNode->getNext();
         }
         else {
-            LinkedNodeClass<T> *nodeToInsert = new LinkedNodeClass<T>(
+            LinkedNodeClass<T> *nodeToInsert = createNode(
                                                     currNode->getPrev(), 
                                                     valToInsert, 
                                                     currNode);
@@ -106,9 +139,9 @@ void SortedListClass<T>::insertValue(
     }
 
     // situation that the val is greatest
-    LinkedNodeClass<T> *nodeToInsert = new LinkedNodeClass<T>(tail,
-                                                              valToInsert,
-                                                              0);
+    LinkedNodeClass<T> *nodeToInsert = createNode(tail,
+                                                  valToInsert,
+                                                  0);
     nodeToInsert->setBeforeAndAfterPointers();
     tail = nodeToInsert;
 }
@@ -117,8 +150,8 @@ void SortedListClass<T>::insertValue(
 // Begins with a line reading "Forward List Contents Follow:", then
 // prints one list element per line, indented two spaces, then prints
 // the line "End Of List Contents" to indicate the end of the list.
-template <class T>
-void SortedListClass<T>::printForward() const {
+template <class T, template <class> class NodeAllocT>
+void SortedListClass<T, NodeAllocT>::printForward() const {
     cout << "Forward List Contents Follow:" << endl;
 
     // loop from the from
@@ -135,8 +168,8 @@ void SortedListClass<T>::printForward() const {
 // Begins with a line reading "Backward List Contents Follow:", then
 // prints one list element per line, indented two spaces, then prints
 // the line "End Of List Contents" to indicate the end of the list.
-template <class T>
-void SortedListClass<T>::printBackward() const {
+template <class T, template <class> class NodeAllocT>
+void SortedListClass<T, NodeAllocT>::printBackward() const {
     cout << "Backward List Contents Follow:" << endl;
     
     // loop from the back
@@ -156,8 +189,8 @@ void SortedListClass<T>::printBackward() const {
 // If the list was not empty and the first item was successfully
 // removed, true is returned, and the reference parameter will
 // be set to the item that was removed.
-template <class T>
-bool SortedListClass<T>::removeFront(T &theVal) {
+template <class T, template <class> class NodeAllocT>
+bool SortedListClass<T, NodeAllocT>::removeFront(T &theVal) {
     if (head == 0) {
         return false;
     }
@@ -174,7 +207,7 @@ bool SortedListClass<T>::removeFront(T &theVal) {
             head->setPreviousPointerToNull();
         }
 
-        delete currNode;
+        destroyNode(currNode);
         return true;
     }
 }
@@ -186,8 +219,8 @@ bool SortedListClass<T>::removeFront(T &theVal) {
 // If the list was not empty and the last item was successfully
 // removed, true is returned, and the reference parameter will
 // be set to the item that was removed.
-template <class T>
-bool SortedListClass<T>::removeLast(T &theVal) {
+template <class T, template <class> class NodeAllocT>
+bool SortedListClass<T, NodeAllocT>::removeLast(T &theVal) {
     if (head == 0) {
         return false;
     }
@@ -204,21 +237,27 @@ bool SortedListClass<T>::removeLast(T &theVal) {
             tail->setNextPointerToNull();
         }
 
-        delete currNode;
+        destroyNode(currNode);
         return true;
     }
 }
 
-// Returns the number of nodes contained in the list.
-template <class T>
-int SortedListClass<T>::getNumElems() const {
-    int num = 0;
-    LinkedNodeClass<T> *currNode = head;
-    while (currNode != 0) {
-        num++;
-        currNode = currNode->getNext();
+// Provides a copy of the front item without removing it. If the
+// list is empty, the function returns false and outVal remains
+// unchanged. Otherwise true is returned.
+template <class T, template <class> class NodeAllocT>
+bool SortedListClass<T, NodeAllocT>::peekFront(T &outVal) const {
+    if (head == 0) {
+        return false;
     }
-    return num;
+    outVal = head->getValue();
+    return true;
+}
+
+// Returns the number of nodes contained in the list.
+template <class T, template <class> class NodeAllocT>
+int SortedListClass<T, NodeAllocT>::getNumElems() const {
+    return numElems;
 }
 
 // Provides the value stored in the node at index provided in the
@@ -226,8 +265,9 @@ int SortedListClass<T>::getNumElems() const {
 // remains unchanged and false is returned. Otherwise, the function
 // returns true, and the reference parameter outVal will contain
 // a copy of the value at that location.
-template <class T>
-bool SortedListClass<T>::getElemAtIndex(const int index, T &outVal) const {
+template <class T, template <class> class NodeAllocT>
+bool SortedListClass<T, NodeAllocT>::getElemAtIndex(const int index,
+                                                    T &outVal) const {
     if (head == 0 || index < 0) {
         return false;
     }
@@ -246,4 +286,11 @@ bool SortedListClass<T>::getElemAtIndex(const int index, T &outVal) const {
 
     // currNode touch tail before touching inout index
     return false;
-}
\ No newline at end of file
+}
+// Provides read access to the allocator this list takes its nodes
+// from, e.g. to look at its allocation counters.
+template <class T, template <class> class NodeAllocT>
+const NodeAllocT< LinkedNodeClass<T> >&
+SortedListClass<T, NodeAllocT>::getNodeAllocator() const {
+    return nodeAllocator;
+}
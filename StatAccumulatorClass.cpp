@@ -0,0 +1,82 @@
+#include <cmath>
+using namespace std;
+
+#include "StatAccumulatorClass.h"
+
+//Student's t values for a two-sided 95% interval, for 1 to 30 degrees of
+//freedom
+const int STUDENT_T_TABLE_SIZE = 30;
+const double STUDENT_T_975_TABLE[STUDENT_T_TABLE_SIZE] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+//The standard normal value that 97.5% of the distribution is below
+const double NORMAL_Z_975 = 1.959964;
+
+StatAccumulatorClass::StatAccumulatorClass() {
+    clear();
+}
+
+void StatAccumulatorClass::clear() {
+    numValues = 0;
+    meanVal = 0;
+    sumSqDiffs = 0;
+    minVal = 0;
+    maxVal = 0;
+}
+
+void StatAccumulatorClass::addValue(const double newVal) {
+    numValues++;
+    if (numValues == 1) {
+        minVal = newVal;
+        maxVal = newVal;
+    }
+    else if (newVal < minVal) {
+        minVal = newVal;
+    }
+    else if (newVal > maxVal) {
+        maxVal = newVal;
+    }
+
+    double diffFromOldMean = newVal - meanVal;
+    meanVal += diffFromOldMean / numValues;
+    sumSqDiffs += diffFromOldMean * (newVal - meanVal);
+}
+
+double StatAccumulatorClass::getVariance() const {
+    if (numValues < 2) {
+        return 0;
+    }
+    return sumSqDiffs / (numValues - 1);
+}
+
+double StatAccumulatorClass::getStdDev() const {
+    return sqrt(getVariance());
+}
+
+double StatAccumulatorClass::getConfidenceHalfWidth() const {
+    if (numValues < 2) {
+        return 0;
+    }
+    return getStudentT975(numValues - 1) * getStdDev() / sqrt(numValues);
+}
+
+double StatAccumulatorClass::getStudentT975(const long degreesOfFreedom) {
+    if (degreesOfFreedom < 1) {
+        return STUDENT_T_975_TABLE[0];
+    }
+    if (degreesOfFreedom <= STUDENT_T_TABLE_SIZE) {
+        return STUDENT_T_975_TABLE[degreesOfFreedom - 1];
+    }
+
+    //Beyond the table, the first terms of the Cornish-Fisher expansion
+    //around the normal value are good to the table's precision
+    double zVal = NORMAL_Z_975;
+    double zCubed = zVal * zVal * zVal;
+    double zFifth = zCubed * zVal * zVal;
+    double dfVal = (double)degreesOfFreedom;
+    return zVal + (zCubed + zVal) / (4 * dfVal) +
+           (5 * zFifth + 16 * zCubed + 3 * zVal) / (96 * dfVal * dfVal);
+}
@@ -0,0 +1,67 @@
+#ifndef _STATACCUMULATORCLASS_H_
+#define _STATACCUMULATORCLASS_H_
+
+//Purpose: Accumulates summary statistics (count, mean, standard
+//         deviation, minimum and maximum) of a series of values in a
+//         single pass and constant space, using Welford's update so the
+//         variance stays accurate even when the values are large and
+//         close together.
+class StatAccumulatorClass {
+    private:
+        long numValues;     //Number of values added so far
+        double meanVal;     //Mean of the values added so far
+        double sumSqDiffs;  //Sum of squared differences from the mean
+        double minVal;      //Smallest value added so far
+        double maxVal;      //Largest value added so far
+
+    public:
+        //Default ctor - starts out with no values.
+        StatAccumulatorClass();
+
+        //Forgets all values added so far.
+        void clear();
+
+        //Adds one value to the series.
+        void addValue(const double newVal);
+
+        //Returns the number of values added.
+        long getCount() const {
+            return numValues;
+        }
+
+        //Returns the mean of the values, or 0 if there are none.
+        double getMean() const {
+            return meanVal;
+        }
+
+        //Returns the sample variance (dividing by n - 1) of the values, or
+        //0 if there are fewer than two.
+        double getVariance() const;
+
+        //Returns the sample standard deviation of the values, or 0 if there
+        //are fewer than two.
+        double getStdDev() const;
+
+        //Returns the half-width of the 95% confidence interval for the
+        //mean of the values (from Student's t distribution, treating them
+        //as independent and roughly normal), or 0 if there are fewer than
+        //two.
+        double getConfidenceHalfWidth() const;
+
+        //Returns the value of Student's t distribution with the given
+        //degrees of freedom (1 or more) that 97.5% of it is below, i.e.
+        //the factor for a two-sided 95% confidence interval.
+        static double getStudentT975(const long degreesOfFreedom);
+
+        //Returns the smallest value added, or 0 if there are none.
+        double getMin() const {
+            return minVal;
+        }
+
+        //Returns the largest value added, or 0 if there are none.
+        double getMax() const {
+            return maxVal;
+        }
+};
+
+#endif // _STATACCUMULATORCLASS_H_
@@ -0,0 +1,187 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include "ThreadPoolClass.h"
+
+ThreadPoolClass::ThreadPoolClass(const int inNumThreads) {
+    numThreads = (inNumThreads < 1) ? 1 : inNumThreads;
+    taskFunction = 0;
+    taskContext = 0;
+    batchNum = 0;
+    numHelpersBusy = 0;
+    isShuttingDown = false;
+    numSteals = 0;
+
+    pthread_mutex_init(&poolMutex, 0);
+    pthread_cond_init(&batchReadyCond, 0);
+    pthread_cond_init(&batchDoneCond, 0);
+
+    taskRanges = new TaskRangeStruct[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        pthread_mutex_init(&taskRanges[i].rangeMutex, 0);
+        taskRanges[i].nextTaskIdx = 0;
+        taskRanges[i].endTaskIdx = 0;
+    }
+
+    workerThreads = new pthread_t[numThreads];
+    helperStarts = new HelperStartStruct[numThreads];
+    for (int i = 0; i < numThreads - 1; i++) {
+        helperStarts[i].pool = this;
+        helperStarts[i].workerIdx = i;
+        pthread_create(&workerThreads[i], 0, helperMain, &helperStarts[i]);
+    }
+}
+
+ThreadPoolClass::~ThreadPoolClass() {
+    pthread_mutex_lock(&poolMutex);
+    isShuttingDown = true;
+    pthread_cond_broadcast(&batchReadyCond);
+    pthread_mutex_unlock(&poolMutex);
+
+    for (int i = 0; i < numThreads - 1; i++) {
+        pthread_join(workerThreads[i], 0);
+    }
+    delete [] workerThreads;
+    delete [] helperStarts;
+
+    for (int i = 0; i < numThreads; i++) {
+        pthread_mutex_destroy(&taskRanges[i].rangeMutex);
+    }
+    delete [] taskRanges;
+
+    pthread_cond_destroy(&batchDoneCond);
+    pthread_cond_destroy(&batchReadyCond);
+    pthread_mutex_destroy(&poolMutex);
+}
+
+void* ThreadPoolClass::helperMain(void *helperStart) {
+    ThreadPoolClass *thisPool = ((HelperStartStruct *)helperStart)->pool;
+    int workerIdx = ((HelperStartStruct *)helperStart)->workerIdx;
+    int lastBatchNum = 0;
+
+    pthread_mutex_lock(&thisPool->poolMutex);
+    while (true) {
+        while (thisPool->batchNum == lastBatchNum &&
+               !thisPool->isShuttingDown) {
+            pthread_cond_wait(&thisPool->batchReadyCond, &thisPool->poolMutex);
+        }
+        if (thisPool->isShuttingDown) {
+            break;
+        }
+        lastBatchNum = thisPool->batchNum;
+        pthread_mutex_unlock(&thisPool->poolMutex);
+
+        thisPool->runAvailableTasks(workerIdx);
+
+        pthread_mutex_lock(&thisPool->poolMutex);
+        thisPool->numHelpersBusy--;
+        if (thisPool->numHelpersBusy == 0) {
+            pthread_cond_signal(&thisPool->batchDoneCond);
+        }
+    }
+    pthread_mutex_unlock(&thisPool->poolMutex);
+    return 0;
+}
+
+bool ThreadPoolClass::takeOwnTask(const int workerIdx, int &taskIdx) {
+    TaskRangeStruct &ownRange = taskRanges[workerIdx];
+    bool isTaken = false;
+
+    pthread_mutex_lock(&ownRange.rangeMutex);
+    if (ownRange.nextTaskIdx < ownRange.endTaskIdx) {
+        taskIdx = ownRange.nextTaskIdx;
+        ownRange.nextTaskIdx++;
+        isTaken = true;
+    }
+    pthread_mutex_unlock(&ownRange.rangeMutex);
+    return isTaken;
+}
+
+bool ThreadPoolClass::stealTasks(const int workerIdx) {
+    while (true) {
+        //Pick the victim without locking; the sizes only need to be
+        //roughly right, and are checked again under the victim's lock
+        int victimIdx = -1;
+        int mostRemaining = 0;
+        for (int offset = 1; offset < numThreads; offset++) {
+            int candidateIdx = (workerIdx + offset) % numThreads;
+            const TaskRangeStruct &candidate = taskRanges[candidateIdx];
+            int numRemaining = *(volatile const int *)&candidate.endTaskIdx -
+                               *(volatile const int *)&candidate.nextTaskIdx;
+            if (numRemaining > mostRemaining) {
+                mostRemaining = numRemaining;
+                victimIdx = candidateIdx;
+            }
+        }
+        if (victimIdx < 0) {
+            return false;
+        }
+
+        int stolenStartIdx = 0;
+        int stolenEndIdx = 0;
+        TaskRangeStruct &victimRange = taskRanges[victimIdx];
+        pthread_mutex_lock(&victimRange.rangeMutex);
+        int numRemaining = victimRange.endTaskIdx - victimRange.nextTaskIdx;
+        if (numRemaining > 0) {
+            stolenEndIdx = victimRange.endTaskIdx;
+            stolenStartIdx = stolenEndIdx - (numRemaining + 1) / 2;
+            victimRange.endTaskIdx = stolenStartIdx;
+        }
+        pthread_mutex_unlock(&victimRange.rangeMutex);
+
+        if (stolenEndIdx > stolenStartIdx) {
+            TaskRangeStruct &ownRange = taskRanges[workerIdx];
+            pthread_mutex_lock(&ownRange.rangeMutex);
+            ownRange.nextTaskIdx = stolenStartIdx;
+            ownRange.endTaskIdx = stolenEndIdx;
+            pthread_mutex_unlock(&ownRange.rangeMutex);
+            __sync_fetch_and_add(&numSteals, 1);
+            return true;
+        }
+    }
+}
+
+void ThreadPoolClass::runAvailableTasks(const int workerIdx) {
+    int taskIdx;
+
+    while (true) {
+        while (takeOwnTask(workerIdx, taskIdx)) {
+            taskFunction(taskContext, taskIdx);
+        }
+        if (!stealTasks(workerIdx)) {
+            break;
+        }
+    }
+}
+
+void ThreadPoolClass::runTasks(ThreadTaskFunction inTaskFunction,
+                               void *inTaskContext, const int inNumTasks) {
+    pthread_mutex_lock(&poolMutex);
+    taskFunction = inTaskFunction;
+    taskContext = inTaskContext;
+    numSteals = 0;
+    for (int i = 0; i < numThreads; i++) {
+        pthread_mutex_lock(&taskRanges[i].rangeMutex);
+        taskRanges[i].nextTaskIdx = (int)((long)inNumTasks * i / numThreads);
+        taskRanges[i].endTaskIdx =
+                      (int)((long)inNumTasks * (i + 1) / numThreads);
+        pthread_mutex_unlock(&taskRanges[i].rangeMutex);
+    }
+    numHelpersBusy = numThreads - 1;
+    batchNum++;
+    pthread_cond_broadcast(&batchReadyCond);
+    pthread_mutex_unlock(&poolMutex);
+
+    runAvailableTasks(numThreads - 1);
+
+    pthread_mutex_lock(&poolMutex);
+    while (numHelpersBusy > 0) {
+        pthread_cond_wait(&batchDoneCond, &poolMutex);
+    }
+    pthread_mutex_unlock(&poolMutex);
+}
+
+int ThreadPoolClass::getNumProcessors() {
+    long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+    return (numProcessors < 1) ? 1 : (int)numProcessors;
+}
@@ -0,0 +1,114 @@
+#ifndef _THREADPOOLCLASS_H_
+#define _THREADPOOLCLASS_H_
+
+#include <pthread.h>
+
+//The kind of function a thread pool runs: it is given the context
+//pointer passed to runTasks and the index of the task to perform.
+typedef void (*ThreadTaskFunction)(void *taskContext, const int taskIdx);
+
+//Size of a cache line, used to keep each thread's task range on its own
+const int THREAD_POOL_CACHE_LINE_SIZE = 64;
+
+//Purpose: The tasks of a batch not yet started by one thread of a pool:
+//         task indices nextTaskIdx up to (not including) endTaskIdx.
+//         The owning thread takes tasks from the front; other threads
+//         steal from the back.
+struct TaskRangeStruct {
+    pthread_mutex_t rangeMutex; //Guards the two indices
+    int nextTaskIdx;            //Next task the owner will run
+    int endTaskIdx;             //One past the last task in the range
+    char padding[THREAD_POOL_CACHE_LINE_SIZE]; //Keeps neighbouring ranges
+                                //off this one's cache line
+};
+
+//Purpose: A fixed set of threads that work through batches of
+//         independent, numbered tasks.  The threads are started once and
+//         reused for every batch.  Each batch is split into one
+//         contiguous range of tasks per thread, and each thread works
+//         through its own range in order.  A thread that runs out steals
+//         the back half of the range with the most tasks left, so when
+//         tasks take very different amounts of time the threads that
+//         drew quick ones take over the work of those that didn't.  The
+//         thread calling runTasks works on the batch too, so a pool of
+//         one thread runs everything on the caller's thread.
+class ThreadPoolClass {
+    private:
+        //What each helper thread is started with.
+        struct HelperStartStruct {
+            ThreadPoolClass *pool;  //The pool the helper belongs to
+            int workerIdx;          //Index of the helper's task range
+        };
+
+        int numThreads;             //Threads working on each batch,
+                                    //counting the caller of runTasks
+        pthread_t *workerThreads;   //The numThreads - 1 helper threads
+        HelperStartStruct *helperStarts; //Start info, by helper
+        TaskRangeStruct *taskRanges; //Remaining tasks, by thread (the
+                                     //caller of runTasks uses the last)
+        pthread_mutex_t poolMutex;  //Guards the batch description below
+        pthread_cond_t batchReadyCond; //Signaled when a batch starts or
+                                       //the pool is shutting down
+        pthread_cond_t batchDoneCond;  //Signaled when the last helper
+                                       //finishes its part of a batch
+
+        ThreadTaskFunction taskFunction; //What the current batch runs
+        void *taskContext;          //Passed to every task in the batch
+        int batchNum;               //Counts batches, so helpers can tell
+                                    //a new one has started
+        int numHelpersBusy;         //Helpers still working on the batch
+        bool isShuttingDown;        //Tells the helpers to exit
+        long numSteals;             //Successful steals during the last
+                                    //batch
+
+        //Runs on each helper thread: waits for batches and works on them.
+        static void* helperMain(void *helperStart);
+
+        //Takes the next task from the front of the given thread's range,
+        //returning false if the range is empty.
+        bool takeOwnTask(const int workerIdx, int &taskIdx);
+
+        //Moves the back half of the fullest other range into the given
+        //thread's (empty) range, returning false if every range is empty.
+        bool stealTasks(const int workerIdx);
+
+        //Runs tasks from the given thread's range, then stolen ones, until
+        //there are none left anywhere.
+        void runAvailableTasks(const int workerIdx);
+
+        //A pool owns its threads, so it can't be copied.
+        ThreadPoolClass(const ThreadPoolClass &rhs);
+        ThreadPoolClass& operator=(const ThreadPoolClass &rhs);
+
+    public:
+        //Starts a pool with the given number of threads (including the one
+        //that will call runTasks); values below 1 are treated as 1.
+        ThreadPoolClass(const int inNumThreads);
+
+        //Stops and joins the helper threads.
+        ~ThreadPoolClass();
+
+        //Returns the number of threads that work on each batch.
+        int getNumThreads() const {
+            return numThreads;
+        }
+
+        //Returns the number of times a thread stole tasks during the last
+        //batch.
+        long getNumSteals() const {
+            return numSteals;
+        }
+
+        //Runs taskFunction(taskContext, taskIdx) for every taskIdx from 0
+        //to inNumTasks - 1, spread over the pool's threads, and returns
+        //once all of them have finished. Tasks may run in any order and
+        //at the same time as each other.
+        void runTasks(ThreadTaskFunction inTaskFunction, void *inTaskContext,
+                      const int inNumTasks);
+
+        //Returns the number of processors available, for choosing a pool
+        //size.
+        static int getNumProcessors();
+};
+
+#endif // _THREADPOOLCLASS_H_
@@ -0,0 +1,94 @@
+#include <cmath>
+using namespace std;
+
+#include "TimeWeightedStatClass.h"
+
+TimeWeightedStatClass::TimeWeightedStatClass() {
+    reset(0, 0);
+}
+
+void TimeWeightedStatClass::reset(const int inStartTime, const int inValue) {
+    startTime = inStartTime;
+    lastChangeTime = inStartTime;
+    currentValue = inValue;
+    sumValueTime = 0;
+    sumSqValueTime = 0;
+    nonZeroTime = 0;
+}
+
+void TimeWeightedStatClass::addPendingTime(const int endTime,
+                                           long &outSumValueTime,
+                                           long double &outSumSqValueTime,
+                                           long &outNonZeroTime) const {
+    long duration = endTime - lastChangeTime;
+
+    outSumValueTime = sumValueTime + duration * currentValue;
+    outSumSqValueTime = sumSqValueTime +
+                        (long double)duration * currentValue * currentValue;
+    outNonZeroTime = nonZeroTime + ((currentValue > 0) ? duration : 0);
+}
+
+void TimeWeightedStatClass::repeatGrowthSince(
+                            const TimeWeightedStatClass &earlier,
+                            const long numRepeats, const int shiftTime) {
+    //The squared sum's growth is multiplied as a long double too, as the
+    //repeats can take it far past what a long holds
+    sumValueTime += numRepeats * (sumValueTime - earlier.sumValueTime);
+    sumSqValueTime += (long double)numRepeats *
+                      (sumSqValueTime - earlier.sumSqValueTime);
+    nonZeroTime += numRepeats * (nonZeroTime - earlier.nonZeroTime);
+    lastChangeTime += shiftTime;
+}
+
+double TimeWeightedStatClass::getMean(const int endTime) const {
+    long totalSumValueTime;
+    long double totalSumSqValueTime;
+    long totalNonZeroTime;
+    long totalTime = endTime - startTime;
+
+    if (totalTime <= 0) {
+        return 0;
+    }
+    addPendingTime(endTime, totalSumValueTime, totalSumSqValueTime,
+                   totalNonZeroTime);
+    return (double)totalSumValueTime / totalTime;
+}
+
+double TimeWeightedStatClass::getVariance(const int endTime) const {
+    long totalSumValueTime;
+    long double totalSumSqValueTime;
+    long totalNonZeroTime;
+    long totalTime = endTime - startTime;
+
+    if (totalTime <= 0) {
+        return 0;
+    }
+    addPendingTime(endTime, totalSumValueTime, totalSumSqValueTime,
+                   totalNonZeroTime);
+
+    //The sums are exact (or, for huge queues, rounded in the 19th
+    //digit), so mainly this last step rounds, which can take a variance
+    //of 0 slightly below it
+    long double meanVal = (long double)totalSumValueTime / totalTime;
+    long double varianceVal = totalSumSqValueTime / totalTime -
+                              meanVal * meanVal;
+    return (varianceVal > 0) ? (double)varianceVal : 0;
+}
+
+double TimeWeightedStatClass::getStdDev(const int endTime) const {
+    return sqrt(getVariance(endTime));
+}
+
+double TimeWeightedStatClass::getFractionNonZero(const int endTime) const {
+    long totalSumValueTime;
+    long double totalSumSqValueTime;
+    long totalNonZeroTime;
+    long totalTime = endTime - startTime;
+
+    if (totalTime <= 0) {
+        return 0;
+    }
+    addPendingTime(endTime, totalSumValueTime, totalSumSqValueTime,
+                   totalNonZeroTime);
+    return (double)totalNonZeroTime / totalTime;
+}
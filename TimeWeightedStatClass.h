@@ -0,0 +1,93 @@
+#ifndef _TIMEWEIGHTEDSTATCLASS_H_
+#define _TIMEWEIGHTEDSTATCLASS_H_
+
+//Purpose: Accumulates the time-weighted mean and variance of a whole
+//         number that changes at points in simulated time and holds its
+//         value in between (such as a queue length), and the share of
+//         time it is above 0.  Each change adds the interval since the
+//         one before to running sums, so an update is O(1) and no
+//         sampling is needed; the statistics are worked out from the sums
+//         when they are asked for.  The sums of value times duration are
+//         exact integers.  The sum of squared value times duration outgrows
+//         a long on long runs with a growing queue (at around 10^7 ticks
+//         for a queue that grows steadily), so it is a long double, whose
+//         64-bit mantissa keeps it exact as far as a long would have and
+//         only rounds it beyond that.
+class TimeWeightedStatClass {
+    private:
+        int startTime;       //Time the accumulation started
+        int lastChangeTime;  //Time the value last changed
+        int currentValue;    //Value since then
+        long sumValueTime;   //Sum of value times duration so far
+        long double sumSqValueTime; //Sum of squared value times duration
+                                    //so far
+        long nonZeroTime;    //Total time the value has been above 0
+
+        //Adds the value's time from its last change up to endTime to the
+        //given sums.
+        void addPendingTime(const int endTime, long &outSumValueTime,
+                            long double &outSumSqValueTime,
+                            long &outNonZeroTime) const;
+
+    public:
+        //Default ctor - starts at time 0 with value 0.
+        TimeWeightedStatClass();
+
+        //Forgets everything accumulated and starts again at the given time
+        //with the given value.
+        void reset(const int inStartTime, const int inValue);
+
+        //Records that the value changed to newValue at changeTime, which
+        //must not be before the last change.
+        void setValue(const int changeTime, const int newValue) {
+            long duration = changeTime - lastChangeTime;
+            sumValueTime += duration * currentValue;
+            sumSqValueTime += (long double)duration * currentValue *
+                              currentValue;
+            if (currentValue > 0) {
+                nonZeroTime += duration;
+            }
+            lastChangeTime = changeTime;
+            currentValue = newValue;
+        }
+
+        //Returns the current value.
+        int getValue() const {
+            return currentValue;
+        }
+
+        //Adds numRepeats more copies of what was accumulated since this
+        //statistic was equal to the earlier copy given, as if that stretch
+        //of time had been repeated numRepeats more times, and moves the
+        //last change shiftTime (the length of the repeats) later.  The
+        //value must be the same as the earlier copy's.
+        void repeatGrowthSince(const TimeWeightedStatClass &earlier,
+                               const long numRepeats, const int shiftTime);
+
+        //Returns the integral of the value over time (the sum of value
+        //times duration) from the start up to endTime, which must not be
+        //before the last change.
+        long getIntegral(const int endTime) const {
+            return sumValueTime + (endTime - lastChangeTime) *
+                                  (long)currentValue;
+        }
+
+        //Returns the time-weighted mean of the value from the start up to
+        //endTime (which must not be before the last change), or 0 if no
+        //time has passed.
+        double getMean(const int endTime) const;
+
+        //Returns the time-weighted (population) variance of the value from
+        //the start up to endTime, or 0 if no time has passed.
+        double getVariance(const int endTime) const;
+
+        //Returns the time-weighted standard deviation of the value from the
+        //start up to endTime, or 0 if no time has passed.
+        double getStdDev(const int endTime) const;
+
+        //Returns the share (0 to 1) of the time from the start up to
+        //endTime that the value was above 0, or 0 if no time has passed.
+        double getFractionNonZero(const int endTime) const;
+};
+
+#endif // _TIMEWEIGHTEDSTATCLASS_H_
@@ -0,0 +1,128 @@
+#ifndef _TIMINGWHEELCLASS_H
+#define _TIMINGWHEELCLASS_H
+
+#include <cstring>
+using namespace std;
+#include "DaryHeapClass.h"
+
+// A priority queue keyed by integer "time tics", for values that provide
+// an int getTimeOccurs() method (such as EventClass). The near future is
+// kept in a circular array of buckets, one per tic, each of which is a
+// FIFO list, so inserting and removing values scheduled within the
+// wheel's span are O(1). Values scheduled further out than the span wait
+// in an overflow heap and are moved into their bucket once the wheel
+// turns far enough to reach them. Values with equal times come out in
+// the order they were inserted, so the ordering is identical to
+// SortedListClass's when it is used with EventClass's operator<=.
+template <class T>
+class TimingWheelClass {
+    private:
+        // One value waiting in a bucket. Nodes live in a single growable
+        // array and are linked by index so the array can be reallocated.
+        struct WheelNodeStruct {
+            T value;
+            int nextIdx; // Index of the next node in the same bucket (or
+                         // in the free list), or -1 at the end.
+        };
+
+        // Orders overflow values by time only; ties are left to the heap,
+        // which keeps them in insertion order.
+        class TimeKeyClass {
+            private:
+                T value;
+            public:
+                TimeKeyClass() {
+                }
+                TimeKeyClass(const T &inValue) {
+                    value = inValue;
+                }
+                const T& getValue() const {
+                    return value;
+                }
+                bool operator<=(const TimeKeyClass &rhs) const {
+                    return value.getTimeOccurs() <=
+                           rhs.value.getTimeOccurs();
+                }
+        };
+
+        int numSlots;         // Number of buckets; always a power of two.
+        int slotMask;         // numSlots - 1, maps a tic to its bucket.
+        int *slotHeadIdx;     // First node of each bucket, or -1.
+        int *slotTailIdx;     // Last node of each bucket, or -1.
+        WheelNodeStruct *nodes; // Storage for the nodes of all buckets.
+        int nodeCapacity;     // Number of nodes the storage can hold.
+        int freeHeadIdx;      // First unused node, or -1 if none.
+        int currentTick;      // Earliest tic the wheel currently covers;
+                              // buckets hold tics from currentTick to
+                              // currentTick + numSlots - 1.
+        int numInWheel;       // Number of values held in the buckets.
+        int numElems;         // Number of values held in total.
+        DaryHeapClass<TimeKeyClass, 4> overflowValues; // Values at or past
+                              // the end of the wheel's span.
+        DaryHeapClass<TimeKeyClass, 4> lateValues; // Values inserted with a
+                              // time before currentTick. These come out
+                              // before everything in the wheel.
+
+        // Sets up empty buckets and node storage for the given number of
+        // slots (already a power of two).
+        void initialize(const int inNumSlots);
+
+        // Frees all of the dynamically allocated storage.
+        void freeStorage();
+
+        // Appends a value to the tail of the bucket for its time.
+        void appendToBucket(const T &valToInsert);
+
+        // Moves every overflow value that now falls within the wheel's
+        // span into its bucket, earliest first.
+        void migrateOverflow();
+
+        // Finds the tic of the first non-empty bucket, starting at
+        // currentTick. Must only be called when numInWheel > 0.
+        int findNextOccupiedTick() const;
+
+    public:
+        // Default Constructor. Will properly initialize a wheel to be
+        // empty. The number of slots is rounded up to a power of two, and
+        // should cover the largest delay that is commonly scheduled.
+        TimingWheelClass(const int inNumSlots = 256);
+
+        // Copy constructor. Will make a complete (deep) copy of the wheel,
+        // such that one can be changed without affecting the other.
+        TimingWheelClass(const TimingWheelClass<T> &rhs);
+
+        // Destructor. Responsible for making sure any dynamic memory
+        // associated with an object is freed up when the object is
+        // being destroyed.
+        ~TimingWheelClass();
+
+        // Assignment operator. Will assign one wheel (on left hand side of
+        // operator) to be a duplicate of the other (on the right hand side
+        // of operator).
+        TimingWheelClass<T>& operator=(const TimingWheelClass<T> &rhs);
+
+        // Clears the wheel to an empty state, turning it back to tic 0.
+        void clear();
+
+        // Inserts a value into the wheel. If the value has the same time
+        // as one or more values already in the wheel, it will be removed
+        // AFTER the previously inserted ones.
+        void insertValue(const T &valToInsert);
+
+        // Removes the front (earliest) item and returns it via the
+        // reference parameter. If the wheel was empty, the function
+        // returns false and the reference parameter is left unchanged.
+        // Otherwise true is returned.
+        bool removeFront(T &theVal);
+
+        // Provides a copy of the front (earliest) item without removing
+        // it. Returns false, leaving outVal unchanged, if the wheel is
+        // empty.
+        bool peekFront(T &outVal) const;
+
+        // Returns the number of values contained in the wheel.
+        int getNumElems() const;
+};
+
+#include "TimingWheelClass.inl"
+#endif
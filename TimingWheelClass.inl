@@ -0,0 +1,279 @@
+// Initial number of bucket nodes allocated for a wheel.
+const int TIMING_WHEEL_INITIAL_NODES = 64;
+
+// Sets up empty buckets and node storage for the given number of
+// slots (already a power of two).
+template <class T>
+void TimingWheelClass<T>::initialize(const int inNumSlots) {
+    numSlots = inNumSlots;
+    slotMask = numSlots - 1;
+    slotHeadIdx = new int[numSlots];
+    slotTailIdx = new int[numSlots];
+    for (int i = 0; i < numSlots; i++) {
+        slotHeadIdx[i] = -1;
+        slotTailIdx[i] = -1;
+    }
+
+    nodeCapacity = TIMING_WHEEL_INITIAL_NODES;
+    nodes = new WheelNodeStruct[nodeCapacity];
+    for (int i = 0; i < nodeCapacity; i++) {
+        nodes[i].nextIdx = i + 1;
+    }
+    nodes[nodeCapacity - 1].nextIdx = -1;
+    freeHeadIdx = 0;
+
+    currentTick = 0;
+    numInWheel = 0;
+    numElems = 0;
+}
+
+// Frees all of the dynamically allocated storage.
+template <class T>
+void TimingWheelClass<T>::freeStorage() {
+    delete [] slotHeadIdx;
+    delete [] slotTailIdx;
+    delete [] nodes;
+    slotHeadIdx = 0;
+    slotTailIdx = 0;
+    nodes = 0;
+}
+
+// Appends a value to the tail of the bucket for its time.
+template <class T>
+void TimingWheelClass<T>::appendToBucket(const T &valToInsert) {
+    // double the node storage when every node is in use
+    if (freeHeadIdx == -1) {
+        int newCapacity = nodeCapacity * 2;
+        WheelNodeStruct *newNodes = new WheelNodeStruct[newCapacity];
+        for (int i = 0; i < nodeCapacity; i++) {
+            newNodes[i] = nodes[i];
+        }
+        for (int i = nodeCapacity; i < newCapacity; i++) {
+            newNodes[i].nextIdx = i + 1;
+        }
+        newNodes[newCapacity - 1].nextIdx = -1;
+        freeHeadIdx = nodeCapacity;
+
+        delete [] nodes;
+        nodes = newNodes;
+        nodeCapacity = newCapacity;
+    }
+
+    int nodeIdx = freeHeadIdx;
+    freeHeadIdx = nodes[nodeIdx].nextIdx;
+    nodes[nodeIdx].value = valToInsert;
+    nodes[nodeIdx].nextIdx = -1;
+
+    int slotIdx = valToInsert.getTimeOccurs() & slotMask;
+    if (slotTailIdx[slotIdx] == -1) {
+        slotHeadIdx[slotIdx] = nodeIdx;
+    }
+    else {
+        nodes[slotTailIdx[slotIdx]].nextIdx = nodeIdx;
+    }
+    slotTailIdx[slotIdx] = nodeIdx;
+    numInWheel++;
+}
+
+// Moves every overflow value that now falls within the wheel's
+// span into its bucket, earliest first.
+template <class T>
+void TimingWheelClass<T>::migrateOverflow() {
+    TimeKeyClass overflowFront;
+
+    // Values in the heap with equal times come out in insertion order,
+    // and nothing can have been inserted straight into a bucket for these
+    // tics yet, so the bucket order ends up the same as insertion order.
+    while (overflowValues.peekFront(overflowFront) &&
+           overflowFront.getValue().getTimeOccurs() <
+           currentTick + numSlots) {
+        overflowValues.removeFront(overflowFront);
+        appendToBucket(overflowFront.getValue());
+    }
+}
+
+// Finds the tic of the first non-empty bucket, starting at
+// currentTick. Must only be called when numInWheel > 0.
+template <class T>
+int TimingWheelClass<T>::findNextOccupiedTick() const {
+    int tick = currentTick;
+    while (slotHeadIdx[tick & slotMask] == -1) {
+        tick++;
+    }
+    return tick;
+}
+
+// Default Constructor. Will properly initialize a wheel to be
+// empty. The number of slots is rounded up to a power of two, and
+// should cover the largest delay that is commonly scheduled.
+template <class T>
+TimingWheelClass<T>::TimingWheelClass(const int inNumSlots) {
+    int roundedSlots = 1;
+    while (roundedSlots < inNumSlots) {
+        roundedSlots *= 2;
+    }
+    initialize(roundedSlots);
+}
+
+// Copy constructor. Will make a complete (deep) copy of the wheel,
+// such that one can be changed without affecting the other.
+template <class T>
+TimingWheelClass<T>::TimingWheelClass(const TimingWheelClass<T> &rhs) {
+    initialize(rhs.numSlots);
+    *this = rhs;
+}
+
+// Destructor. Responsible for making sure any dynamic memory
+// associated with an object is freed up when the object is
+// being destroyed.
+template <class T>
+TimingWheelClass<T>::~TimingWheelClass() {
+    freeStorage();
+}
+
+// Assignment operator. Will assign one wheel (on left hand side of
+// operator) to be a duplicate of the other (on the right hand side
+// of operator).
+template <class T>
+TimingWheelClass<T>& TimingWheelClass<T>::operator=(
+    const TimingWheelClass<T> &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    // storage of the same size is reused, so a wheel can be saved and
+    // restored over and over without allocating
+    if (numSlots != rhs.numSlots) {
+        delete [] slotHeadIdx;
+        delete [] slotTailIdx;
+        numSlots = rhs.numSlots;
+        slotMask = rhs.slotMask;
+        slotHeadIdx = new int[numSlots];
+        slotTailIdx = new int[numSlots];
+    }
+    memcpy(slotHeadIdx, rhs.slotHeadIdx, numSlots * sizeof(int));
+    memcpy(slotTailIdx, rhs.slotTailIdx, numSlots * sizeof(int));
+
+    // node links are indices, so the storage can be copied as is
+    if (nodeCapacity != rhs.nodeCapacity) {
+        delete [] nodes;
+        nodeCapacity = rhs.nodeCapacity;
+        nodes = new WheelNodeStruct[nodeCapacity];
+    }
+    for (int i = 0; i < nodeCapacity; i++) {
+        nodes[i] = rhs.nodes[i];
+    }
+    freeHeadIdx = rhs.freeHeadIdx;
+
+    currentTick = rhs.currentTick;
+    numInWheel = rhs.numInWheel;
+    numElems = rhs.numElems;
+    overflowValues = rhs.overflowValues;
+    lateValues = rhs.lateValues;
+
+    return *this;
+}
+
+// Clears the wheel to an empty state, turning it back to tic 0.
+template <class T>
+void TimingWheelClass<T>::clear() {
+    int oldNumSlots = numSlots;
+    freeStorage();
+    initialize(oldNumSlots);
+    overflowValues.clear();
+    lateValues.clear();
+}
+
+// Inserts a value into the wheel. If the value has the same time
+// as one or more values already in the wheel, it will be removed
+// AFTER the previously inserted ones.
+template <class T>
+void TimingWheelClass<T>::insertValue(const T &valToInsert) {
+    int timeVal = valToInsert.getTimeOccurs();
+
+    if (timeVal < currentTick) {
+        lateValues.insertValue(TimeKeyClass(valToInsert));
+    }
+    else if (timeVal < currentTick + numSlots) {
+        appendToBucket(valToInsert);
+    }
+    else {
+        overflowValues.insertValue(TimeKeyClass(valToInsert));
+    }
+    numElems++;
+}
+
+// Removes the front (earliest) item and returns it via the
+// reference parameter. If the wheel was empty, the function
+// returns false and the reference parameter is left unchanged.
+// Otherwise true is returned.
+template <class T>
+bool TimingWheelClass<T>::removeFront(T &theVal) {
+    TimeKeyClass heapFront;
+
+    if (numElems == 0) {
+        return false;
+    }
+    numElems--;
+
+    // anything inserted behind the wheel comes first
+    if (lateValues.removeFront(heapFront)) {
+        theVal = heapFront.getValue();
+        return true;
+    }
+
+    // if the buckets are all empty, turn the wheel straight to the
+    // earliest overflow value
+    if (numInWheel == 0) {
+        overflowValues.peekFront(heapFront);
+        currentTick = heapFront.getValue().getTimeOccurs();
+        migrateOverflow();
+    }
+
+    currentTick = findNextOccupiedTick();
+    int slotIdx = currentTick & slotMask;
+    int nodeIdx = slotHeadIdx[slotIdx];
+    theVal = nodes[nodeIdx].value;
+
+    // unlink the node and give it back to the free list
+    slotHeadIdx[slotIdx] = nodes[nodeIdx].nextIdx;
+    if (slotHeadIdx[slotIdx] == -1) {
+        slotTailIdx[slotIdx] = -1;
+    }
+    nodes[nodeIdx].nextIdx = freeHeadIdx;
+    freeHeadIdx = nodeIdx;
+    numInWheel--;
+
+    // the wheel may have turned far enough to reach overflow values
+    migrateOverflow();
+    return true;
+}
+
+// Provides a copy of the front (earliest) item without removing
+// it. Returns false, leaving outVal unchanged, if the wheel is
+// empty.
+template <class T>
+bool TimingWheelClass<T>::peekFront(T &outVal) const {
+    TimeKeyClass heapFront;
+
+    if (numElems == 0) {
+        return false;
+    }
+    if (lateValues.peekFront(heapFront)) {
+        outVal = heapFront.getValue();
+        return true;
+    }
+    if (numInWheel == 0) {
+        overflowValues.peekFront(heapFront);
+        outVal = heapFront.getValue();
+        return true;
+    }
+    outVal = nodes[slotHeadIdx[findNextOccupiedTick() & slotMask]].value;
+    return true;
+}
+
+// Returns the number of values contained in the wheel.
+template <class T>
+int TimingWheelClass<T>::getNumElems() const {
+    return numElems;
+}
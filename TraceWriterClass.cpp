@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+using namespace std;
+
+#include "TraceWriterClass.h"
+
+//Size of the output buffer; output is handed to the stream in blocks of
+//up to this many characters
+const int TRACE_BUFFER_SIZE = 65536;
+
+//Longest decimal representation of an int, including the sign
+const int MAX_INT_CHARS = 11;
+
+//The two-character decimal representations of 00 through 99
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+TraceWriterClass::TraceWriterClass(ostream &inOutStream) {
+    outStream = &inOutStream;
+    buffer = 0;
+    numBuffered = 0;
+}
+
+TraceWriterClass::TraceWriterClass(const TraceWriterClass &rhs) {
+    outStream = rhs.outStream;
+    buffer = 0;
+    numBuffered = 0;
+}
+
+TraceWriterClass::~TraceWriterClass() {
+    flush();
+    delete [] buffer;
+}
+
+TraceWriterClass& TraceWriterClass::operator=(const TraceWriterClass &rhs) {
+    if (this != &rhs) {
+        flush();
+        outStream = rhs.outStream;
+    }
+    return *this;
+}
+
+void TraceWriterClass::flush() {
+    if (numBuffered > 0) {
+        outStream->write(buffer, numBuffered);
+        numBuffered = 0;
+    }
+}
+
+bool TraceWriterClass::makeRoom(const int numChars) {
+    if (buffer == 0) {
+        buffer = new char[TRACE_BUFFER_SIZE];
+    }
+    if (numBuffered + numChars > TRACE_BUFFER_SIZE) {
+        flush();
+    }
+    return numChars <= TRACE_BUFFER_SIZE;
+}
+
+void TraceWriterClass::writeChars(const char *chars, const int numChars) {
+    if (makeRoom(numChars)) {
+        memcpy(buffer + numBuffered, chars, numChars);
+        numBuffered += numChars;
+    }
+    else {
+        outStream->write(chars, numChars);
+    }
+}
+
+TraceWriterClass& TraceWriterClass::operator<<(const string &str) {
+    writeChars(str.data(), (int)str.length());
+    return *this;
+}
+
+TraceWriterClass& TraceWriterClass::operator<<(const char charVal) {
+    makeRoom(1);
+    buffer[numBuffered] = charVal;
+    numBuffered++;
+    return *this;
+}
+
+TraceWriterClass& TraceWriterClass::operator<<(const int intVal) {
+    char digits[MAX_INT_CHARS];
+    int firstIdx = MAX_INT_CHARS;
+    //Work with the magnitude as unsigned, so INT_MIN is handled too
+    unsigned int magnitude = (intVal < 0) ? 0u - (unsigned int)intVal :
+                                            (unsigned int)intVal;
+
+    while (magnitude >= 100) {
+        int pairIdx = (magnitude % 100) * 2;
+        magnitude /= 100;
+        firstIdx -= 2;
+        digits[firstIdx] = DIGIT_PAIRS[pairIdx];
+        digits[firstIdx + 1] = DIGIT_PAIRS[pairIdx + 1];
+    }
+    if (magnitude >= 10) {
+        firstIdx -= 2;
+        digits[firstIdx] = DIGIT_PAIRS[magnitude * 2];
+        digits[firstIdx + 1] = DIGIT_PAIRS[magnitude * 2 + 1];
+    }
+    else {
+        firstIdx--;
+        digits[firstIdx] = (char)('0' + magnitude);
+    }
+    if (intVal < 0) {
+        firstIdx--;
+        digits[firstIdx] = '-';
+    }
+
+    writeChars(digits + firstIdx, MAX_INT_CHARS - firstIdx);
+    return *this;
+}
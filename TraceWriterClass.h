@@ -0,0 +1,65 @@
+#ifndef _TRACEWRITERCLASS_H_
+#define _TRACEWRITERCLASS_H_
+
+#include <iostream>
+#include <string>
+
+//Purpose: A buffered writer for the simulation's event trace.  Values
+//         are formatted straight into a large buffer (integers through a
+//         two-digits-at-a-time conversion, string literals without
+//         measuring them), and the buffer is handed to an output stream
+//         in one block when it fills up or is flushed.  The text produced
+//         is exactly what the same values give when inserted into an
+//         ostream with default formatting.  The buffer is not allocated
+//         until something is first written.
+class TraceWriterClass {
+    private:
+        std::ostream *outStream; //Stream the buffered output goes to
+        char *buffer;    //Output not yet handed to outStream
+        int numBuffered; //Number of characters in the buffer
+
+        //Makes sure the buffer exists and has room for numChars more
+        //characters, flushing it if necessary. Returns false if numChars
+        //won't fit even in an empty buffer.
+        bool makeRoom(const int numChars);
+
+        //Appends numChars characters to the output.
+        void writeChars(const char *chars, const int numChars);
+
+    public:
+        //Makes a writer that sends its output to the given stream (the
+        //console by default).
+        TraceWriterClass(std::ostream &inOutStream = std::cout);
+
+        //Copy ctor - the copy writes to the same stream, but starts out
+        //with an empty buffer; output buffered in rhs is not duplicated.
+        TraceWriterClass(const TraceWriterClass &rhs);
+
+        //Flushes any buffered output and frees the buffer.
+        ~TraceWriterClass();
+
+        //Flushes this writer, then makes it write to the same stream as
+        //rhs. Output buffered in rhs is not duplicated.
+        TraceWriterClass& operator=(const TraceWriterClass &rhs);
+
+        //Hands everything buffered so far to the output stream.
+        void flush();
+
+        //Appends a string literal; its length is known at compile time.
+        template <int NUM_CHARS>
+        TraceWriterClass& operator<<(const char (&literal)[NUM_CHARS]) {
+            writeChars(literal, NUM_CHARS - 1);
+            return *this;
+        }
+
+        //Appends a string.
+        TraceWriterClass& operator<<(const std::string &str);
+
+        //Appends a single character.
+        TraceWriterClass& operator<<(const char charVal);
+
+        //Appends an integer in decimal.
+        TraceWriterClass& operator<<(const int intVal);
+};
+
+#endif // _TRACEWRITERCLASS_H_
@@ -0,0 +1,1350 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <malloc.h>
+using namespace std;
+
+#include "EventClass.h"
+#include "SortedListClass.h"
+#include "DaryHeapClass.h"
+#include "PairingHeapClass.h"
+#include "TimingWheelClass.h"
+#include "PoolNodeAllocatorClass.h"
+#include "FIFOQueueClass.h"
+#include "CarQueueClass.h"
+#include "IntersectionSimulationClass.h"
+#include "RandomGeneratorClass.h"
+#include "ArrivalGeneratorClass.h"
+#include "LogHistogramClass.h"
+#include "ReplicationRunnerClass.h"
+#include "ParameterSweepClass.h"
+#include "NetworkSimulationClass.h"
+#include "ThreadPoolClass.h"
+#include "constants.h"
+
+//Purpose: Micro-benchmarks for the building blocks of the intersection
+//         simulation.  Run as "bench.exe <benchmarkName> [options]"; run
+//         with no arguments to see the list of benchmarks.
+
+//Number of times the global operator new has been called in this
+//process, and the number of heap bytes currently (and at most) in use.
+//The replacement operators below count every allocation so benchmarks
+//can check how often the heap is being used and how much of it.
+static long numGlobalAllocs = 0;
+static long numLiveHeapBytes = 0;
+static long peakLiveHeapBytes = 0;
+
+void* operator new(size_t numBytes) throw(bad_alloc) {
+    __sync_fetch_and_add(&numGlobalAllocs, 1);
+    void *storage = malloc(numBytes > 0 ? numBytes : 1);
+    if (storage == 0) {
+        throw bad_alloc();
+    }
+    long liveBytes = __sync_add_and_fetch(&numLiveHeapBytes,
+                                          (long)malloc_usable_size(storage));
+    if (liveBytes > peakLiveHeapBytes) {
+        peakLiveHeapBytes = liveBytes;
+    }
+    return storage;
+}
+
+void* operator new[](size_t numBytes) throw(bad_alloc) {
+    return operator new(numBytes);
+}
+
+void operator delete(void *storage) throw() {
+    if (storage != 0) {
+        __sync_fetch_and_sub(&numLiveHeapBytes,
+                             (long)malloc_usable_size(storage));
+    }
+    free(storage);
+}
+
+void operator delete[](void *storage) throw() {
+    operator delete(storage);
+}
+
+//A stream buffer that throws away everything written to it, used to
+//silence the simulation's console output while it is being measured.
+class NullStreamBufferClass : public streambuf {
+    protected:
+        int overflow(int charVal) {
+            return charVal;
+        }
+        streamsize xsputn(const char *, streamsize numChars) {
+            return numChars;
+        }
+};
+
+//Returns a monotonic wall clock reading, in seconds.
+static double getWallSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+//A tiny xorshift generator, so benchmark inputs are the same on every
+//platform and don't disturb the simulation's own random numbers.
+class BenchRandomClass {
+    private:
+        unsigned int state;
+    public:
+        BenchRandomClass(const unsigned int seedVal) {
+            state = seedVal | 1;
+        }
+
+        unsigned int getNext() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+};
+
+//Classic "hold model": fill the container with numPending events, then
+//repeatedly remove the front event and insert a new one a random
+//increment later, so the container size stays constant.  Reports the
+//average time per hold operation in nanoseconds, and a checksum of the
+//order in which events came out so the containers can be cross-checked
+//(the typeId of each event is used as its insertion number, which makes
+//the checksum sensitive to how ties were broken).
+template <class ContainerT>
+double runHoldModel(const int numPending, const int numHoldOps,
+                    unsigned int &checksum) {
+    const int MAX_INCREMENT = 200;
+    ContainerT container;
+    BenchRandomClass randGen(12345);
+    EventClass frontEvent;
+    int insertNum = 0;
+
+    for (int i = 0; i < numPending; i++) {
+        container.insertValue(EventClass(randGen.getNext() % MAX_INCREMENT,
+                                         insertNum));
+        insertNum++;
+    }
+
+    checksum = 0;
+    double startTime = getWallSeconds();
+    for (int i = 0; i < numHoldOps; i++) {
+        container.removeFront(frontEvent);
+        checksum = checksum * 31 + frontEvent.getType();
+        int newTime = frontEvent.getTimeOccurs() +
+                      randGen.getNext() % MAX_INCREMENT;
+        container.insertValue(EventClass(newTime, insertNum));
+        insertNum++;
+    }
+    double elapsed = getWallSeconds() - startTime;
+
+    return elapsed * 1e9 / numHoldOps;
+}
+
+//Prints one row of the hold model results table.
+static void printHoldRow(const int numPending, const string &containerName,
+                         const double nsPerOp, const unsigned int checksum) {
+    cout << setw(10) << numPending << "  " << setw(16) << left <<
+            containerName << right << setw(12) << fixed << setprecision(1) <<
+            nsPerOp << "    " << hex << checksum << dec << endl;
+}
+
+//Compares the event list containers using the hold model for pending
+//event counts from 10^2 to 10^6.  SortedListClass takes O(n) per insert,
+//and even just filling it is O(n^2), so it is only run up to
+//--sorted-list-max pending events.
+static void benchmarkHoldModel(int argc, char *argv[]) {
+    int numHoldOps = 100000;
+    int sortedListMax = 10000;
+    unsigned int checksum;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--ops") {
+            numHoldOps = atoi(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--sorted-list-max") {
+            sortedListMax = atoi(argv[i + 1]);
+        }
+    }
+
+    cout << "Hold model, " << numHoldOps << " operations per size" << endl;
+    cout << "   pending  container            ns/hold    order checksum"
+         << endl;
+    for (int numPending = 100; numPending <= 1000000; numPending *= 10) {
+        double nsPerOp;
+
+        if (numPending <= sortedListMax) {
+            nsPerOp = runHoldModel< SortedListClass<EventClass> >(
+                          numPending, numHoldOps, checksum);
+            printHoldRow(numPending, "sorted list", nsPerOp, checksum);
+        }
+        else {
+            cout << setw(10) << numPending << "  " << setw(16) << left <<
+                    "sorted list" << right << setw(12) << "skipped" << endl;
+        }
+
+        if (numPending <= sortedListMax) {
+            nsPerOp = runHoldModel<
+                          SortedListClass<EventClass, PoolNodeAllocatorClass> >(
+                          numPending, numHoldOps, checksum);
+            printHoldRow(numPending, "sorted list/pool", nsPerOp, checksum);
+        }
+
+        nsPerOp = runHoldModel< DaryHeapClass<EventClass, 2> >(
+                      numPending, numHoldOps, checksum);
+        printHoldRow(numPending, "binary heap", nsPerOp, checksum);
+
+        nsPerOp = runHoldModel< DaryHeapClass<EventClass, 4> >(
+                      numPending, numHoldOps, checksum);
+        printHoldRow(numPending, "4-ary heap", nsPerOp, checksum);
+
+        nsPerOp = runHoldModel< PairingHeapClass<EventClass> >(
+                      numPending, numHoldOps, checksum);
+        printHoldRow(numPending, "pairing heap", nsPerOp, checksum);
+
+        nsPerOp = runHoldModel<
+                      PairingHeapClass<EventClass, PoolNodeAllocatorClass> >(
+                      numPending, numHoldOps, checksum);
+        printHoldRow(numPending, "pairing/pool", nsPerOp, checksum);
+
+        nsPerOp = runHoldModel< TimingWheelClass<EventClass> >(
+                      numPending, numHoldOps, checksum);
+        printHoldRow(numPending, "timing wheel", nsPerOp, checksum);
+    }
+}
+
+//Runs a whole simulation with its console output discarded, counting
+//every heap allocation, and reports how many happen once the first
+//--warmup events have been handled.  With the node pools, ring buffer
+//queues and timing wheel in place this should be zero: containers only
+//grow (geometrically) while the run is warming up.
+static void benchmarkAllocations(int argc, char *argv[]) {
+    long numWarmupEvents = 200;
+    NullStreamBufferClass nullBuffer;
+    IntersectionSimulationClass simObj;
+
+    if (argc < 3) {
+        cout << "The allocs benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--warmup") {
+            numWarmupEvents = atol(argv[i + 1]);
+        }
+    }
+
+    streambuf *consoleBuffer = cout.rdbuf(&nullBuffer);
+    long allocsAtStart = numGlobalAllocs;
+    simObj.readParametersFromFile(argv[2]);
+    if (!simObj.getIsSetupProperly()) {
+        cout.rdbuf(consoleBuffer);
+        cout << "Simulation is not setup properly!" << endl;
+        return;
+    }
+    simObj.scheduleSeedEvents();
+
+    long numEvents = 0;
+    long allocsAfterWarmup = -1;
+    bool doKeepRunning = true;
+    while (doKeepRunning) {
+        doKeepRunning = simObj.handleNextEvent();
+        numEvents++;
+        if (numEvents == numWarmupEvents) {
+            allocsAfterWarmup = numGlobalAllocs;
+        }
+    }
+    long allocsAtEnd = numGlobalAllocs;
+    cout.rdbuf(consoleBuffer);
+
+    cout << "Events handled: " << numEvents << endl;
+    cout << "Heap allocations, whole run: " << allocsAtEnd - allocsAtStart <<
+            endl;
+    if (allocsAfterWarmup < 0) {
+        cout << "Run ended before the " << numWarmupEvents <<
+                " warm-up events were handled" << endl;
+    }
+    else {
+        long steadyEvents = numEvents - numWarmupEvents;
+        long steadyAllocs = allocsAtEnd - allocsAfterWarmup;
+        cout << "Heap allocations after " << numWarmupEvents <<
+                " warm-up events: " << steadyAllocs << " over " <<
+                steadyEvents << " events (" <<
+                (steadyEvents > 0 ? double(steadyAllocs) / steadyEvents : 0) <<
+                " per event)" << endl;
+    }
+}
+
+//Runs the simulation described by a parameter file --runs times (3 by
+//default) at each verbosity level, with the console output sent to the
+//null device so the cost of writing (and flushing) it is still paid, and
+//reports the best rate in events handled per second.  Build with
+//"make bench TRACE=0" to measure the simulation with its trace output
+//compiled out.
+static void benchmarkVerbosity(int argc, char *argv[]) {
+    const int NUM_LEVELS = 3;
+    const int LEVELS[NUM_LEVELS] = {
+        VERBOSITY_TRACE, VERBOSITY_STATS, VERBOSITY_SILENT
+    };
+    const string LEVEL_NAMES[NUM_LEVELS] = { "trace", "stats", "silent" };
+    int numRuns = 3;
+
+    if (argc < 3) {
+        cout << "The verbosity benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--runs") {
+            numRuns = atoi(argv[i + 1]);
+        }
+    }
+
+    ofstream devNull("/dev/null");
+    if (devNull.fail()) {
+        cout << "Unable to open /dev/null" << endl;
+        return;
+    }
+
+#ifdef SIM_NO_TRACE
+    cout << "Trace output: compiled out (SIM_NO_TRACE)" << endl;
+#else
+    cout << "Trace output: compiled in" << endl;
+#endif
+    cout << "level       events     events/sec" << endl;
+    for (int levelIdx = 0; levelIdx < NUM_LEVELS; levelIdx++) {
+        double bestSeconds = -1;
+        long numEvents = 0;
+
+        for (int runIdx = 0; runIdx < numRuns; runIdx++) {
+            IntersectionSimulationClass simObj;
+            streambuf *consoleBuffer = cout.rdbuf(devNull.rdbuf());
+
+            simObj.setVerbosityLevel(LEVELS[levelIdx]);
+            simObj.readParametersFromFile(argv[2]);
+            if (!simObj.getIsSetupProperly()) {
+                cout.rdbuf(consoleBuffer);
+                cout << "Simulation is not setup properly!" << endl;
+                return;
+            }
+
+            double startTime = getWallSeconds();
+            simObj.scheduleSeedEvents();
+            numEvents = 0;
+            bool doKeepRunning = true;
+            while (doKeepRunning) {
+                doKeepRunning = simObj.handleNextEvent();
+                numEvents++;
+            }
+            if (LEVELS[levelIdx] >= VERBOSITY_STATS) {
+                simObj.printStatistics();
+            }
+            cout.flush();
+            double elapsed = getWallSeconds() - startTime;
+            cout.rdbuf(consoleBuffer);
+
+            if (bestSeconds < 0 || elapsed < bestSeconds) {
+                bestSeconds = elapsed;
+            }
+        }
+
+        cout << setw(6) << left << LEVEL_NAMES[levelIdx] << right <<
+                setw(11) << numEvents << setw(15) << fixed <<
+                setprecision(0) << numEvents / bestSeconds << endl;
+    }
+}
+
+//The car record as it was before cars were stored compactly: the travel
+//direction was kept as a std::string in every car.
+struct LegacyCarStruct {
+    int uniqueId;
+    string travelDir;
+    int arrivalTime;
+};
+
+//Prints one row of the car memory results table.
+static void printCarMemRow(const string &layoutName, const int numCars,
+                           const long numBytes, const long numPeakBytes,
+                           const double enqueueSeconds,
+                           const double dequeueSeconds, const long checksum) {
+    cout << setw(26) << left << layoutName << right << fixed <<
+            setprecision(1) << setw(9) << numBytes / 1048576.0 <<
+            setw(9) << numPeakBytes / 1048576.0 <<
+            setw(10) << double(numBytes) / numCars <<
+            setw(10) << enqueueSeconds * 1e9 / numCars <<
+            setw(10) << dequeueSeconds * 1e9 / numCars <<
+            "   " << checksum << endl;
+}
+
+//Queues --cars cars (10^7 by default) in one queue, the way an
+//oversaturated approach piles them up, then drains it.  Reports the
+//heap bytes held once every car is queued, the peak while the queue was
+//growing, bytes per queued car and the time per enqueue and dequeue,
+//for the legacy string-carrying car record, the compact CarClass in a
+//FIFOQueueClass and the struct-of-arrays CarQueueClass the simulation
+//uses.  The checksum of dequeued ids and arrival times must agree.
+static void benchmarkCarMemory(int argc, char *argv[]) {
+    int numCars = 10000000;
+    const string DIRECTIONS[NUM_DIRECTIONS] = {
+        EAST_DIRECTION, WEST_DIRECTION, NORTH_DIRECTION, SOUTH_DIRECTION
+    };
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--cars") {
+            numCars = atoi(argv[i + 1]);
+        }
+    }
+    if (numCars <= 0) {
+        cout << "The carmem benchmark needs a positive --cars value" << endl;
+        return;
+    }
+
+    cout << "layout                      MB held  MB peak     B/car" <<
+            "    ns/enq    ns/deq   checksum" << endl;
+
+    {
+        FIFOQueueClass<LegacyCarStruct> legacyQueue;
+        LegacyCarStruct car;
+        long bytesAtStart = numLiveHeapBytes;
+        peakLiveHeapBytes = numLiveHeapBytes;
+        double startTime = getWallSeconds();
+        for (int i = 0; i < numCars; i++) {
+            car.uniqueId = i;
+            car.travelDir = DIRECTIONS[i % NUM_DIRECTIONS];
+            car.arrivalTime = i / 4;
+            legacyQueue.enqueue(car);
+        }
+        double enqueueSeconds = getWallSeconds() - startTime;
+        long numBytes = numLiveHeapBytes - bytesAtStart;
+        long numPeakBytes = peakLiveHeapBytes - bytesAtStart;
+
+        long checksum = 0;
+        startTime = getWallSeconds();
+        while (legacyQueue.dequeue(car)) {
+            checksum += car.uniqueId + car.arrivalTime +
+                        (long)car.travelDir.length();
+        }
+        double dequeueSeconds = getWallSeconds() - startTime;
+        printCarMemRow("legacy (std::string dir)", numCars, numBytes,
+                       numPeakBytes, enqueueSeconds, dequeueSeconds, checksum);
+    }
+
+    {
+        FIFOQueueClass<CarClass> compactQueue;
+        CarClass car;
+        long bytesAtStart = numLiveHeapBytes;
+        peakLiveHeapBytes = numLiveHeapBytes;
+        double startTime = getWallSeconds();
+        for (int i = 0; i < numCars; i++) {
+            unsigned char dirCode = (unsigned char)(i % NUM_DIRECTIONS);
+            compactQueue.enqueue(CarClass(i, dirCode, i / 4));
+        }
+        double enqueueSeconds = getWallSeconds() - startTime;
+        long numBytes = numLiveHeapBytes - bytesAtStart;
+        long numPeakBytes = peakLiveHeapBytes - bytesAtStart;
+
+        long checksum = 0;
+        startTime = getWallSeconds();
+        while (compactQueue.dequeue(car)) {
+            checksum += car.getId() + car.getArrivalTime() +
+                        (long)getDirectionName(car.getTravelDirCode()).length();
+        }
+        double dequeueSeconds = getWallSeconds() - startTime;
+        printCarMemRow("compact CarClass in FIFO", numCars, numBytes,
+                       numPeakBytes, enqueueSeconds, dequeueSeconds, checksum);
+    }
+
+    {
+        CarQueueClass carQueue;
+        CarClass car;
+        long bytesAtStart = numLiveHeapBytes;
+        peakLiveHeapBytes = numLiveHeapBytes;
+        double startTime = getWallSeconds();
+        for (int i = 0; i < numCars; i++) {
+            unsigned char dirCode = (unsigned char)(i % NUM_DIRECTIONS);
+            carQueue.enqueue(CarClass(i, dirCode, i / 4));
+        }
+        double enqueueSeconds = getWallSeconds() - startTime;
+        long numBytes = numLiveHeapBytes - bytesAtStart;
+        long numPeakBytes = peakLiveHeapBytes - bytesAtStart;
+
+        long checksum = 0;
+        startTime = getWallSeconds();
+        while (carQueue.dequeue(car)) {
+            checksum += car.getId() + car.getArrivalTime() +
+                        (long)getDirectionName(car.getTravelDirCode()).length();
+        }
+        double dequeueSeconds = getWallSeconds() - startTime;
+        printCarMemRow("CarQueueClass (SoA)", numCars, numBytes,
+                       numPeakBytes, enqueueSeconds, dequeueSeconds, checksum);
+    }
+}
+
+//Runs --replications replications (64 by default) of the simulation
+//described by a parameter file on thread pools of 1, 2, 4, ... threads
+//up to the number of processors (or --max-threads), and reports the
+//wall time and speedup over one thread for each.  The checksum of every
+//replication's results, weighted by replication number, and the mean
+//longest east-bound queue must be the same on every row.
+static void benchmarkReplications(int argc, char *argv[]) {
+    int numReplications = 64;
+    int maxNumThreads = ThreadPoolClass::getNumProcessors();
+    NullStreamBufferClass nullBuffer;
+    IntersectionSimulationClass simObj;
+
+    if (argc < 3) {
+        cout << "The replicate benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--replications") {
+            numReplications = atoi(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--max-threads") {
+            maxNumThreads = atoi(argv[i + 1]);
+        }
+    }
+    if (numReplications <= 0 || maxNumThreads <= 0) {
+        cout << "The replicate benchmark needs positive --replications" <<
+                " and --max-threads values" << endl;
+        return;
+    }
+
+    streambuf *consoleBuffer = cout.rdbuf(&nullBuffer);
+    simObj.readParametersFromFile(argv[2]);
+    cout.rdbuf(consoleBuffer);
+    if (!simObj.getIsSetupProperly()) {
+        cout << "Simulation is not setup properly!" << endl;
+        return;
+    }
+
+    cout << "Processors: " << ThreadPoolClass::getNumProcessors() <<
+            ", replications: " << numReplications << endl;
+    cout << "threads   seconds   speedup   checksum   mean east queue" <<
+            endl;
+    double oneThreadSeconds = -1;
+    int numThreads = 1;
+    while (true) {
+        ThreadPoolClass threadPool(numThreads);
+        ReplicationRunnerClass replicationRunner(simObj, numReplications);
+        double startTime = getWallSeconds();
+        replicationRunner.run(threadPool);
+        double elapsed = getWallSeconds() - startTime;
+        if (oneThreadSeconds < 0) {
+            oneThreadSeconds = elapsed;
+        }
+
+        long checksum = 0;
+        for (int repIdx = 0; repIdx < numReplications; repIdx++) {
+            const SimulationResultStruct &result =
+                                   replicationRunner.getResult(repIdx);
+            for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                checksum += (repIdx + 1) * (result.maxQueueLengths[dirIdx] +
+                                            result.numAdvanced[dirIdx]);
+            }
+        }
+        cout << setw(7) << numThreads << fixed << setprecision(3) <<
+                setw(10) << elapsed << setprecision(2) << setw(10) <<
+                oneThreadSeconds / elapsed << setw(11) << checksum <<
+                setprecision(4) << setw(18) <<
+                replicationRunner.getMaxQueueLengthStats(
+                                  DIR_CODE_EAST).getMean() << endl;
+
+        if (numThreads >= maxNumThreads) {
+            break;
+        }
+        numThreads = (numThreads * 2 > maxNumThreads) ?
+                     maxNumThreads : numThreads * 2;
+    }
+}
+
+//Runs the grid of a sweep file over the simulation described by a
+//parameter file on thread pools of 1, 2, 4, ... threads up to the number
+//of processors (or --max-threads), and reports the wall time, grid points
+//per second, speedup over one thread and number of work steals for each.
+//The checksum of the results must be the same on every row.
+static void benchmarkSweep(int argc, char *argv[]) {
+    int maxNumThreads = ThreadPoolClass::getNumProcessors();
+    NullStreamBufferClass nullBuffer;
+    IntersectionSimulationClass simObj;
+
+    if (argc < 4) {
+        cout << "The sweep benchmark needs a parameter file and a sweep file" <<
+                endl;
+        return;
+    }
+    for (int i = 4; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--max-threads") {
+            maxNumThreads = atoi(argv[i + 1]);
+        }
+    }
+    if (maxNumThreads <= 0) {
+        cout << "The sweep benchmark needs a positive --max-threads value" <<
+                endl;
+        return;
+    }
+
+    streambuf *consoleBuffer = cout.rdbuf(&nullBuffer);
+    simObj.readParametersFromFile(argv[2]);
+    cout.rdbuf(consoleBuffer);
+    if (!simObj.getIsSetupProperly()) {
+        cout << "Simulation is not setup properly!" << endl;
+        return;
+    }
+    ParameterSweepClass parameterSweep(simObj);
+    if (!parameterSweep.readSweepFile(argv[3])) {
+        return;
+    }
+
+    cout << "Processors: " << ThreadPoolClass::getNumProcessors() <<
+            ", grid points: " << parameterSweep.getNumPoints() << endl;
+    cout << "threads   seconds  points/sec   speedup   steals   checksum" <<
+            endl;
+    double oneThreadSeconds = -1;
+    int numThreads = 1;
+    while (true) {
+        ThreadPoolClass threadPool(numThreads);
+        double startTime = getWallSeconds();
+        parameterSweep.run(threadPool);
+        double elapsed = getWallSeconds() - startTime;
+        if (oneThreadSeconds < 0) {
+            oneThreadSeconds = elapsed;
+        }
+
+        long checksum = 0;
+        for (int pointIdx = 0; pointIdx < parameterSweep.getNumPoints();
+             pointIdx++) {
+            const SimulationResultStruct &result =
+                                   parameterSweep.getResult(pointIdx);
+            for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                checksum += (pointIdx + 1) * (result.maxQueueLengths[dirIdx] +
+                                              result.numAdvanced[dirIdx]);
+            }
+        }
+        cout << setw(7) << numThreads << fixed << setprecision(3) <<
+                setw(10) << elapsed << setprecision(0) << setw(12) <<
+                parameterSweep.getNumPoints() / elapsed << setprecision(2) <<
+                setw(10) << oneThreadSeconds / elapsed << setw(9) <<
+                threadPool.getNumSteals() << setw(11) << checksum << endl;
+
+        if (numThreads >= maxNumThreads) {
+            break;
+        }
+        numThreads = (numThreads * 2 > maxNumThreads) ?
+                     maxNumThreads : numThreads * 2;
+    }
+}
+
+//Draws --samples values (10^7 by default) from each distribution the
+//simulation uses, with the generator in each mode, and reports the time
+//per sample and the sample mean (the normal draws use the mean and
+//standard deviation of an arrival interval, 20 and 5).  Then draws the
+//same number of inter-arrival times from an ArrivalGeneratorClass with
+//each refill kernel the processor supports; their checksums must agree.
+static void benchmarkRandom(int argc, char *argv[]) {
+    const int NUM_MODES = 2;
+    const int MODES[NUM_MODES] = {
+        RANDOM_MODE_RAND_COMPAT, RANDOM_MODE_PHILOX
+    };
+    const string MODE_NAMES[NUM_MODES] = { "compat", "philox" };
+    int numSamples = 10000000;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--samples") {
+            numSamples = atoi(argv[i + 1]);
+        }
+    }
+    if (numSamples <= 0) {
+        cout << "The rng benchmark needs a positive --samples value" << endl;
+        return;
+    }
+
+    cout << "mode    distribution   ns/sample        mean" << endl;
+    for (int modeIdx = 0; modeIdx < NUM_MODES; modeIdx++) {
+        RandomGeneratorClass randomGenerator(12345);
+        randomGenerator.setMode(MODES[modeIdx]);
+
+        long sum = 0;
+        double startTime = getWallSeconds();
+        for (int i = 0; i < numSamples; i++) {
+            sum += randomGenerator.getPositiveNormal(20, 5);
+        }
+        double elapsed = getWallSeconds() - startTime;
+        cout << setw(8) << left << MODE_NAMES[modeIdx] << setw(15) <<
+                "normal" << right << fixed << setprecision(2) << setw(9) <<
+                elapsed * 1e9 / numSamples << setprecision(4) << setw(12) <<
+                double(sum) / numSamples << endl;
+
+        sum = 0;
+        startTime = getWallSeconds();
+        for (int i = 0; i < numSamples; i++) {
+            sum += randomGenerator.getUniform(1, 100);
+        }
+        elapsed = getWallSeconds() - startTime;
+        cout << setw(8) << left << MODE_NAMES[modeIdx] << setw(15) <<
+                "uniform" << right << fixed << setprecision(2) << setw(9) <<
+                elapsed * 1e9 / numSamples << setprecision(4) << setw(12) <<
+                double(sum) / numSamples << endl;
+    }
+
+    cout << endl << "kernel  arrivals       ns/sample        mean" <<
+            "              checksum" << endl;
+    const int KERNELS[] = {
+        ARRIVAL_KERNEL_SCALAR, ARRIVAL_KERNEL_SSE2, ARRIVAL_KERNEL_AVX2
+    };
+    for (int kernelIdx = 0; kernelIdx < 3; kernelIdx++) {
+        ArrivalGeneratorClass arrivalGenerator;
+        if (!arrivalGenerator.setKernel(KERNELS[kernelIdx])) {
+            cout << setw(8) << left <<
+                    ArrivalGeneratorClass::getKernelName(KERNELS[kernelIdx]) <<
+                    right << "(not supported by this processor)" << endl;
+            continue;
+        }
+        arrivalGenerator.setup(12345, 0, 1, 20, 5);
+
+        long sum = 0;
+        unsigned long checksum = 0;
+        double startTime = getWallSeconds();
+        for (int i = 0; i < numSamples; i++) {
+            int interval = arrivalGenerator.getNextInterval();
+            sum += interval;
+            checksum = checksum * 31 + (unsigned long)interval;
+        }
+        double elapsed = getWallSeconds() - startTime;
+        cout << setw(8) << left <<
+                ArrivalGeneratorClass::getKernelName(KERNELS[kernelIdx]) <<
+                setw(15) << "normal" << right << fixed << setprecision(2) <<
+                setw(9) << elapsed * 1e9 / numSamples << setprecision(4) <<
+                setw(12) << double(sum) / numSamples << setw(22) <<
+                checksum << endl;
+    }
+}
+
+//Runs the simulation described by a parameter file --runs times (3 by
+//default) with the Philox generator under each engine, and reports the
+//events handled and the best wall time.  The lazy arrival engine handles
+//only the light changes; its checksum of the statistics must match the
+//per-event engine's.
+static void benchmarkEngine(int argc, char *argv[]) {
+    const int NUM_ENGINES = 2;
+    const int ENGINES[NUM_ENGINES] = {
+        ENGINE_PER_EVENT, ENGINE_LAZY_ARRIVALS
+    };
+    const string ENGINE_NAMES[NUM_ENGINES] = { "event", "lazy" };
+    NullStreamBufferClass nullBuffer;
+    IntersectionSimulationClass baseSim;
+    int numRuns = 3;
+
+    if (argc < 3) {
+        cout << "The engine benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--runs") {
+            numRuns = atoi(argv[i + 1]);
+        }
+    }
+    if (numRuns <= 0) {
+        cout << "The engine benchmark needs a positive --runs value" << endl;
+        return;
+    }
+
+    streambuf *consoleBuffer = cout.rdbuf(&nullBuffer);
+    baseSim.setRandomMode(RANDOM_MODE_PHILOX);
+    baseSim.readParametersFromFile(argv[2]);
+    cout.rdbuf(consoleBuffer);
+    if (!baseSim.getIsSetupProperly()) {
+        cout << "Simulation is not setup properly!" << endl;
+        return;
+    }
+    baseSim.setVerbosityLevel(VERBOSITY_SILENT);
+
+    cout << "engine      events   seconds   speedup              checksum" <<
+            endl;
+    double perEventSeconds = -1;
+    for (int engineIdx = 0; engineIdx < NUM_ENGINES; engineIdx++) {
+        double bestSeconds = -1;
+        long numEvents = 0;
+        long checksum = 0;
+
+        for (int runIdx = 0; runIdx < numRuns; runIdx++) {
+            IntersectionSimulationClass simObj(baseSim);
+            SimulationResultStruct result;
+
+            simObj.setEngineMode(ENGINES[engineIdx]);
+            double startTime = getWallSeconds();
+            simObj.scheduleSeedEvents();
+            numEvents = 0;
+            while (simObj.handleNextEvent()) {
+                numEvents++;
+            }
+            double elapsed = getWallSeconds() - startTime;
+            if (bestSeconds < 0 || elapsed < bestSeconds) {
+                bestSeconds = elapsed;
+            }
+
+            simObj.getResults(result);
+            checksum = 0;
+            for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                checksum = checksum * 31 + result.maxQueueLengths[dirIdx];
+                checksum = checksum * 31 + result.numAdvanced[dirIdx];
+            }
+        }
+        if (perEventSeconds < 0) {
+            perEventSeconds = bestSeconds;
+        }
+
+        cout << setw(6) << left << ENGINE_NAMES[engineIdx] << right <<
+                setw(12) << numEvents << fixed << setprecision(4) <<
+                setw(10) << bestSeconds << setprecision(2) << setw(10) <<
+                perEventSeconds / bestSeconds << setw(22) << checksum << endl;
+    }
+}
+
+//Runs grids of 1000, 10000 and 100000 intersections (up to
+//--max-intersections) built from the simulation described by a parameter
+//file, with links of --travel-time (10 by default), on thread pools of 1,
+//2, 4, ... threads up to the number of processors (or --max-threads),
+//with conservative and then optimistic synchronization (running up to
+//--optimism-window past GVT).  Reports the windows or rounds taken, the
+//events rolled back, the wall time and speedup over conservative
+//synchronization on one thread for each; the checksum of the statistics
+//must be the same on every row for a grid.
+static void benchmarkNetwork(int argc, char *argv[]) {
+    const int NUM_GRIDS = 3;
+    const int GRID_ROWS[NUM_GRIDS] = { 25, 100, 250 };
+    const int GRID_COLS[NUM_GRIDS] = { 40, 100, 400 };
+    const int NUM_SYNC_MODES = 2;
+    const string SYNC_NAMES[NUM_SYNC_MODES] = { "cons", "opt" };
+    int maxNumThreads = ThreadPoolClass::getNumProcessors();
+    int maxNumIntersections = 100000;
+    int travelTime = NETWORK_DEFAULT_TRAVEL_TIME;
+    int optimismWindow = NETWORK_DEFAULT_OPTIMISM_WINDOW;
+    NullStreamBufferClass nullBuffer;
+    IntersectionSimulationClass simObj;
+
+    if (argc < 3) {
+        cout << "The network benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--max-threads") {
+            maxNumThreads = atoi(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--max-intersections") {
+            maxNumIntersections = atoi(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--travel-time") {
+            travelTime = atoi(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--optimism-window") {
+            optimismWindow = atoi(argv[i + 1]);
+        }
+    }
+    if (maxNumThreads <= 0 || travelTime <= 0 || optimismWindow <= 0) {
+        cout << "The network benchmark needs positive --max-threads," <<
+                " --travel-time and --optimism-window values" << endl;
+        return;
+    }
+
+    streambuf *consoleBuffer = cout.rdbuf(&nullBuffer);
+    simObj.readParametersFromFile(argv[2]);
+    cout.rdbuf(consoleBuffer);
+    if (!simObj.getIsSetupProperly()) {
+        cout << "Simulation is not setup properly!" << endl;
+        return;
+    }
+
+    cout << "Processors: " << ThreadPoolClass::getNumProcessors() <<
+            ", link travel time: " << travelTime << ", optimism window: " <<
+            optimismWindow << endl;
+    cout << "intersections threads sync  rounds rolled back   seconds" <<
+            "  speedup   checksum" << endl;
+    for (int gridIdx = 0; gridIdx < NUM_GRIDS; gridIdx++) {
+        int numIntersections = GRID_ROWS[gridIdx] * GRID_COLS[gridIdx];
+        if (numIntersections > maxNumIntersections) {
+            break;
+        }
+
+        double oneThreadSeconds = -1;
+        for (int syncMode = 0; syncMode < NUM_SYNC_MODES; syncMode++) {
+            int numThreads = 1;
+            while (true) {
+                ThreadPoolClass threadPool(numThreads);
+                NetworkSimulationClass networkSim(simObj, GRID_ROWS[gridIdx],
+                                                  GRID_COLS[gridIdx],
+                                                  travelTime, syncMode,
+                                                  optimismWindow);
+                double startTime = getWallSeconds();
+                networkSim.run(threadPool);
+                double elapsed = getWallSeconds() - startTime;
+                if (oneThreadSeconds < 0) {
+                    oneThreadSeconds = elapsed;
+                }
+
+                long checksum = 0;
+                for (int intersectionIdx = 0;
+                     intersectionIdx < numIntersections; intersectionIdx++) {
+                    const IntersectionSimulationClass &intersection =
+                              networkSim.getIntersection(intersectionIdx);
+                    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                        unsigned char dirCode = (unsigned char)dirIdx;
+                        checksum += (intersectionIdx % 1000 + 1) *
+                                    (intersection.getMaxQueueLength(dirCode) +
+                                     intersection.getNumTotalAdvanced(
+                                                  dirCode));
+                    }
+                }
+                cout << setw(13) << numIntersections << setw(8) <<
+                        numThreads << " " << setw(4) << left <<
+                        SYNC_NAMES[syncMode] << right << setw(8) <<
+                        networkSim.getNumWindows() << setw(12) <<
+                        networkSim.getNumRolledBack() << fixed <<
+                        setprecision(3) << setw(10) << elapsed <<
+                        setprecision(2) << setw(9) <<
+                        oneThreadSeconds / elapsed << setw(11) << checksum <<
+                        endl;
+
+                if (numThreads >= maxNumThreads) {
+                    break;
+                }
+                numThreads = (numThreads * 2 > maxNumThreads) ?
+                             maxNumThreads : numThreads * 2;
+            }
+        }
+    }
+}
+
+//Runs the simulation described by a parameter file --runs times (3 by
+//default) silently, without and with delay tracking, and reports the best
+//rate in events handled per second, the memory taken by the delay
+//histograms and the delay percentiles of the east-bound approach.
+static void benchmarkDelays(int argc, char *argv[]) {
+    int numRuns = 3;
+
+    if (argc < 3) {
+        cout << "The delays benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--runs") {
+            numRuns = atoi(argv[i + 1]);
+        }
+    }
+
+    cout << "delays      events     events/sec  histogram bytes" << endl;
+    for (int trackingIdx = 0; trackingIdx < 2; trackingIdx++) {
+        bool isTracking = (trackingIdx == 1);
+        double bestSeconds = -1;
+        long numEvents = 0;
+        long numHistogramBytes = 0;
+        LogHistogramClass eastDelays;
+
+        for (int runIdx = 0; runIdx < numRuns; runIdx++) {
+            IntersectionSimulationClass simObj;
+
+            simObj.setVerbosityLevel(VERBOSITY_SILENT);
+            simObj.setIsDelayTrackingEnabled(isTracking);
+            simObj.readParametersFromFile(argv[2]);
+            if (!simObj.getIsSetupProperly()) {
+                cout << "Simulation is not setup properly!" << endl;
+                return;
+            }
+
+            double startTime = getWallSeconds();
+            simObj.scheduleSeedEvents();
+            numEvents = 0;
+            while (simObj.handleNextEvent()) {
+                numEvents++;
+            }
+            double elapsed = getWallSeconds() - startTime;
+
+            if (bestSeconds < 0 || elapsed < bestSeconds) {
+                bestSeconds = elapsed;
+            }
+            numHistogramBytes = 0;
+            for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                numHistogramBytes += simObj.getDelayHistogram(
+                              (unsigned char)dirIdx).getNumBytesAllocated();
+            }
+            eastDelays = simObj.getDelayHistogram(DIR_CODE_EAST);
+        }
+
+        cout << setw(6) << left << (isTracking ? "on" : "off") << right <<
+                setw(11) << numEvents << setw(15) << fixed <<
+                setprecision(0) << numEvents / bestSeconds << setw(17) <<
+                numHistogramBytes << endl;
+        if (isTracking) {
+            cout << "East-bound delays - ";
+            eastDelays.printSummary();
+        }
+    }
+}
+
+//Runs the simulation described by a parameter file silently up to
+//--fork-time (half its end time by default), then makes --branches (100 by
+//default) what-if branches of it, first as full copies and then by
+//forking, and reports the time and heap bytes each takes beyond the
+//simulation objects themselves.  The forked branches are then run to the
+//end with their east-west green time changed by -5 to +5 ticks, in turn;
+//the first keeps it, and must match the original run.
+static void benchmarkFork(int argc, char *argv[]) {
+    int numBranches = 100;
+    int forkTime = -1;
+
+    if (argc < 3) {
+        cout << "The fork benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--branches") {
+            numBranches = atoi(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--fork-time") {
+            forkTime = atoi(argv[i + 1]);
+        }
+    }
+    if (numBranches < 1) {
+        numBranches = 1;
+    }
+
+    IntersectionSimulationClass baseSim;
+    baseSim.setVerbosityLevel(VERBOSITY_SILENT);
+    baseSim.readParametersFromFile(argv[2]);
+    if (!baseSim.getIsSetupProperly()) {
+        cout << "Simulation is not setup properly!" << endl;
+        return;
+    }
+    if (forkTime < 0) {
+        forkTime = baseSim.getTimeToStopSim() / 2;
+    }
+
+    baseSim.scheduleSeedEvents();
+    bool isRunning = true;
+    while (isRunning && baseSim.getCurrentTime() < forkTime) {
+        isRunning = baseSim.handleNextEvent();
+    }
+    if (!isRunning) {
+        cout << "The run ended before the fork time" << endl;
+        return;
+    }
+    cout << "Forking at time " << baseSim.getCurrentTime() << " into " <<
+            numBranches << " branches" << endl;
+    cout << "method    seconds/branch  bytes/branch" << endl;
+
+    //Full copies first, while the queues still have only their own cars
+    for (int methodIdx = 0; methodIdx < 2; methodIdx++) {
+        bool isForked = (methodIdx == 1);
+        //The list of branches is kept off the counted heap
+        IntersectionSimulationClass **branches =
+                     (IntersectionSimulationClass **)malloc(numBranches *
+                                   sizeof(IntersectionSimulationClass *));
+        for (int branchIdx = 0; branchIdx < numBranches; branchIdx++) {
+            branches[branchIdx] = new IntersectionSimulationClass;
+        }
+        long startBytes = numLiveHeapBytes;
+        double startTime = getWallSeconds();
+
+        for (int branchIdx = 0; branchIdx < numBranches; branchIdx++) {
+            if (isForked) {
+                baseSim.forkInto(*branches[branchIdx]);
+            }
+            else {
+                *branches[branchIdx] = baseSim;
+            }
+        }
+        double elapsed = getWallSeconds() - startTime;
+        long numBytes = numLiveHeapBytes - startBytes;
+
+        cout << setw(8) << left << (isForked ? "fork" : "copy") << right <<
+                setw(16) << scientific << setprecision(2) <<
+                elapsed / numBranches << setw(14) <<
+                numBytes / numBranches << endl;
+
+        if (isForked) {
+            int eastWestGreenTime;
+            int eastWestYellowTime;
+            int northSouthGreenTime;
+            int northSouthYellowTime;
+            baseSim.getLightTimes(eastWestGreenTime, eastWestYellowTime,
+                                  northSouthGreenTime, northSouthYellowTime);
+
+            cout << "EW green  cars advanced  longest EW queue" << endl;
+            startTime = getWallSeconds();
+            for (int branchIdx = 0; branchIdx < numBranches; branchIdx++) {
+                IntersectionSimulationClass &branch = *branches[branchIdx];
+                int greenChange = (branchIdx + 5) % 11 - 5;
+                if (eastWestGreenTime + greenChange < 1) {
+                    greenChange = 0;
+                }
+                branch.setLightTimes(eastWestGreenTime + greenChange,
+                                     eastWestYellowTime,
+                                     northSouthGreenTime,
+                                     northSouthYellowTime);
+                while (branch.handleNextEvent()) {
+                }
+                if (branchIdx < 11) {
+                    int numAdvanced = 0;
+                    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                        numAdvanced += branch.getNumTotalAdvanced(
+                                              (unsigned char)dirIdx);
+                    }
+                    int maxEastWestQueue = branch.getMaxQueueLength(
+                                                  DIR_CODE_EAST);
+                    if (branch.getMaxQueueLength(DIR_CODE_WEST) >
+                        maxEastWestQueue) {
+                        maxEastWestQueue = branch.getMaxQueueLength(
+                                                  DIR_CODE_WEST);
+                    }
+                    cout << setw(8) << eastWestGreenTime + greenChange <<
+                            setw(16) << numAdvanced << setw(18) <<
+                            maxEastWestQueue << endl;
+                }
+            }
+            elapsed = getWallSeconds() - startTime;
+            cout << "Ran " << numBranches << " branches to the end in " <<
+                    fixed << setprecision(3) << elapsed << " s" << endl;
+
+            //The unchanged branch must end exactly where the original does
+            while (baseSim.handleNextEvent()) {
+            }
+            SimulationResultStruct baseResults;
+            SimulationResultStruct branchResults;
+            baseSim.getResults(baseResults);
+            branches[0]->getResults(branchResults);
+            bool isMatching = true;
+            for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+                if (baseResults.maxQueueLengths[dirIdx] !=
+                    branchResults.maxQueueLengths[dirIdx] ||
+                    baseResults.numAdvanced[dirIdx] !=
+                    branchResults.numAdvanced[dirIdx]) {
+                    isMatching = false;
+                }
+            }
+            cout << "Unchanged branch matches the original run: " <<
+                    (isMatching ? "yes" : "NO") << endl;
+        }
+        for (int branchIdx = 0; branchIdx < numBranches; branchIdx++) {
+            delete branches[branchIdx];
+        }
+        free(branches);
+    }
+}
+
+//Returns the sum over the approaches of the time-weighted mean queue
+//lengths in one run's results.
+static double getTotalMeanQueueLength(const SimulationResultStruct &result) {
+    double totalLength = 0;
+
+    for (int dirIdx = 0; dirIdx < NUM_DIRECTIONS; dirIdx++) {
+        totalLength += result.meanQueueLengths[dirIdx];
+    }
+    return totalLength;
+}
+
+//Runs --replications replications (40 by default, rounded up to an even
+//number) of the simulation described by a parameter file with the Philox
+//generator, and of the same setup with its east-west green time changed
+//by --green-change ticks (2 by default), and estimates how much the total
+//time-weighted mean queue length changes: with independent seeds for the
+//two setups, with common random numbers, and with common random numbers
+//in antithetic pairs.  Reports the wall time, the mean change and the
+//variance of the change per replication for each, and the replications
+//each needs for the same precision as independent seeds.  The mean
+//changes must agree to within their noise.
+static void benchmarkVariance(int argc, char *argv[]) {
+    int numReplications = 40;
+    int greenChange = 2;
+    IntersectionSimulationClass baseSim;
+    IntersectionSimulationClass changedSim;
+
+    if (argc < 3) {
+        cout << "The variance benchmark needs a parameter file" << endl;
+        return;
+    }
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "--replications") {
+            numReplications = atoi(argv[i + 1]);
+        }
+        else if (string(argv[i]) == "--green-change") {
+            greenChange = atoi(argv[i + 1]);
+        }
+    }
+    if (numReplications < 2) {
+        numReplications = 2;
+    }
+    numReplications += numReplications % 2;
+
+    baseSim.setVerbosityLevel(VERBOSITY_SILENT);
+    baseSim.setRandomMode(RANDOM_MODE_PHILOX);
+    baseSim.readParametersFromFile(argv[2]);
+    if (!baseSim.getIsSetupProperly()) {
+        cout << "Simulation is not setup properly!" << endl;
+        return;
+    }
+    int eastWestGreenTime;
+    int eastWestYellowTime;
+    int northSouthGreenTime;
+    int northSouthYellowTime;
+    baseSim.getLightTimes(eastWestGreenTime, eastWestYellowTime,
+                          northSouthGreenTime, northSouthYellowTime);
+    changedSim = baseSim;
+    if (!changedSim.setLightTimes(eastWestGreenTime + greenChange,
+                                  eastWestYellowTime, northSouthGreenTime,
+                                  northSouthYellowTime)) {
+        cout << "The changed east-west green time is not valid" << endl;
+        return;
+    }
+
+    ThreadPoolClass threadPool(ThreadPoolClass::getNumProcessors());
+    cout << "Replications: " << numReplications << ", east-west green " <<
+            eastWestGreenTime << " -> " << eastWestGreenTime + greenChange <<
+            endl;
+    cout << "seeds                seconds  mean change  variance" <<
+            "  replications" << endl;
+    double independentVariance = -1;
+    for (int modeIdx = 0; modeIdx < 3; modeIdx++) {
+        //The independent setups' seeds don't overlap; the others share
+        //them
+        IntersectionSimulationClass independentSim(changedSim);
+        independentSim.setRandomSeed(baseSim.getRandomSeed() +
+                                     numReplications);
+        ReplicationRunnerClass baseRunner(baseSim, numReplications);
+        ReplicationRunnerClass changedRunner(independentSim, numReplications);
+        int numPerSample = (modeIdx == 2) ? 2 : 1;
+        StatAccumulatorClass changeStats;
+
+        double startTime = getWallSeconds();
+        if (modeIdx == 0) {
+            baseRunner.run(threadPool);
+            changedRunner.run(threadPool);
+        }
+        else {
+            baseRunner.setComparisonSim(changedSim);
+            baseRunner.setIsAntitheticPairs(modeIdx == 2);
+            baseRunner.run(threadPool);
+        }
+        double elapsed = getWallSeconds() - startTime;
+
+        for (int sampleIdx = 0; sampleIdx < numReplications / numPerSample;
+             sampleIdx++) {
+            double changeSum = 0;
+            for (int repIdx = sampleIdx * numPerSample;
+                 repIdx < (sampleIdx + 1) * numPerSample; repIdx++) {
+                const SimulationResultStruct &changedResult =
+                          (modeIdx == 0) ? changedRunner.getResult(repIdx) :
+                                      baseRunner.getComparisonResult(repIdx);
+                changeSum += getTotalMeanQueueLength(changedResult) -
+                             getTotalMeanQueueLength(
+                                       baseRunner.getResult(repIdx));
+            }
+            changeStats.addValue(changeSum / numPerSample);
+        }
+        //The variance one replication of the setups contributes
+        double variance = changeStats.getVariance() * numPerSample;
+        if (independentVariance < 0) {
+            independentVariance = variance;
+        }
+
+        const char *MODE_NAMES[3] = {
+            "independent", "common", "common+antithetic"
+        };
+        cout << setw(17) << left << MODE_NAMES[modeIdx] << right <<
+                fixed << setprecision(3) << setw(12) << elapsed <<
+                setprecision(4) << setw(13) << changeStats.getMean() <<
+                scientific << setprecision(2) << setw(10) << variance;
+        if (independentVariance > 0) {
+            cout << fixed << setprecision(1) << setw(13) <<
+                    100 * variance / independentVariance << "%";
+        }
+        cout << endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    string benchName;
+
+    if (argc >= 2) {
+        benchName = string(argv[1]);
+    }
+
+    if (benchName == "hold") {
+        benchmarkHoldModel(argc, argv);
+    }
+    else if (benchName == "allocs") {
+        benchmarkAllocations(argc, argv);
+    }
+    else if (benchName == "verbosity") {
+        benchmarkVerbosity(argc, argv);
+    }
+    else if (benchName == "carmem") {
+        benchmarkCarMemory(argc, argv);
+    }
+    else if (benchName == "replicate") {
+        benchmarkReplications(argc, argv);
+    }
+    else if (benchName == "sweep") {
+        benchmarkSweep(argc, argv);
+    }
+    else if (benchName == "rng") {
+        benchmarkRandom(argc, argv);
+    }
+    else if (benchName == "engine") {
+        benchmarkEngine(argc, argv);
+    }
+    else if (benchName == "network") {
+        benchmarkNetwork(argc, argv);
+    }
+    else if (benchName == "delays") {
+        benchmarkDelays(argc, argv);
+    }
+    else if (benchName == "fork") {
+        benchmarkFork(argc, argv);
+    }
+    else if (benchName == "variance") {
+        benchmarkVariance(argc, argv);
+    }
+    else {
+        cout << "Usage: " << argv[0] << " <benchmark> [options]" << endl;
+        cout << "  hold [--ops N] [--sorted-list-max N]" << endl;
+        cout << "      event list containers under the hold model" << endl;
+        cout << "  allocs <parameterFile> [--warmup N]" << endl;
+        cout << "      heap allocations per event in a simulation run" << endl;
+        cout << "  verbosity <parameterFile> [--runs N]" << endl;
+        cout << "      events per second at each verbosity level" << endl;
+        cout << "  carmem [--cars N]" << endl;
+        cout << "      memory footprint of queued cars in each layout" << endl;
+        cout << "  replicate <parameterFile> [--replications N]" <<
+                " [--max-threads N]" << endl;
+        cout << "      replication throughput from 1 thread to all cores" <<
+                endl;
+        cout << "  sweep <parameterFile> <sweepFile> [--max-threads N]" <<
+                endl;
+        cout << "      parameter sweep throughput from 1 thread to all cores" <<
+                endl;
+        cout << "  rng [--samples N]" << endl;
+        cout << "      random value sampling speed in each generator mode" <<
+                endl;
+        cout << "  engine <parameterFile> [--runs N]" << endl;
+        cout << "      events handled and run time of each simulation engine" <<
+                endl;
+        cout << "  network <parameterFile> [--travel-time T]" <<
+                " [--optimism-window T] [--max-intersections N]" <<
+                " [--max-threads N]" << endl;
+        cout << "      conservative and optimistic network throughput for" <<
+                " 1k-100k intersections" << endl;
+        cout << "  delays <parameterFile> [--runs N]" << endl;
+        cout << "      events per second without and with delay tracking" <<
+                endl;
+        cout << "  fork <parameterFile> [--branches N] [--fork-time T]" <<
+                endl;
+        cout << "      cost of copying and forking a running simulation" <<
+                endl;
+        cout << "  variance <parameterFile> [--replications N]" <<
+                " [--green-change T]" << endl;
+        cout << "      replications needed to compare light times with" <<
+                " and without common random numbers" << endl;
+        return 1;
+    }
+
+    return 0;
+}
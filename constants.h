@@ -18,6 +18,12 @@ const int EVENT_CHANGE_GREEN_EW = 4;
 const int EVENT_CHANGE_YELLOW_EW = 5;
 const int EVENT_CHANGE_GREEN_NS = 6;
 const int EVENT_CHANGE_YELLOW_NS = 7;
+//A car from a linked intersection joining an approach's queue (only in a
+//network of intersections); in the same direction order as the arrivals
+const int EVENT_ENTER_EAST = 8;
+const int EVENT_ENTER_WEST = 9;
+const int EVENT_ENTER_NORTH = 10;
+const int EVENT_ENTER_SOUTH = 11;
 
 //Uniform generator constants
 const int UNIF_LOWER_BOUND = 0;
@@ -32,10 +38,33 @@ const std::string WEST_DIRECTION = "West";
 const std::string NORTH_DIRECTION = "North";
 const std::string SOUTH_DIRECTION = "South";
 
+//Compact direction codes, so a car can store its travel direction in a
+//single byte instead of a string
+const unsigned char DIR_CODE_EAST = 0;
+const unsigned char DIR_CODE_WEST = 1;
+const unsigned char DIR_CODE_NORTH = 2;
+const unsigned char DIR_CODE_SOUTH = 3;
+const unsigned char DIR_CODE_NOT_SET = 255;
+const int NUM_DIRECTIONS = 4;
+
 //Traffic light state constants
 const int LIGHT_GREEN_EW = 1;
 const int LIGHT_YELLOW_EW = 2;
 const int LIGHT_GREEN_NS = 3;
 const int LIGHT_YELLOW_NS = 4;
 
+//Verbosity levels, controlling how much the simulation writes to the
+//console: nothing but errors, the statistics at the end of the run, or
+//a full trace of every event as well
+const int VERBOSITY_SILENT = 0;
+const int VERBOSITY_STATS = 1;
+const int VERBOSITY_TRACE = 2;
+
+//Ways the simulation can advance: one event per car arrival and light
+//change, or one event per light change, with each approach's arrivals up
+//to it generated in a batch when it is handled (which needs the Philox
+//random generator, whose arrival streams don't depend on event order)
+const int ENGINE_PER_EVENT = 0;
+const int ENGINE_LAZY_ARRIVALS = 1;
+
 #endif //_CONSTANTS_H_
@@ -1,8 +1,17 @@
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <sstream>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
 using namespace std;
 
 #include "IntersectionSimulationClass.h"
+#include "ReplicationRunnerClass.h"
+#include "ParameterSweepClass.h"
+#include "NetworkSimulationClass.h"
+#include "ThreadPoolClass.h"
 
 //Programmer: Andrew Morgan
 //Date: November 2020
@@ -10,59 +19,630 @@ using namespace std;
 //         flow through an intersection.  This is being written to
 //         implement project 5 in EECS402.
 
+//Reads a whole number given on the command line into outVal, returning
+//false if the argument isn't one (e.g. "abc" or "4x") or doesn't fit in
+//an int, leaving outVal unchanged.
+static bool getIntFromArg(const char *argText, int &outVal) {
+    char *endPtr = 0;
+    long argVal;
+
+    errno = 0;
+    argVal = strtol(argText, &endPtr, 10);
+    if (endPtr == argText || *endPtr != '\0' || errno == ERANGE ||
+        argVal < INT_MIN || argVal > INT_MAX) {
+        return false;
+    }
+    outVal = (int)argVal;
+    return true;
+}
+
+//Reads a number given on the command line into outVal, returning false
+//if the argument isn't one (e.g. "5%"), leaving outVal unchanged.
+static bool getDoubleFromArg(const char *argText, double &outVal) {
+    char *endPtr = 0;
+    double argVal;
+
+    errno = 0;
+    argVal = strtod(argText, &endPtr);
+    if (endPtr == argText || *endPtr != '\0' || errno == ERANGE) {
+        return false;
+    }
+    outVal = argVal;
+    return true;
+}
+
+//Converts a verbosity name given on the command line ("silent", "stats"
+//or "trace") to its VERBOSITY_* value.  Returns false if the name is not
+//recognized, leaving outLevel unchanged.
+static bool getVerbosityFromName(const string &levelName, int &outLevel) {
+    if (levelName == "silent") {
+        outLevel = VERBOSITY_SILENT;
+    }
+    else if (levelName == "stats") {
+        outLevel = VERBOSITY_STATS;
+    }
+    else if (levelName == "trace") {
+        outLevel = VERBOSITY_TRACE;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+//Runs numReplications replications of the simulation set up in simObj
+//(seeds counting up from the one in the parameter file) on numThreads
+//threads, and prints a summary of their statistics.  With a target
+//precision, numReplications is the most to run: they run batchSize at a
+//time until their confidence intervals are that narrow.  Each replication
+//is also run with the setup in comparisonSim, if there is one, and the
+//replications run in antithetic pairs if isAntitheticPairs.
+static void runReplications(const IntersectionSimulationClass &simObj,
+                            const int numReplications, const int numThreads,
+                            const double targetPrecision,
+                            const int batchSize,
+                            const IntersectionSimulationClass *comparisonSim,
+                            const bool isAntitheticPairs,
+                            const int verbosityLevel) {
+    ThreadPoolClass threadPool(numThreads);
+    ReplicationRunnerClass replicationRunner(simObj, numReplications);
+
+    if (comparisonSim != 0) {
+        replicationRunner.setComparisonSim(*comparisonSim);
+    }
+    replicationRunner.setIsAntitheticPairs(isAntitheticPairs);
+
+    if (verbosityLevel >= VERBOSITY_TRACE) {
+        cout << endl;
+        if (targetPrecision > 0) {
+            cout << "Running up to " << numReplications <<
+                    " replications, " << batchSize << " at a time, on " <<
+                    threadPool.getNumThreads() << " thread(s)" << endl;
+        }
+        else {
+            cout << "Running " << numReplications << " replications on " <<
+                    threadPool.getNumThreads() << " thread(s)" << endl;
+        }
+    }
+    if (targetPrecision > 0) {
+        replicationRunner.runSequential(threadPool, targetPrecision,
+                                        batchSize);
+    }
+    else {
+        replicationRunner.run(threadPool);
+    }
+
+    if (verbosityLevel >= VERBOSITY_STATS) {
+        cout << "Replications ran successfully!" << endl;
+        replicationRunner.printStatistics();
+    }
+}
+
+//Sets randomMode to the RANDOM_MODE_* value named by rngName ("compat" or
+//"philox"), returning false if the name is not recognized.
+static bool getRandomModeFromName(const string &rngName, int &randomMode) {
+    if (rngName == "compat") {
+        randomMode = RANDOM_MODE_RAND_COMPAT;
+    }
+    else if (rngName == "philox") {
+        randomMode = RANDOM_MODE_PHILOX;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+//Sets engineMode to the ENGINE_* value named by engineName ("event" or
+//"lazy"), returning false if the name is not recognized.
+static bool getEngineModeFromName(const string &engineName, int &engineMode) {
+    if (engineName == "event") {
+        engineMode = ENGINE_PER_EVENT;
+    }
+    else if (engineName == "lazy") {
+        engineMode = ENGINE_LAZY_ARRIVALS;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+//Sets syncMode to the NETWORK_SYNC_* value named by syncName
+//("conservative" or "optimistic"), returning false if the name is not
+//recognized.
+static bool getSyncModeFromName(const string &syncName, int &syncMode) {
+    if (syncName == "conservative") {
+        syncMode = NETWORK_SYNC_CONSERVATIVE;
+    }
+    else if (syncName == "optimistic") {
+        syncMode = NETWORK_SYNC_OPTIMISTIC;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+//Runs the simulation set up in simObj at every point of the grid
+//described by the sweep file on numThreads threads, and writes the
+//statistics of each point to a CSV file.  Returns false if the sweep file
+//can't be read or the CSV file can't be created.
+static bool runSweep(const IntersectionSimulationClass &simObj,
+                     const string &sweepFname, const string &csvFname,
+                     const int numThreads, const int verbosityLevel) {
+    ParameterSweepClass parameterSweep(simObj);
+
+    if (!parameterSweep.readSweepFile(sweepFname)) {
+        return false;
+    }
+    ofstream csvF(csvFname.c_str());
+    if (csvF.fail()) {
+        cout << "Unable to create CSV file: " << csvFname << endl;
+        return false;
+    }
+
+    ThreadPoolClass threadPool(numThreads);
+    if (verbosityLevel >= VERBOSITY_TRACE) {
+        cout << endl;
+        cout << "Running " << parameterSweep.getNumPoints() <<
+                " sweep points on " << threadPool.getNumThreads() <<
+                " thread(s)" << endl;
+    }
+    parameterSweep.run(threadPool);
+    parameterSweep.writeCsv(csvF);
+    csvF.close();
+
+    if (verbosityLevel >= VERBOSITY_STATS) {
+        cout << "Sweep ran successfully! Wrote " <<
+                parameterSweep.getNumPoints() << " points to " << csvFname <<
+                endl;
+    }
+    return true;
+}
+
+//Reads a grid size given on the command line as "<rows>x<columns>",
+//returning false unless both are positive and the grid isn't larger than
+//NETWORK_MAX_NUM_INTERSECTIONS.
+static bool getGridSizeFromName(const string &sizeName, int &numRows,
+                                int &numCols) {
+    istringstream sizeStream(sizeName);
+    char separator = ' ';
+    string leftOver;
+
+    if (!(sizeStream >> numRows >> separator >> numCols) ||
+        separator != 'x' || (sizeStream >> leftOver) ||
+        numRows < 1 || numCols < 1) {
+        return false;
+    }
+    return (long)numRows * numCols <= NETWORK_MAX_NUM_INTERSECTIONS;
+}
+
+//Runs a grid of copies of the simulation set up in simObj, linked by
+//roads taking travelTime to drive, on numThreads threads, keeping the
+//intersections in step with the given NETWORK_SYNC_* mode, and prints the
+//statistics of the network.
+static void runNetwork(const IntersectionSimulationClass &simObj,
+                       const int numRows, const int numCols,
+                       const int travelTime, const int syncMode,
+                       const int optimismWindow, const int numThreads,
+                       const int verbosityLevel) {
+    ThreadPoolClass threadPool(numThreads);
+    NetworkSimulationClass networkSim(simObj, numRows, numCols, travelTime,
+                                      syncMode, optimismWindow);
+
+    if (verbosityLevel >= VERBOSITY_TRACE) {
+        cout << endl;
+        cout << "Running a " << numRows << " x " << numCols <<
+                " network on " << threadPool.getNumThreads() <<
+                " thread(s)" << endl;
+    }
+    networkSim.run(threadPool);
+
+    if (verbosityLevel >= VERBOSITY_STATS) {
+        cout << "Network ran successfully!" << endl;
+        networkSim.printStatistics();
+    }
+}
+
 int main(int argc, char *argv[]) {
     bool success = true;
     string specifiedParamFname;
+    string binaryTraceFname;
+    string sweepFname;
+    string csvFname;
+    string saveSnapshotFname;
+    string restoreSnapshotFname;
+    string compareParamFname;
+    int snapshotTime = -1;
+    double targetPercent = 0;
+    int verbosityLevel = VERBOSITY_TRACE;
+    int randomMode = RANDOM_MODE_RAND_COMPAT;
+    int engineMode = ENGINE_PER_EVENT;
+    bool isFastForwardEnabled = false;
+    bool isDelayTrackingEnabled = false;
+    bool isQueueStatsPrinted = false;
+    bool isAntitheticPairs = false;
+    int numNetworkRows = 0;
+    int numNetworkCols = 0;
+    int travelTime = 0;
+    int syncMode = NETWORK_SYNC_CONSERVATIVE;
+    int optimismWindow = 0;
+    int numReplications = 0;
+    int replicationBatchSize = 0;
+    int numThreads = ThreadPoolClass::getNumProcessors();
     IntersectionSimulationClass simObj;
+    IntersectionSimulationClass compareSimObj;
 
-    //Check that user specified the necessary command line arg(s)..
-    if (argc != 2) {
-        cout << "Usage: " << argv[0] << " <parameterFile>" << endl;
+    //Check that user specified the necessary command line arg(s), which
+    //are the parameter file followed by option name / value pairs..
+    if (argc < 2 || argc % 2 != 0) {
         success = false;
     }
     else {
         specifiedParamFname = string(argv[1]);
+        for (int argIdx = 2; success && argIdx < argc; argIdx += 2) {
+            string optionName = string(argv[argIdx]);
+            if (optionName == "--verbosity") {
+                success = getVerbosityFromName(argv[argIdx + 1],
+                                               verbosityLevel);
+            }
+            else if (optionName == "--binary-trace") {
+                binaryTraceFname = string(argv[argIdx + 1]);
+            }
+            else if (optionName == "--rng") {
+                success = getRandomModeFromName(argv[argIdx + 1], randomMode);
+            }
+            else if (optionName == "--engine") {
+                success = getEngineModeFromName(argv[argIdx + 1], engineMode);
+            }
+            else if (optionName == "--fast-forward") {
+                string switchName = string(argv[argIdx + 1]);
+                isFastForwardEnabled = (switchName == "on");
+                success = (switchName == "on" || switchName == "off");
+            }
+            else if (optionName == "--delays") {
+                string switchName = string(argv[argIdx + 1]);
+                isDelayTrackingEnabled = (switchName == "on");
+                success = (switchName == "on" || switchName == "off");
+            }
+            else if (optionName == "--queue-stats") {
+                string switchName = string(argv[argIdx + 1]);
+                isQueueStatsPrinted = (switchName == "on");
+                success = (switchName == "on" || switchName == "off");
+            }
+            else if (optionName == "--save-snapshot") {
+                saveSnapshotFname = string(argv[argIdx + 1]);
+            }
+            else if (optionName == "--snapshot-time") {
+                success = (getIntFromArg(argv[argIdx + 1], snapshotTime) &&
+                           snapshotTime >= 0);
+            }
+            else if (optionName == "--restore-snapshot") {
+                restoreSnapshotFname = string(argv[argIdx + 1]);
+            }
+            else if (optionName == "--precision") {
+                success = (getDoubleFromArg(argv[argIdx + 1], targetPercent) &&
+                           targetPercent > 0 && targetPercent < 100);
+            }
+            else if (optionName == "--network") {
+                success = getGridSizeFromName(argv[argIdx + 1],
+                                              numNetworkRows, numNetworkCols);
+            }
+            else if (optionName == "--travel-time") {
+                success = (getIntFromArg(argv[argIdx + 1], travelTime) &&
+                           travelTime > 0);
+            }
+            else if (optionName == "--sync") {
+                success = getSyncModeFromName(argv[argIdx + 1], syncMode);
+            }
+            else if (optionName == "--optimism-window") {
+                success = (getIntFromArg(argv[argIdx + 1], optimismWindow) &&
+                           optimismWindow > 0);
+            }
+            else if (optionName == "--replications") {
+                success = (getIntFromArg(argv[argIdx + 1], numReplications) &&
+                           numReplications > 0);
+            }
+            else if (optionName == "--replication-batch") {
+                success = (getIntFromArg(argv[argIdx + 1],
+                                         replicationBatchSize) &&
+                           replicationBatchSize > 0);
+            }
+            else if (optionName == "--compare") {
+                compareParamFname = string(argv[argIdx + 1]);
+            }
+            else if (optionName == "--antithetic") {
+                string switchName = string(argv[argIdx + 1]);
+                isAntitheticPairs = (switchName == "on");
+                success = (switchName == "on" || switchName == "off");
+            }
+            else if (optionName == "--sweep") {
+                sweepFname = string(argv[argIdx + 1]);
+            }
+            else if (optionName == "--csv") {
+                csvFname = string(argv[argIdx + 1]);
+            }
+            else if (optionName == "--threads") {
+                success = (getIntFromArg(argv[argIdx + 1], numThreads) &&
+                           numThreads > 0);
+            }
+            else {
+                success = false;
+            }
+        }
+        //Replications each have their own seed, so one binary trace
+        //wouldn't make sense for them
+        if (numReplications > 0 && binaryTraceFname.length() > 0) {
+            success = false;
+        }
+        //A sweep writes its results to a CSV file, and runs many setups,
+        //so it can't be combined with replications, a binary trace, delay
+        //percentiles or queue statistics (which the CSV file has no
+        //columns for)
+        if ((sweepFname.length() > 0) != (csvFname.length() > 0) ||
+            (sweepFname.length() > 0 &&
+             (numReplications > 0 || binaryTraceFname.length() > 0 ||
+              isDelayTrackingEnabled || isQueueStatsPrinted))) {
+            success = false;
+        }
+        //A network runs many intersections with the per-event engine, so
+        //it can't be combined with the other multi-run modes, a binary
+        //trace or the lazy arrival engine; its intersections are never
+        //fast-forwarded, as cars from their neighbours keep their state
+        //from repeating
+        if ((numNetworkRows > 0 &&
+             (numReplications > 0 || sweepFname.length() > 0 ||
+              binaryTraceFname.length() > 0 ||
+              engineMode == ENGINE_LAZY_ARRIVALS ||
+              isFastForwardEnabled)) ||
+            (travelTime > 0 && numNetworkRows == 0)) {
+            success = false;
+        }
+        //Synchronization only applies to a network, and the optimism
+        //window only to optimistic synchronization
+        if ((syncMode != NETWORK_SYNC_CONSERVATIVE && numNetworkRows == 0) ||
+            (optimismWindow > 0 && syncMode != NETWORK_SYNC_OPTIMISTIC)) {
+            success = false;
+        }
+        //Snapshots are of a single run, which is saved once it reaches the
+        //snapshot time; a binary trace of a restored run would be missing
+        //the events before the snapshot
+        if (((saveSnapshotFname.length() > 0 ||
+              restoreSnapshotFname.length() > 0) &&
+             (numReplications > 0 || sweepFname.length() > 0 ||
+              numNetworkRows > 0)) ||
+            (saveSnapshotFname.length() > 0) != (snapshotTime >= 0) ||
+            (restoreSnapshotFname.length() > 0 &&
+             binaryTraceFname.length() > 0)) {
+            success = false;
+        }
+        //Stopping at a target precision ends a single run early, and
+        //the steady-state estimates it needs come from stepping through
+        //every light cycle rather than fast-forwarding past them; with
+        //replications it stops adding replications instead, in batches
+        //of the given size
+        if ((targetPercent > 0 &&
+             (sweepFname.length() > 0 || numNetworkRows > 0 ||
+              (numReplications == 0 && isFastForwardEnabled))) ||
+            (replicationBatchSize > 0 &&
+             (numReplications == 0 || targetPercent == 0))) {
+            success = false;
+        }
+        //Comparing setups and antithetic pairs are ways of running
+        //replications; the stop rule of a target precision only covers
+        //one setup, not the differences between two, and antithetic
+        //draws need the Philox generator and come in pairs
+        if (((compareParamFname.length() > 0 || isAntitheticPairs) &&
+             numReplications == 0) ||
+            (compareParamFname.length() > 0 && targetPercent > 0) ||
+            (isAntitheticPairs &&
+             (randomMode != RANDOM_MODE_PHILOX || numReplications % 2 != 0))) {
+            success = false;
+        }
+        //The lazy arrival engine needs the Philox generator, and doesn't
+        //produce an event per arrival for a binary trace to record
+        if (engineMode == ENGINE_LAZY_ARRIVALS &&
+            (randomMode != RANDOM_MODE_PHILOX ||
+             binaryTraceFname.length() > 0)) {
+            success = false;
+        }
+    }
+    if (!success) {
+        cout << "Usage: " << argv[0] << " <parameterFile>" <<
+                " [--verbosity silent|stats|trace]" <<
+                " [--binary-trace <traceFile>]" <<
+                " [--rng compat|philox] [--fast-forward on|off]" <<
+                " [--delays on|off]" <<
+                " [--queue-stats on|off]" << endl;
+        cout << "          [--save-snapshot <snapshotFile>" <<
+                " --snapshot-time T]" <<
+                " [--restore-snapshot <snapshotFile>]" <<
+                " [--precision <percent>]" << endl;
+        cout << "   or: " << argv[0] << " <parameterFile>" <<
+                " --rng philox --engine event|lazy" <<
+                " [--fast-forward on|off]" <<
+                " [--verbosity silent|stats|trace] [--delays on|off]" <<
+                " [--queue-stats on|off] [--precision <percent>]" << endl;
+        cout << "   or: " << argv[0] << " <parameterFile>" <<
+                " --replications N [--threads N]" <<
+                " [--verbosity silent|stats|trace]" <<
+                " [--rng compat|philox] [--delays on|off]" <<
+                " [--queue-stats on|off]" << endl;
+        cout << "          [--precision <percent>" <<
+                " [--replication-batch N]]" <<
+                " [--compare <parameterFile>]" <<
+                " [--antithetic on|off]" << endl;
+        cout << "   or: " << argv[0] << " <parameterFile>" <<
+                " --sweep <sweepFile> --csv <csvFile> [--threads N]" <<
+                " [--verbosity silent|stats|trace]" <<
+                " [--rng compat|philox]" << endl;
+        cout << "   or: " << argv[0] << " <parameterFile>" <<
+                " --network <rows>x<columns> [--travel-time T]" <<
+                " [--sync conservative|optimistic]" <<
+                " [--optimism-window T] [--threads N]" <<
+                " [--verbosity silent|stats|trace]" <<
+                " [--rng compat|philox] [--delays on|off]" <<
+                " [--queue-stats on|off]" << endl;
     }
 
     if (success) {
+        simObj.setVerbosityLevel(verbosityLevel);
+        simObj.setRandomMode(randomMode);
+        simObj.setEngineMode(engineMode);
+        simObj.setIsFastForwardEnabled(isFastForwardEnabled);
+        simObj.setIsDelayTrackingEnabled(isDelayTrackingEnabled);
+        simObj.setIsQueueStatsPrinted(isQueueStatsPrinted);
+        //With replications the target decides how many to run, and each
+        //one runs to the end time
+        if (numReplications == 0) {
+            simObj.setTargetPrecision(targetPercent / 100);
+        }
+
         //Read input parameters and print to screen for reference..
-        cout << "Reading parameters from file: " << specifiedParamFname << endl;
+        if (verbosityLevel >= VERBOSITY_TRACE) {
+            cout << "Reading parameters from file: " << specifiedParamFname <<
+                    endl;
+        }
         simObj.readParametersFromFile(specifiedParamFname);
-        simObj.printParameters();
+        if (verbosityLevel >= VERBOSITY_TRACE) {
+            simObj.printParameters();
+        }
 
         if (!simObj.getIsSetupProperly()) {
             cout << "Cannot run simulation as it is not setup properly!" 
             << endl;
             success = false;
         }
+        else if (binaryTraceFname.length() > 0 &&
+                 !simObj.openBinaryTrace(binaryTraceFname)) {
+            cout << "Unable to create binary trace file: " <<
+                    binaryTraceFname << endl;
+            success = false;
+        }
     }
 
-    if (success) {
+    //The compared setup runs the same way, with the same seeds
+    if (success && compareParamFname.length() > 0) {
+        compareSimObj.setVerbosityLevel(verbosityLevel);
+        compareSimObj.setRandomMode(randomMode);
+        compareSimObj.setEngineMode(engineMode);
+        compareSimObj.setIsFastForwardEnabled(isFastForwardEnabled);
+        compareSimObj.setIsDelayTrackingEnabled(isDelayTrackingEnabled);
+        compareSimObj.setIsQueueStatsPrinted(isQueueStatsPrinted);
+        if (verbosityLevel >= VERBOSITY_TRACE) {
+            cout << "Reading compared parameters from file: " <<
+                    compareParamFname << endl;
+        }
+        compareSimObj.readParametersFromFile(compareParamFname);
+        if (verbosityLevel >= VERBOSITY_TRACE) {
+            compareSimObj.printParameters();
+        }
+
+        if (!compareSimObj.getIsSetupProperly()) {
+            cout << "Cannot run compared simulation as it is not setup " <<
+                    "properly!" << endl;
+            success = false;
+        }
+    }
+
+    if (success && numReplications > 0) {
+        runReplications(simObj, numReplications, numThreads,
+                        targetPercent / 100,
+                        (replicationBatchSize > 0) ?
+                        replicationBatchSize : REPLICATION_DEFAULT_BATCH_SIZE,
+                        (compareParamFname.length() > 0) ? &compareSimObj : 0,
+                        isAntitheticPairs, verbosityLevel);
+    }
+    else if (success && numNetworkRows > 0) {
+        runNetwork(simObj, numNetworkRows, numNetworkCols,
+                   (travelTime > 0) ? travelTime : NETWORK_DEFAULT_TRAVEL_TIME,
+                   syncMode,
+                   (optimismWindow > 0) ? optimismWindow :
+                                          NETWORK_DEFAULT_OPTIMISM_WINDOW,
+                   numThreads, verbosityLevel);
+    }
+    else if (success && sweepFname.length() > 0) {
+        success = runSweep(simObj, sweepFname, csvFname, numThreads,
+                           verbosityLevel);
+    }
+    else if (success) {
         //Schedule the initial events that will "seed" the event-driven 
-        //simulation
-        cout << endl;
-        cout << "Schedule simulation seed events" << endl;
-        simObj.scheduleSeedEvents();
+        //simulation, or pick up a run where a snapshot left it instead
+        if (restoreSnapshotFname.length() > 0) {
+            if (verbosityLevel >= VERBOSITY_TRACE) {
+                cout << endl;
+                cout << "Restore simulation from snapshot: " <<
+                        restoreSnapshotFname << endl;
+            }
+            success = simObj.restoreSnapshot(restoreSnapshotFname);
+        }
+        else {
+            if (verbosityLevel >= VERBOSITY_TRACE) {
+                cout << endl;
+                cout << "Schedule simulation seed events" << endl;
+            }
+            simObj.scheduleSeedEvents();
+        }
 
         //When the simulation recognizes it should stop handling events,
         //the call to "handleNextEvent" will return false.  This is
         //expected to occur when the next event's schedule time is 
         //after the end time of the simulation (an input parameter).
-        cout << endl;
-        cout << "Starting simulation!" << endl;
+        if (verbosityLevel >= VERBOSITY_TRACE) {
+            cout << endl;
+            cout << "Starting simulation!" << endl;
+        }
 
-        bool doKeepRunning = true;
+        bool doKeepRunning = success;
+        bool isSnapshotPending = (saveSnapshotFname.length() > 0);
         while (doKeepRunning) {
+            //Save the snapshot before the first event after the run
+            //reaches the snapshot time
+            if (isSnapshotPending && simObj.getCurrentTime() >= snapshotTime) {
+                isSnapshotPending = false;
+                success = simObj.saveSnapshot(saveSnapshotFname);
+                if (success && verbosityLevel >= VERBOSITY_TRACE) {
+                    cout << endl;
+                    cout << "Saved snapshot at time " <<
+                            simObj.getCurrentTime() << ": " <<
+                            saveSnapshotFname << endl;
+                }
+                //There's no point finishing a run whose snapshot is lost
+                doKeepRunning = success;
+            }
+
             //Handle the next scheduled event now..
-            doKeepRunning = simObj.handleNextEvent();
+            if (doKeepRunning) {
+                doKeepRunning = simObj.handleNextEvent();
+            }
+        }
+        //A trace that couldn't be written in full is missing records
+        if (!simObj.closeBinaryTrace()) {
+            cout << "ERROR: Unable to write binary trace file: " <<
+                    binaryTraceFname << endl;
+            success = false;
+        }
+        //The event after the end time has been used up by now, so the
+        //state at the end can't be resumed
+        if (isSnapshotPending) {
+            cout << "ERROR: Simulation ended before the snapshot time" << endl;
+            success = false;
         }
     }
 
     //Indicate whether things went well or not, and, if so, print out the
     //simualtion statistics that were computed during the run.
-    if (success) {
-        cout << "Simulation ran successfully!" << endl;
-        simObj.printStatistics();
+    if (success && (numReplications > 0 || sweepFname.length() > 0 ||
+                    numNetworkRows > 0)) {
+        //The replication summary, sweep results or network statistics
+        //have already been output
+    }
+    else if (success) {
+        if (verbosityLevel >= VERBOSITY_STATS) {
+            cout << "Simulation ran successfully!" << endl;
+            simObj.printStatistics();
+        }
     }
     else {
         cout << "Simulation did NOT run successfully..." << endl;
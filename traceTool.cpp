@@ -0,0 +1,276 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+using namespace std;
+
+#include "BinaryTraceReaderClass.h"
+#include "TraceWriterClass.h"
+#include "CarClass.h"
+#include "constants.h"
+
+//Purpose: Post-mortem analysis of a binary trace written by proj5.exe
+//         (see its --binary-trace option), without re-running the
+//         simulation.  Run as "traceTool.exe <command> <traceFile>
+//         [options]"; run with no arguments to see the commands.
+
+//Light state names, indexed by the LIGHT_* constants (which start at 1)
+static const string LIGHT_NAMES[] = {
+    "Unknown", "EW Green", "EW Yellow", "NS Green", "NS Yellow"
+};
+const int NUM_LIGHT_NAMES = 5;
+
+//Names the record kinds for the info command, indexed by TRACE_REC_*
+static const string RECORD_TYPE_NAMES[NUM_TRACE_REC_TYPES] = {
+    "schedule", "handle", "arrive", "advance on green",
+    "none waiting on yellow", "advance on yellow", "stop on yellow",
+    "green summary", "yellow summary", "end"
+};
+
+//Which part of the trace to look at, from the command line options
+struct TraceFilterStruct {
+    int fromTick;         //Earliest tick of interest
+    int toTick;           //Latest tick of interest
+    unsigned char dirCode;//Approach of interest, or DIR_CODE_NOT_SET for
+                          //all of them (and for the light)
+};
+
+//Reads the --from, --to and --dir options that follow the trace file
+//name. Returns false, after printing what was wrong, if an option isn't
+//recognized.
+static bool readFilterOptions(int argc, char *argv[],
+                              TraceFilterStruct &filter) {
+    filter.fromTick = 0;
+    filter.toTick = -1;
+    filter.dirCode = DIR_CODE_NOT_SET;
+
+    for (int argIdx = 3; argIdx < argc; argIdx += 2) {
+        string optionName = string(argv[argIdx]);
+        if (argIdx + 1 >= argc) {
+            cout << "Option " << optionName << " needs a value" << endl;
+            return false;
+        }
+        string optionValue = string(argv[argIdx + 1]);
+        if (optionName == "--from") {
+            filter.fromTick = atoi(optionValue.c_str());
+        }
+        else if (optionName == "--to") {
+            filter.toTick = atoi(optionValue.c_str());
+        }
+        else if (optionName == "--dir") {
+            string dirName = optionValue;
+            if (dirName.length() > 0) {
+                dirName[0] = (char)toupper(dirName[0]);
+            }
+            filter.dirCode = getDirectionCode(dirName);
+            if (filter.dirCode == DIR_CODE_NOT_SET) {
+                cout << "Unknown direction: " << optionValue << endl;
+                return false;
+            }
+        }
+        else {
+            cout << "Unknown option: " << optionName << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+//Returns true if the tick is inside the filter's range.
+static bool isTickInRange(const TraceFilterStruct &filter, const int tick) {
+    return tick >= filter.fromTick &&
+           (filter.toTick < 0 || tick <= filter.toTick);
+}
+
+//Prints a summary of the trace: how many records there are of each kind
+//and the span of time they cover.
+static void printTraceInfo(const BinaryTraceReaderClass &traceReader) {
+    long numOfType[NUM_TRACE_REC_TYPES] = { 0 };
+    long numRecords = traceReader.getNumRecords();
+
+    for (long recordIdx = 0; recordIdx < numRecords; recordIdx++) {
+        int recordType = traceReader.getRecord(recordIdx).recordType;
+        if (recordType < NUM_TRACE_REC_TYPES) {
+            numOfType[recordType]++;
+        }
+    }
+
+    cout << "Records: " << numRecords << endl;
+    if (numRecords > 0) {
+        cout << "Ticks: " << traceReader.getRecord(0).tick << " to " <<
+                traceReader.getRecord(numRecords - 1).tick << endl;
+    }
+    for (int recordType = 0; recordType < NUM_TRACE_REC_TYPES;
+         recordType++) {
+        cout << "  " << RECORD_TYPE_NAMES[recordType] << ": " <<
+                numOfType[recordType] << endl;
+    }
+}
+
+//Regenerates the text trace for the records that pass the filter.
+static void printTraceText(const BinaryTraceReaderClass &traceReader,
+                           const TraceFilterStruct &filter) {
+    TraceWriterClass traceWriter;
+    long numRecords = traceReader.getNumRecords();
+
+    for (long recordIdx = traceReader.findFirstRecordAtTick(filter.fromTick);
+         recordIdx < numRecords; recordIdx++) {
+        const TraceRecordStruct &record = traceReader.getRecord(recordIdx);
+        if (!isTickInRange(filter, record.tick)) {
+            break;
+        }
+        if (filter.dirCode == DIR_CODE_NOT_SET ||
+            record.dirCode == filter.dirCode) {
+            writeTraceRecordText(traceWriter, record);
+        }
+    }
+}
+
+//Writes one line of replay output: the state of the light and of the
+//queues once the event handled at the given tick was finished with.
+static void writeReplayState(TraceWriterClass &traceWriter, const int tick,
+                             const int lightState, const int queueLengths[]) {
+    int lightIdx = (lightState > 0 && lightState < NUM_LIGHT_NAMES) ?
+                   lightState : 0;
+
+    traceWriter << "Time: " << tick << " Light: " << LIGHT_NAMES[lightIdx] <<
+                   " Queues - East: " << queueLengths[DIR_CODE_EAST] <<
+                   " West: " << queueLengths[DIR_CODE_WEST] <<
+                   " North: " << queueLengths[DIR_CODE_NORTH] <<
+                   " South: " << queueLengths[DIR_CODE_SOUTH] << '\n';
+}
+
+//Replays the trace from the start, tracking the light and the length of
+//each queue, and prints the state after every handled event in the
+//filter's tick range.
+static void replayTrace(const BinaryTraceReaderClass &traceReader,
+                        const TraceFilterStruct &filter) {
+    TraceWriterClass traceWriter;
+    int queueLengths[NUM_DIRECTIONS] = { 0 };
+    int lightState = LIGHT_GREEN_EW;
+    int handledTick = 0;
+    bool isHandling = false;
+    long numRecords = traceReader.getNumRecords();
+
+    for (long recordIdx = 0; recordIdx < numRecords; recordIdx++) {
+        const TraceRecordStruct &record = traceReader.getRecord(recordIdx);
+
+        //A new event (or the end of the run) means the previous event is
+        //finished with
+        if (record.recordType == TRACE_REC_HANDLE ||
+            record.recordType == TRACE_REC_END) {
+            if (isHandling && isTickInRange(filter, handledTick)) {
+                writeReplayState(traceWriter, handledTick, lightState,
+                                 queueLengths);
+            }
+            isHandling = (record.recordType == TRACE_REC_HANDLE);
+            handledTick = record.tick;
+        }
+
+        lightState = record.lightState;
+        if (record.dirCode < NUM_DIRECTIONS &&
+            record.recordType != TRACE_REC_SCHEDULE &&
+            record.recordType != TRACE_REC_HANDLE &&
+            record.recordType != TRACE_REC_NO_CARS_YELLOW) {
+            queueLengths[record.dirCode] = record.queueLength;
+        }
+    }
+    if (isHandling && isTickInRange(filter, handledTick)) {
+        writeReplayState(traceWriter, handledTick, lightState, queueLengths);
+    }
+}
+
+//Recomputes the simulation's statistics from the records in the
+//filter's tick range, printed the same way the simulation prints them.
+static void printTraceStatistics(const BinaryTraceReaderClass &traceReader,
+                                 const TraceFilterStruct &filter) {
+    int maxQueueLengths[NUM_DIRECTIONS] = { 0 };
+    int numAdvanced[NUM_DIRECTIONS] = { 0 };
+    long numRecords = traceReader.getNumRecords();
+
+    for (long recordIdx = traceReader.findFirstRecordAtTick(filter.fromTick);
+         recordIdx < numRecords; recordIdx++) {
+        const TraceRecordStruct &record = traceReader.getRecord(recordIdx);
+        if (!isTickInRange(filter, record.tick)) {
+            break;
+        }
+        if (record.dirCode >= NUM_DIRECTIONS ||
+            (filter.dirCode != DIR_CODE_NOT_SET &&
+             record.dirCode != filter.dirCode)) {
+            continue;
+        }
+        if (record.recordType == TRACE_REC_ARRIVE &&
+            record.queueLength > maxQueueLengths[record.dirCode]) {
+            maxQueueLengths[record.dirCode] = record.queueLength;
+        }
+        else if (record.recordType == TRACE_REC_ADVANCE_GREEN ||
+                 record.recordType == TRACE_REC_ADVANCE_YELLOW) {
+            numAdvanced[record.dirCode]++;
+        }
+    }
+
+    cout << "===== Begin Simulation Statistics =====" << endl;
+    cout << "  Longest east-bound queue: " <<
+            maxQueueLengths[DIR_CODE_EAST] << endl;
+    cout << "  Longest west-bound queue: " <<
+            maxQueueLengths[DIR_CODE_WEST] << endl;
+    cout << "  Longest north-bound queue: " <<
+            maxQueueLengths[DIR_CODE_NORTH] << endl;
+    cout << "  Longest south-bound queue: " <<
+            maxQueueLengths[DIR_CODE_SOUTH] << endl;
+    cout << "  Total cars advanced east-bound: " <<
+            numAdvanced[DIR_CODE_EAST] << endl;
+    cout << "  Total cars advanced west-bound: " <<
+            numAdvanced[DIR_CODE_WEST] << endl;
+    cout << "  Total cars advanced north-bound: " <<
+            numAdvanced[DIR_CODE_NORTH] << endl;
+    cout << "  Total cars advanced south-bound: " <<
+            numAdvanced[DIR_CODE_SOUTH] << endl;
+    cout << "===== End Simulation Statistics =====" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    string commandName;
+    TraceFilterStruct filter;
+    BinaryTraceReaderClass traceReader;
+
+    if (argc >= 3) {
+        commandName = string(argv[1]);
+    }
+    if (commandName != "info" && commandName != "text" &&
+        commandName != "replay" && commandName != "stats") {
+        cout << "Usage: " << argv[0] << " <command> <traceFile> [options]" <<
+                endl;
+        cout << "  info      record counts and the ticks covered" << endl;
+        cout << "  text      regenerate the text trace" << endl;
+        cout << "  replay    light and queue lengths after each event" <<
+                endl;
+        cout << "  stats     recompute the simulation statistics" << endl;
+        cout << "Options (not used by info):" << endl;
+        cout << "  --from T  start at tick T" << endl;
+        cout << "  --to T    stop after tick T" << endl;
+        cout << "  --dir D   text and stats: only approach D (east, west," <<
+                " north or south)" << endl;
+        return 1;
+    }
+
+    if (!readFilterOptions(argc, argv, filter) ||
+        !traceReader.open(argv[2])) {
+        return 1;
+    }
+
+    if (commandName == "info") {
+        printTraceInfo(traceReader);
+    }
+    else if (commandName == "text") {
+        printTraceText(traceReader, filter);
+    }
+    else if (commandName == "replay") {
+        replayTrace(traceReader, filter);
+    }
+    else {
+        printTraceStatistics(traceReader, filter);
+    }
+
+    return 0;
+}